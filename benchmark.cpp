@@ -0,0 +1,627 @@
+// benchmark.cpp
+// Banc de mesure sans interface des moteurs (données, recherche, tri,
+// synthèse, formules, fichiers, journal) sur des jeux synthétiques reproductibles.
+// Les résultats sont écrits en JSON pour suivre les régressions d'une
+// version à l'autre. Le rendu passe par la plateforme "offscreen" quand
+// aucune n'est imposée, ce qui permet de l'exécuter sur une machine sans
+// affichage.
+#include "columnstore.h"
+#include "computedcolumns.h"
+#include "csvparser.h"
+#include "datatablemodel.h"
+#include "datfile.h"
+#include "dataview.h"
+#include "formula.h"
+#include "logengine.h"
+#include "logmodel.h"
+#include "parallel.h"
+#include "searchengine.h"
+#include "sortengine.h"
+#include "summaryengine.h"
+#include "viewexport.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScrollBar>
+#include <QSysInfo>
+#include <QTableView>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t Seed = 0x1a2b3c4d5e6f7788ull;
+// Taille des lots de chargement (comme FileLoader)
+constexpr size_t BatchRows = 65536;
+constexpr int ScrollFrames = 100;
+constexpr int LogProducers = 3;
+
+const char *const Words[] = {
+    "Alpha", "Bravo", "Charlie", "Delta", "Écho", "Fox", "Golf", "Hôtel",
+    "India", "Juliette", "Kilo", "Lima", "Mike", "Novembre", "Oscar", "Papa",
+    "Québec", "Roméo", "Sierra", "Tango", "Uniforme", "Victor", "Whisky", "Zoulou",
+};
+constexpr size_t WordCount = sizeof(Words) / sizeof(Words[0]);
+const char *const Types[] = {
+    "Type A", "Type B", "Type C", "Type D", "Type E", "Type F", "Type G", "Type H",
+    "Commande", "Facture", "Livraison", "Retour", "Avoir", "Devis", "Relance", "Contrat",
+};
+constexpr size_t TypeCount = sizeof(Types) / sizeof(Types[0]);
+const char *const Statuts[] = {"Actif", "Inactif", "En attente", "Archivé"};
+constexpr size_t StatutCount = sizeof(Statuts) / sizeof(Statuts[0]);
+
+uint64_t splitMix(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+// Lignes [first, first + count) du jeu synthétique: chaque ligne ne dépend
+// que de son numéro, les lots se raccordent donc au tableau complet.
+// Environ un Nom distinct pour quatre lignes.
+ColumnTable generateRows(size_t first, size_t count, size_t totalRows)
+{
+    const size_t nameCount = std::max<size_t>(totalRows / 4, 16);
+    const int32_t firstDay = daysFromCivil(2015, 1, 1);
+    ColumnStore store;
+    char nom[64];
+    for (size_t i = first; i < first + count; ++i) {
+        const uint64_t draw = splitMix(Seed + i);
+        const size_t name = size_t(draw % nameCount);
+        const int length = std::snprintf(nom, sizeof(nom), "%s %s %zu", Words[name % WordCount],
+                                         Words[(name / WordCount) % WordCount], name);
+        RowValues row;
+        row.id = int64_t(i) + 1;
+        row.nom = std::string_view(nom, size_t(length));
+        row.type = Types[(draw >> 24) % TypeCount];
+        row.date = firstDay + int32_t((draw >> 32) % 3650);
+        row.statut = Statuts[(draw >> 44) % StatutCount];
+        row.valeur = double((draw >> 40) % 10000000) / 100.0;
+        store.appendRow(row);
+    }
+    return store.table();
+}
+
+std::vector<ColumnTable> generateBatches(size_t rows)
+{
+    std::vector<ColumnTable> batches;
+    for (size_t first = 0; first < rows; first += BatchRows)
+        batches.push_back(generateRows(first, std::min(BatchRows, rows - first), rows));
+    return batches;
+}
+
+// Même contenu au format texte attendu par CsvParser, en-tête compris
+std::string generateCsv(const ColumnTable &table)
+{
+    std::string text("Id;Nom;Type;Date;Statut;Valeur\n");
+    text.reserve(table.rowCount() * 48);
+    char date[11] = {};
+    char number[64];
+    for (size_t row = 0; row < table.rowCount(); ++row) {
+        formatDate(table.dates[row], date);
+        text += std::to_string(table.ids[row]);
+        text += ';';
+        text += table.nom(row);
+        text += ';';
+        text += table.type(row);
+        text += ';';
+        text.append(date, 10);
+        text += ';';
+        text += table.statut(row);
+        text += ';';
+        const int length = std::snprintf(number, sizeof(number), "%.2f", table.valeurs[row]);
+        text.append(number, size_t(length));
+        text += '\n';
+    }
+    return text;
+}
+
+// Attend que la vue ait appliqué ses critères (calculs en arrière-plan)
+void waitForView(const DataView &view)
+{
+    while (view.isUpdating())
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+}
+
+// Nombre de lignes, "1k", "10M"...
+bool parseSize(QString text, size_t &size)
+{
+    size_t factor = 1;
+    if (text.endsWith('k', Qt::CaseInsensitive))
+        factor = 1000;
+    else if (text.endsWith('M'))
+        factor = 1000000;
+    if (factor > 1)
+        text.chop(1);
+    bool ok = false;
+    const qulonglong value = text.toULongLong(&ok);
+    size = size_t(value) * factor;
+    return ok && size > 0;
+}
+
+QString sizeLabel(size_t rows)
+{
+    if (rows >= 1000000 && rows % 1000000 == 0)
+        return QString("%1M").arg(rows / 1000000);
+    if (rows >= 1000 && rows % 1000 == 0)
+        return QString("%1k").arg(rows / 1000);
+    return QString::number(rows);
+}
+
+// Exécution et relevé des mesures. Chaque mesure est répétée; prepare,
+// appelé avant chaque passage, n'est pas chronométré.
+class Bench
+{
+public:
+    Bench(int repeat, QStringList groups)
+        : repeat(repeat)
+        , groups(std::move(groups))
+    {
+    }
+
+    bool wants(const QString &group) const { return groups.isEmpty() || groups.contains(group); }
+
+    void run(const QString &name, size_t rows, const std::function<void()> &body,
+             const std::function<void()> &prepare = {})
+    {
+        std::vector<double> samples;
+        for (int pass = 0; pass < repeat; ++pass) {
+            if (prepare)
+                prepare();
+            QElapsedTimer timer;
+            timer.start();
+            body();
+            samples.push_back(double(timer.nsecsElapsed()) / 1e6);
+        }
+        std::sort(samples.begin(), samples.end());
+        const double median = samples[samples.size() / 2];
+        double mean = 0;
+        for (double sample : samples)
+            mean += sample;
+        mean /= double(samples.size());
+
+        QJsonObject result;
+        result["name"] = name;
+        result["rows"] = qint64(rows);
+        result["repeat"] = repeat;
+        result["min_ms"] = samples.front();
+        result["median_ms"] = median;
+        result["mean_ms"] = mean;
+        result["max_ms"] = samples.back();
+        result["rows_per_s"] = median > 0 ? double(rows) / (median / 1000.0) : 0.0;
+        results.append(result);
+
+        std::printf("%-24s %8s  min %10.3f ms  médiane %10.3f ms  %12.0f lignes/s\n",
+                    name.toUtf8().constData(), sizeLabel(rows).toUtf8().constData(),
+                    samples.front(), median, result["rows_per_s"].toDouble());
+        std::fflush(stdout);
+    }
+
+    // Complète la dernière mesure (nombre de résultats, taille de fichier...)
+    void note(const QString &key, const QJsonValue &value)
+    {
+        QJsonObject last = results.last().toObject();
+        last[key] = value;
+        results.replace(results.size() - 1, last);
+    }
+
+    QJsonArray resultArray() const { return results; }
+
+private:
+    int repeat;
+    QStringList groups;
+    QJsonArray results;
+};
+
+void benchPopulate(Bench &bench, const std::vector<ColumnTable> &batches, size_t rows)
+{
+    // Comme un chargement: lots ajoutés au modèle, vue attachée
+    auto model = std::make_unique<DataTableModel>();
+    auto view = std::make_unique<DataView>(model.get());
+    bench.run("populate/append", rows, [&]() {
+        for (const ColumnTable &batch : batches)
+            model->appendTable(batch);
+        waitForView(*view);
+    }, [&]() {
+        view.reset();
+        model = std::make_unique<DataTableModel>();
+        view = std::make_unique<DataView>(model.get());
+    });
+}
+
+void benchRender(Bench &bench, DataView &view, size_t rows)
+{
+    QTableView table;
+    table.setModel(view.model());
+    table.verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table.verticalHeader()->setDefaultSectionSize(table.fontMetrics().height() + 6);
+    table.setWordWrap(false);
+    table.resize(1200, 800);
+    table.show();
+    QCoreApplication::processEvents();
+
+    // Défilement par pages réparties sur tout le tableau, une image repeinte par pas
+    QScrollBar *scrollBar = table.verticalScrollBar();
+    bench.run("render/scroll", rows, [&]() {
+        for (int frame = 0; frame < ScrollFrames; ++frame) {
+            scrollBar->setValue(int(qint64(scrollBar->maximum()) * frame / (ScrollFrames - 1)));
+            table.viewport()->repaint();
+        }
+    });
+    bench.note("frames", ScrollFrames);
+}
+
+void benchSearch(Bench &bench, const ColumnTable &table, const TrigramIndex &index)
+{
+    const std::atomic<bool> cancelled{false};
+    const struct
+    {
+        const char *name;
+        const char *query;
+    } queries[] = {
+        {"search/nom", "juliette kilo"},
+        {"search/accent", "écho"},
+        {"search/absent", "introuvable"},
+        {"search/date", "2019-07"},
+    };
+    for (const auto &query : queries) {
+        size_t matches = 0;
+        bench.run(query.name, table.rowCount(), [&]() {
+            matches = SearchEngine::search(table, &index, query.query, nullptr, cancelled,
+                                           [](std::vector<uint32_t> &&) {});
+        });
+        bench.note("matches", qint64(matches));
+    }
+}
+
+void benchFilter(Bench &bench, DataView &view, size_t rows)
+{
+    const struct
+    {
+        const char *name;
+        QString text;
+    } filters[] = {
+        {"filter/text", "bravo"},
+        {"filter/narrow", "sierra tango 1"},
+    };
+    for (const auto &filter : filters) {
+        bench.run(filter.name, rows, [&]() {
+            view.setTextFilter(filter.text);
+            view.applyNow();
+            waitForView(view);
+        }, [&]() {
+            view.setTextFilter(QString());
+            view.applyNow();
+            waitForView(view);
+        });
+        bench.note("visible", view.model()->rowCount());
+    }
+
+    view.setTextFilter(QString());
+    view.applyNow();
+    waitForView(view);
+    bench.run("filter/category", rows, [&]() {
+        view.setCategory("Facture");
+        waitForView(view);
+    }, [&]() {
+        view.setCategory(QString());
+        waitForView(view);
+    });
+    bench.note("visible", view.model()->rowCount());
+    view.setCategory(QString());
+    waitForView(view);
+
+    // Un mois de données: dates dispersées, chaque zone est à lire
+    const DateRange month{daysFromCivil(2020, 1, 1), daysFromCivil(2020, 1, 31)};
+    bench.run("filter/period", rows, [&]() {
+        view.setDateRange(month);
+        waitForView(view);
+    }, [&]() {
+        view.setDateRange(DateRange());
+        waitForView(view);
+    });
+    bench.note("visible", view.model()->rowCount());
+    view.setDateRange(DateRange());
+    waitForView(view);
+
+    // Mêmes dates rangées par ordre croissant: seules les zones du mois sont lues
+    const int32_t firstDay = daysFromCivil(2015, 1, 1);
+    std::vector<int32_t> sorted(rows);
+    for (size_t i = 0; i < rows; ++i)
+        sorted[i] = firstDay + int32_t(i * 3650 / rows);
+    BlockVector<int32_t> clustered;
+    clustered.append(sorted.data(), rows);
+    DateIndex index;
+    index.rebuild(clustered);
+    size_t selected = 0;
+    bench.run("filter/period-clustered", rows, [&]() { selected = index.select(clustered, month).size(); });
+    bench.note("visible", qint64(selected));
+}
+
+void benchSort(Bench &bench, const ColumnTable &table)
+{
+    const std::atomic<bool> cancelled{false};
+    const struct
+    {
+        const char *name;
+        SortKeys keys;
+    } sorts[] = {
+        {"sort/valeur", {{ColumnTable::Valeur, false}}},
+        {"sort/nom", {{ColumnTable::Nom, false}}},
+        {"sort/type-date", {{ColumnTable::Type, false}, {ColumnTable::Date, true}}},
+    };
+    for (const auto &sort : sorts) {
+        bench.run(sort.name, table.rowCount(), [&]() {
+            const std::vector<uint32_t> permutation = SortEngine::sort(table, sort.keys, cancelled);
+            Q_UNUSED(permutation);
+        });
+    }
+}
+
+void benchSummary(Bench &bench, const ColumnTable &table)
+{
+    const std::atomic<bool> cancelled{false};
+    bench.run("summary/all", table.rowCount(), [&]() {
+        const ValueSummary summary = SummaryEngine::summarize(table, nullptr, cancelled);
+        Q_UNUSED(summary);
+    });
+    bench.note("avx2", SummaryEngine::usesAvx2());
+
+    // Une ligne sur trois: lignes dispersées, regroupées par tranche
+    std::vector<uint32_t> rows;
+    for (size_t row = 0; row < table.rowCount(); row += 3)
+        rows.push_back(uint32_t(row));
+    bench.run("summary/subset", rows.size(), [&]() {
+        const ValueSummary summary = SummaryEngine::summarize(table, &rows, cancelled);
+        Q_UNUSED(summary);
+    });
+    bench.run("summary/percentiles", table.rowCount(), [&]() {
+        const std::vector<double> values = SummaryEngine::percentiles(table, nullptr, cancelled);
+        Q_UNUSED(values);
+    });
+}
+
+void benchFormula(Bench &bench, const ColumnTable &table)
+{
+    const struct
+    {
+        const char *name;
+        const char *text;
+    } formulas[] = {
+        {"formula/arithmetic", "Valeur * 1.2 - 3"},
+        {"formula/flags", "Statut = \"Actif\" et Valeur > 500"},
+        {"formula/dates", "debut_mois(Date)"},
+    };
+    constexpr size_t BlockSize = BlockVector<double>::BlockSize;
+    std::vector<double> out(table.rowCount());
+    for (const auto &entry : formulas) {
+        Formula formula;
+        formula.compile(entry.text, nullptr);
+        formula.bind(table);
+        // Toute la colonne, bloc par bloc, comme si tout était affiché
+        bench.run(entry.name, table.rowCount(), [&]() {
+            parallelFor(table.ids.blockCount(), 1, [&](size_t first, size_t last) {
+                for (size_t b = first; b < last; ++b) {
+                    const size_t begin = b * BlockSize;
+                    formula.evaluate(table, begin, begin + table.ids.blockLength(b), out.data() + begin);
+                }
+            });
+        });
+    }
+
+    // Premier affichage d'une colonne ajoutée: un seul bloc calculé
+    ComputedColumns columns;
+    Formula formula;
+    formula.compile("Valeur * 1.2 - 3", nullptr);
+    columns.add("Calcul", formula);
+    const size_t firstBlock = std::min(table.rowCount(), BlockSize);
+    bench.run("formula/visible-block", firstBlock, [&]() {
+        columns.value(table, 0, 0);
+    }, [&]() { columns.invalidateAll(); });
+    bench.note("memory_bytes", qint64(columns.memoryUsage()));
+}
+
+void benchFiles(Bench &bench, const ColumnTable &table)
+{
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        std::fprintf(stderr, "Répertoire temporaire indisponible: mesures des fichiers ignorées\n");
+        return;
+    }
+
+    const std::string csv = generateCsv(table);
+    bench.run("load/csv", table.rowCount(), [&]() {
+        const char *position = csv.data();
+        const char *end = position + csv.size();
+        CsvParser parser(CsvParser::detectDelimiter(std::string_view(csv.data(), std::min<size_t>(csv.size(), 4096))));
+        ColumnStore batch;
+        while (position < end) {
+            position = parser.parse(position, end, batch, BatchRows, true);
+            batch.clear();
+        }
+    });
+    bench.note("bytes", qint64(csv.size()));
+
+    const struct
+    {
+        const char *suffix;
+        DatFile::Compression compression;
+    } formats[] = {
+        {"dat", DatFile::NoCompression},
+        {"dat-zlib", DatFile::Zlib},
+    };
+    for (const auto &format : formats) {
+        const QString fileName = directory.filePath(QString("bench-%1.dat").arg(format.suffix));
+        bench.run(QString("save/%1").arg(format.suffix), table.rowCount(), [&]() {
+            DatFile::save(table, fileName, format.compression);
+        });
+        bench.note("bytes", QFileInfo(fileName).size());
+        bench.run(QString("load/%1").arg(format.suffix), table.rowCount(), [&]() {
+            ColumnTable loaded;
+            DatFile::load(fileName, loaded);
+        });
+    }
+
+    // Export d'une vue triée (permutation quelconque des lignes)
+    const std::atomic<bool> cancelled{false};
+    const std::vector<uint32_t> order = SortEngine::sort(table, {{ColumnTable::Valeur, false}}, cancelled);
+    const QString csvName = directory.filePath("bench-export.csv");
+    bench.run("export/csv", table.rowCount(), [&]() {
+        ViewExport::writeCsv(table, &order, csvName);
+    });
+    bench.note("bytes", QFileInfo(csvName).size());
+    const QString datName = directory.filePath("bench-export.dat");
+    bench.run("export/dat", table.rowCount(), [&]() {
+        ViewExport::writeDat(table, &order, datName, DatFile::NoCompression);
+    });
+    bench.note("bytes", QFileInfo(datName).size());
+}
+
+void benchLog(Bench &bench, size_t messages)
+{
+    // Producteurs concurrents, consommateur qui vide la file par lots comme
+    // LogModel et range les enregistrements dans l'anneau
+    LogEngine &engine = LogEngine::instance();
+    uint64_t dropped = 0;
+    bench.run("log/ingest", messages, [&]() {
+        const uint64_t droppedBefore = engine.droppedCount();
+        std::vector<std::thread> producers;
+        for (int producer = 0; producer < LogProducers; ++producer) {
+            producers.emplace_back([&engine, producer, messages]() {
+                for (size_t i = size_t(producer); i < messages; i += LogProducers)
+                    engine.post(LogLevel(i % LogLevelCount), "Message de mesure " + std::to_string(i));
+            });
+        }
+        LogBuffer buffer(LogModel::DefaultCapacity);
+        std::vector<LogRecord> batch;
+        size_t received = 0;
+        while (received + (engine.droppedCount() - droppedBefore) < messages) {
+            batch.clear();
+            received += engine.drain(batch, LogModel::MaxPerFrame);
+            for (LogRecord &record : batch)
+                buffer.append(std::move(record));
+            if (batch.empty())
+                std::this_thread::yield();
+        }
+        for (std::thread &producer : producers)
+            producer.join();
+        dropped = engine.droppedCount() - droppedBefore;
+    });
+    bench.note("dropped", qint64(dropped));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Sans affichage: rendu hors écran, sauf plateforme imposée
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    app.setApplicationName("INTERFACEQT_BENCH");
+    app.setApplicationVersion("2.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Banc de mesure des moteurs de données, de recherche et du journal");
+    parser.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "Tailles des jeux de données (ex. 1k,100k,10M).", "liste", "1k,100k,1M");
+    QCommandLineOption repeatOption("repeat", "Passages par mesure.", "n", "5");
+    QCommandLineOption onlyOption("only",
+        "Groupes à mesurer: populate, render, search, filter, sort, summary, formula, files, log.", "liste");
+    QCommandLineOption outputOption("output", "Fichier de résultats JSON.", "fichier", "benchmark.json");
+    parser.addOptions({sizesOption, repeatOption, onlyOption, outputOption});
+    parser.process(app);
+
+    std::vector<size_t> sizes;
+    for (const QString &text : parser.value(sizesOption).split(',', Qt::SkipEmptyParts)) {
+        size_t size = 0;
+        if (!parseSize(text.trimmed(), size)) {
+            std::fprintf(stderr, "Taille invalide: %s\n", text.toUtf8().constData());
+            return 1;
+        }
+        sizes.push_back(size);
+    }
+    const int repeat = std::max(1, parser.value(repeatOption).toInt());
+    Bench bench(repeat, parser.value(onlyOption).split(',', Qt::SkipEmptyParts));
+
+    for (size_t rows : sizes) {
+        std::printf("--- %s lignes ---\n", sizeLabel(rows).toUtf8().constData());
+        const std::vector<ColumnTable> batches = generateBatches(rows);
+        const ColumnTable table = generateRows(0, rows, rows);
+
+        if (bench.wants("populate"))
+            benchPopulate(bench, batches, rows);
+
+        if (bench.wants("render") || bench.wants("filter")) {
+            DataTableModel model;
+            DataView view(&model);
+            model.setTable(table);
+            waitForView(view);
+            if (bench.wants("filter")) {
+                auto index = std::make_shared<TrigramIndex>();
+                index->build(model.store().table().nomValues);
+                view.setNomIndex(index);
+                benchFilter(bench, view, rows);
+            }
+            if (bench.wants("render"))
+                benchRender(bench, view, rows);
+        }
+
+        if (bench.wants("search")) {
+            TrigramIndex index;
+            bench.run("search/index", table.nomValues.size(), [&]() { index.build(table.nomValues); });
+            benchSearch(bench, table, index);
+        }
+        if (bench.wants("sort"))
+            benchSort(bench, table);
+        if (bench.wants("summary"))
+            benchSummary(bench, table);
+        if (bench.wants("formula") && table.rowCount() > 0)
+            benchFormula(bench, table);
+        if (bench.wants("files"))
+            benchFiles(bench, table);
+        if (bench.wants("log"))
+            benchLog(bench, rows);
+    }
+
+    QJsonObject machine;
+    machine["os"] = QSysInfo::prettyProductName();
+    machine["cpu"] = QSysInfo::currentCpuArchitecture();
+    machine["threads"] = int(std::thread::hardware_concurrency());
+    machine["qt"] = QString(qVersion());
+    QJsonObject report;
+    report["version"] = app.applicationVersion();
+    report["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["repeat"] = repeat;
+    report["machine"] = machine;
+    report["results"] = bench.resultArray();
+
+    const QString outputName = parser.value(outputOption);
+    QFile output(outputName);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || output.write(QJsonDocument(report).toJson()) < 0) {
+        std::fprintf(stderr, "Écriture impossible de %s: %s\n", outputName.toUtf8().constData(),
+                     output.errorString().toUtf8().constData());
+        return 1;
+    }
+    std::printf("Résultats: %s\n", outputName.toUtf8().constData());
+    return 0;
+}
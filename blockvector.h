@@ -0,0 +1,334 @@
+// blockvector.h
+#ifndef BLOCKVECTOR_H
+#define BLOCKVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Tableau typé découpé en blocs contigus de taille fixe.
+// - l'ajout ne réalloue jamais les blocs déjà pleins (pas de copie de 10M valeurs);
+// - la copie est légère: les blocs sont partagés et copiés à l'écriture,
+//   ce qui permet aux threads de travail de lire un instantané pendant que
+//   le thread graphique continue d'ajouter ou de modifier des lignes.
+// Invariant: tous les blocs sont pleins sauf le dernier.
+template <typename T>
+class BlockVector
+{
+public:
+    static constexpr size_t BlockShift = 16;
+    static constexpr size_t BlockSize = size_t(1) << BlockShift;
+    static constexpr size_t BlockMask = BlockSize - 1;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const T &operator[](size_t i) const
+    {
+        return blocks[i >> BlockShift]->view[i & BlockMask];
+    }
+
+    size_t blockCount() const { return blocks.size(); }
+    const T *blockData(size_t b) const { return blocks[b]->view; }
+    size_t blockLength(size_t b) const
+    {
+        return b + 1 < blocks.size() ? BlockSize : count - (b << BlockShift);
+    }
+    // Propriétaire d'un bloc emprunté (passé à adoptBlock), nul si le bloc est alloué
+    const void *blockOwner(size_t b) const { return blocks[b]->owned ? nullptr : blocks[b]->backing.get(); }
+
+    void append(const T &value)
+    {
+        T *slot = appendSlot();
+        *slot = value;
+    }
+
+    void append(const T *values, size_t n)
+    {
+        while (n > 0) {
+            size_t room = BlockSize - (count & BlockMask);
+            size_t take = n < room ? n : room;
+            T *dst = reserveTail(take);
+            std::memcpy(dst, values, take * sizeof(T));
+            count += take;
+            values += take;
+            n -= take;
+        }
+    }
+
+    // Reprend tel quel un bloc stocké ailleurs (fichier projeté...), sans
+    // copie; tous les blocs précédents doivent être pleins. backing
+    // maintient la mémoire en vie tant qu'un instantané référence le bloc.
+    void adoptBlock(const T *values, size_t n, std::shared_ptr<const void> backing)
+    {
+        auto block = std::make_shared<Block>();
+        block->view = values;
+        block->capacity = n;
+        block->backing = std::move(backing);
+        blocks.push_back(std::move(block));
+        count += n;
+    }
+
+    void set(size_t i, const T &value)
+    {
+        size_t b = i >> BlockShift;
+        detach(b, blocks[b]->capacity);
+        blocks[b]->owned[i & BlockMask] = value;
+    }
+
+    // Retire les positions de rows (triées, sans doublon). Les blocs qui
+    // précèdent la première ligne retirée sont repris tels quels (partagés,
+    // empruntés à un fichier projeté...); les valeurs suivantes sont
+    // recopiées par plages dans de nouveaux blocs: les instantanés en cours
+    // gardent les anciens.
+    void removeSorted(const std::vector<uint32_t> &rows)
+    {
+        if (rows.empty())
+            return;
+        BlockVector<T> result = leadingBlocks(size_t(rows.front()) >> BlockShift);
+        size_t begin = result.count;
+        for (uint32_t row : rows) {
+            result.appendRange(*this, begin, row);
+            begin = size_t(row) + 1;
+        }
+        result.appendRange(*this, begin, count);
+        *this = std::move(result);
+    }
+
+    // Insère values[k] pour qu'il se retrouve à la position positions[k]
+    // (positions finales, triées)
+    void insertSorted(const std::vector<uint32_t> &positions, const std::vector<T> &values)
+    {
+        if (positions.empty())
+            return;
+        // Avant la première insertion, positions finales et d'origine coïncident
+        BlockVector<T> result = leadingBlocks(size_t(positions.front()) >> BlockShift);
+        size_t source = result.count;
+        for (size_t k = 0; k < positions.size(); ++k) {
+            const size_t end = size_t(positions[k]) - k;
+            result.appendRange(*this, source, end);
+            source = end;
+            result.append(values[k]);
+        }
+        result.appendRange(*this, source, count);
+        *this = std::move(result);
+    }
+
+    // Ajoute les valeurs [begin, end) d'un autre tableau
+    void appendRange(const BlockVector<T> &other, size_t begin, size_t end)
+    {
+        while (begin < end) {
+            const size_t b = begin >> BlockShift;
+            const size_t take = std::min(end, (b + 1) << BlockShift) - begin;
+            append(other.blockData(b) + (begin & BlockMask), take);
+            begin += take;
+        }
+    }
+
+    void truncate(size_t n)
+    {
+        if (n >= count)
+            return;
+        blocks.resize((n + BlockMask) >> BlockShift);
+        count = n;
+    }
+
+    void clear()
+    {
+        blocks.clear();
+        count = 0;
+    }
+
+    // Mémoire détenue en propre (hors blocs empruntés à un fichier projeté)
+    size_t memoryUsage() const
+    {
+        size_t bytes = blocks.capacity() * sizeof(void *);
+        for (const auto &block : blocks) {
+            if (block->owned)
+                bytes += block->capacity * sizeof(T);
+        }
+        return bytes;
+    }
+
+private:
+    struct Block
+    {
+        const T *view = nullptr;
+        std::unique_ptr<T[]> owned;
+        size_t capacity = 0;
+        std::shared_ptr<const void> backing;
+    };
+
+    std::vector<std::shared_ptr<Block>> blocks;
+    size_t count = 0;
+
+    // Les n premiers blocs, partagés; seuls les blocs pleins sont repris
+    BlockVector<T> leadingBlocks(size_t n) const
+    {
+        BlockVector<T> head;
+        n = std::min(n, size_t(count >> BlockShift));
+        head.blocks.assign(blocks.begin(), blocks.begin() + std::ptrdiff_t(n));
+        head.count = n << BlockShift;
+        return head;
+    }
+
+    static std::shared_ptr<Block> makeBlock(size_t capacity)
+    {
+        auto block = std::make_shared<Block>();
+        block->owned.reset(new T[capacity]);
+        block->view = block->owned.get();
+        block->capacity = capacity;
+        return block;
+    }
+
+    // Rend le bloc b modifiable (copie s'il est partagé ou emprunté)
+    void detach(size_t b, size_t minCapacity)
+    {
+        std::shared_ptr<Block> &block = blocks[b];
+        if (block->owned && block.use_count() == 1 && block->capacity >= minCapacity)
+            return;
+        size_t length = blockLength(b);
+        size_t capacity = minCapacity > length ? minCapacity : length;
+        std::shared_ptr<Block> copy = makeBlock(capacity);
+        std::memcpy(copy->owned.get(), block->view, length * sizeof(T));
+        block = std::move(copy);
+    }
+
+    // Garantit de la place pour n valeurs dans le bloc courant et renvoie
+    // l'emplacement d'écriture; n ne doit pas dépasser la place restante.
+    T *reserveTail(size_t n)
+    {
+        size_t offset = count & BlockMask;
+        if (offset == 0) {
+            // Premier bloc: croissance géométrique pour les petits jeux de données
+            size_t capacity = blocks.empty() ? (n > 256 ? n : 256) : BlockSize;
+            if (capacity > BlockSize)
+                capacity = BlockSize;
+            blocks.push_back(makeBlock(capacity));
+            return blocks.back()->owned.get();
+        }
+        size_t b = blocks.size() - 1;
+        size_t needed = offset + n;
+        size_t capacity = blocks[b]->capacity;
+        if (needed > capacity) {
+            capacity = capacity * 2 > needed ? capacity * 2 : needed;
+            if (capacity > BlockSize)
+                capacity = BlockSize;
+        }
+        detach(b, capacity);
+        return blocks[b]->owned.get() + offset;
+    }
+
+    T *appendSlot()
+    {
+        T *slot = reserveTail(1);
+        ++count;
+        return slot;
+    }
+};
+
+// Colonne de chaînes UTF-8 segmentée, avec le même partage copie-à-l'écriture
+// que BlockVector. Sert de stockage aux valeurs des dictionnaires.
+// Un segment contient SegmentSize chaînes: les fins de chaîne (relatives au
+// segment) puis les octets; il peut être emprunté à un fichier projeté.
+class StringColumn
+{
+public:
+    static constexpr size_t SegmentShift = 12;
+    static constexpr size_t SegmentSize = size_t(1) << SegmentShift;
+    static constexpr size_t SegmentMask = SegmentSize - 1;
+
+    size_t size() const { return count; }
+
+    std::string_view operator[](size_t i) const
+    {
+        const Segment &segment = *segments[i >> SegmentShift];
+        size_t k = i & SegmentMask;
+        uint32_t begin = k ? segment.endView[k - 1] : 0;
+        return std::string_view(segment.byteView + begin, segment.endView[k] - begin);
+    }
+
+    void append(std::string_view value)
+    {
+        if ((count & SegmentMask) == 0)
+            segments.push_back(std::make_shared<Segment>());
+        std::shared_ptr<Segment> &segment = segments.back();
+        if (segment.use_count() > 1 || segment->backing)
+            segment = segment->ownedCopy();
+        segment->bytes.insert(segment->bytes.end(), value.begin(), value.end());
+        segment->ends.push_back(uint32_t(segment->bytes.size()));
+        segment->syncViews();
+        ++count;
+    }
+
+    size_t segmentCount() const { return segments.size(); }
+    size_t segmentLength(size_t s) const { return segments[s]->length; }
+    const uint32_t *segmentEnds(size_t s) const { return segments[s]->endView; }
+    const char *segmentBytes(size_t s) const { return segments[s]->byteView; }
+    // Propriétaire d'un segment emprunté (passé à adoptSegment), nul sinon
+    const void *segmentOwner(size_t s) const { return segments[s]->backing.get(); }
+
+    // Reprend tel quel un segment stocké ailleurs (tous les segments
+    // précédents doivent être pleins); backing maintient la mémoire en vie.
+    void adoptSegment(const uint32_t *ends, const char *bytes, size_t length,
+                      std::shared_ptr<const void> backing)
+    {
+        auto segment = std::make_shared<Segment>();
+        segment->endView = ends;
+        segment->byteView = bytes;
+        segment->length = length;
+        segment->backing = std::move(backing);
+        segments.push_back(std::move(segment));
+        count += length;
+    }
+
+    void clear()
+    {
+        segments.clear();
+        count = 0;
+    }
+
+    size_t memoryUsage() const
+    {
+        size_t bytes = segments.capacity() * sizeof(void *);
+        for (const auto &segment : segments)
+            bytes += sizeof(Segment) + segment->bytes.capacity() + segment->ends.capacity() * sizeof(uint32_t);
+        return bytes;
+    }
+
+private:
+    struct Segment
+    {
+        std::vector<char> bytes;
+        std::vector<uint32_t> ends;
+        const char *byteView = nullptr;
+        const uint32_t *endView = nullptr;
+        size_t length = 0;
+        std::shared_ptr<const void> backing;
+
+        void syncViews()
+        {
+            byteView = bytes.data();
+            endView = ends.data();
+            length = ends.size();
+        }
+
+        std::shared_ptr<Segment> ownedCopy() const
+        {
+            auto copy = std::make_shared<Segment>();
+            copy->ends.assign(endView, endView + length);
+            copy->bytes.assign(byteView, byteView + (length ? endView[length - 1] : 0));
+            copy->syncViews();
+            return copy;
+        }
+    };
+
+    std::vector<std::shared_ptr<Segment>> segments;
+    size_t count = 0;
+};
+
+#endif // BLOCKVECTOR_H
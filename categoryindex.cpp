@@ -0,0 +1,140 @@
+// categoryindex.cpp
+#include "categoryindex.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+constexpr size_t RowsPerSlice = 65536;
+
+} // namespace
+
+void CategoryIndex::rebuild(const ColumnTable &table)
+{
+    clear();
+    const size_t rows = table.rowCount();
+    const size_t codeCount = table.typeValues.size();
+    const size_t sliceCount = (rows + RowsPerSlice - 1) / RowsPerSlice;
+
+    // Chaque tranche de lignes produit ses propres ensembles, un par code
+    // rencontré; ils sont ensuite raccordés dans l'ordre des tranches
+    std::vector<std::vector<std::pair<uint32_t, RowBitmap>>> perSlice(sliceCount);
+    parallelFor(sliceCount, 1, [&](size_t first, size_t last) {
+        std::vector<int32_t> slotOf(codeCount, -1);
+        for (size_t slice = first; slice < last; ++slice) {
+            auto &bitmaps = perSlice[slice];
+            const size_t end = std::min((slice + 1) * RowsPerSlice, rows);
+            for (size_t row = slice * RowsPerSlice; row < end; ++row) {
+                const uint32_t code = table.types[row];
+                int32_t &slot = slotOf[code];
+                if (slot < 0) {
+                    slot = int32_t(bitmaps.size());
+                    bitmaps.emplace_back(code, RowBitmap());
+                }
+                bitmaps[size_t(slot)].second.add(uint32_t(row));
+            }
+            for (const auto &entry : bitmaps)
+                slotOf[entry.first] = -1;
+        }
+    });
+
+    byCode.resize(codeCount);
+    rowLists.resize(codeCount);
+    for (auto &bitmaps : perSlice) {
+        for (auto &entry : bitmaps)
+            byCode[entry.first].appendBitmap(std::move(entry.second));
+    }
+}
+
+void CategoryIndex::appendRows(const ColumnTable &table, size_t first, size_t last)
+{
+    for (size_t row = first; row < last; ++row) {
+        const uint32_t code = table.types[row];
+        bitmapFor(code).add(uint32_t(row));
+        invalidate(code);
+    }
+}
+
+void CategoryIndex::removeRows(const std::vector<uint32_t> &rows)
+{
+    if (rows.empty())
+        return;
+    // Chaque ensemble ne reconstruit que ses tranches d'après rows.front()
+    parallelFor(byCode.size(), 1, [&](size_t first, size_t last) {
+        for (size_t code = first; code < last; ++code)
+            byCode[code].removeRows(rows);
+    });
+    std::fill(rowLists.begin(), rowLists.end(), RowList());
+}
+
+void CategoryIndex::insertRows(const ColumnTable &table, const std::vector<uint32_t> &rows)
+{
+    if (rows.empty())
+        return;
+    parallelFor(byCode.size(), 1, [&](size_t first, size_t last) {
+        for (size_t code = first; code < last; ++code)
+            byCode[code].insertRows(rows);
+    });
+    std::fill(rowLists.begin(), rowLists.end(), RowList());
+    for (uint32_t row : rows)
+        bitmapFor(table.types[row]).add(row);
+}
+
+void CategoryIndex::updateRow(uint32_t row, uint32_t oldCode, uint32_t newCode)
+{
+    if (oldCode == newCode)
+        return;
+    if (oldCode < byCode.size()) {
+        byCode[oldCode].remove(row);
+        invalidate(oldCode);
+    }
+    bitmapFor(newCode).add(row);
+    invalidate(newCode);
+}
+
+void CategoryIndex::clear()
+{
+    byCode.clear();
+    rowLists.clear();
+}
+
+const RowBitmap &CategoryIndex::bitmap(uint32_t code) const
+{
+    static const RowBitmap empty;
+    return code < byCode.size() ? byCode[code] : empty;
+}
+
+CategoryIndex::RowList CategoryIndex::rows(uint32_t code) const
+{
+    if (code >= byCode.size())
+        return std::make_shared<std::vector<uint32_t>>();
+    RowList &list = rowLists[code];
+    if (!list)
+        list = std::make_shared<std::vector<uint32_t>>(byCode[code].toVector());
+    return list;
+}
+
+size_t CategoryIndex::memoryUsage() const
+{
+    size_t bytes = 0;
+    for (const RowBitmap &bitmap : byCode)
+        bytes += bitmap.memoryUsage();
+    return bytes;
+}
+
+RowBitmap &CategoryIndex::bitmapFor(uint32_t code)
+{
+    if (code >= byCode.size()) {
+        byCode.resize(code + 1);
+        rowLists.resize(code + 1);
+    }
+    return byCode[code];
+}
+
+void CategoryIndex::invalidate(uint32_t code)
+{
+    if (code < rowLists.size() && rowLists[code])
+        rowLists[code].reset();
+}
@@ -0,0 +1,45 @@
+// categoryindex.h
+#ifndef CATEGORYINDEX_H
+#define CATEGORYINDEX_H
+
+#include "columnstore.h"
+#include "rowbitmap.h"
+
+#include <memory>
+#include <vector>
+
+// Partition des lignes par valeur de la colonne Type: un RowBitmap par code
+// du dictionnaire, tenu à jour au fil des ajouts, modifications,
+// suppressions et insertions. La liste des lignes d'une catégorie est matérialisée à la
+// première demande puis partagée tant que la catégorie ne change pas.
+class CategoryIndex
+{
+public:
+    using RowList = std::shared_ptr<const std::vector<uint32_t>>;
+
+    // Reconstruction complète, en parallèle par tranches de lignes
+    void rebuild(const ColumnTable &table);
+    // Lignes [first, last) ajoutées en fin de tableau
+    void appendRows(const ColumnTable &table, size_t first, size_t last);
+    // Lignes supprimées (triées): les suivantes sont renumérotées
+    void removeRows(const std::vector<uint32_t> &rows);
+    // Lignes insérées au milieu du tableau, à leurs positions finales (triées)
+    void insertRows(const ColumnTable &table, const std::vector<uint32_t> &rows);
+    void updateRow(uint32_t row, uint32_t oldCode, uint32_t newCode);
+    void clear();
+
+    // Ensemble vide pour un code inconnu
+    const RowBitmap &bitmap(uint32_t code) const;
+    RowList rows(uint32_t code) const;
+
+    size_t memoryUsage() const;
+
+private:
+    std::vector<RowBitmap> byCode;
+    mutable std::vector<RowList> rowLists;
+
+    RowBitmap &bitmapFor(uint32_t code);
+    void invalidate(uint32_t code);
+};
+
+#endif // CATEGORYINDEX_H
@@ -0,0 +1,475 @@
+// columnstore.cpp
+#include "columnstore.h"
+#include "parallel.h"
+
+namespace {
+
+uint32_t hashString(std::string_view value)
+{
+    // FNV-1a 32 bits
+    uint32_t h = 2166136261u;
+    for (unsigned char c : value) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+template <typename T>
+void appendColumn(BlockVector<T> &target, const BlockVector<T> &source)
+{
+    for (size_t b = 0; b < source.blockCount(); ++b)
+        target.append(source.blockData(b), source.blockLength(b));
+}
+
+void appendCodes(BlockVector<uint32_t> &target, const BlockVector<uint32_t> &source,
+                 const std::vector<uint32_t> &codeMap)
+{
+    std::vector<uint32_t> buffer;
+    for (size_t b = 0; b < source.blockCount(); ++b) {
+        const uint32_t *codes = source.blockData(b);
+        const size_t length = source.blockLength(b);
+        buffer.resize(length);
+        for (size_t i = 0; i < length; ++i)
+            buffer[i] = codeMap[codes[i]];
+        target.append(buffer.data(), length);
+    }
+}
+
+std::vector<uint32_t> internAll(StringIndex &index, StringColumn &values, const StringColumn &source)
+{
+    std::vector<uint32_t> codeMap(source.size());
+    for (size_t code = 0; code < source.size(); ++code)
+        codeMap[code] = index.intern(values, source[code]);
+    return codeMap;
+}
+
+// Copie locale du dictionnaire commun, reprise quand il a grandi
+void syncShared(const StringPool::Dictionary &shared, StringColumn &local)
+{
+    if (local.size() != shared.values.size())
+        local = shared.values;
+}
+
+} // namespace
+
+int32_t daysFromCivil(int year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = unsigned(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + int32_t(doe) - 719468;
+}
+
+void civilFromDays(int32_t days, int &year, unsigned &month, unsigned &day)
+{
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = unsigned(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = int(yoe) + era * 400 + (month <= 2);
+}
+
+void formatDate(int32_t days, char *out)
+{
+    int year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    unsigned y = unsigned(year < 0 ? 0 : year % 10000);
+    out[0] = char('0' + y / 1000);
+    out[1] = char('0' + y / 100 % 10);
+    out[2] = char('0' + y / 10 % 10);
+    out[3] = char('0' + y % 10);
+    out[4] = '-';
+    out[5] = char('0' + month / 10);
+    out[6] = char('0' + month % 10);
+    out[7] = '-';
+    out[8] = char('0' + day / 10);
+    out[9] = char('0' + day % 10);
+}
+
+uint32_t StringIndex::intern(StringColumn &values, std::string_view value)
+{
+    if (used != values.size() || (used + 1) * 4 > slots.size() * 3)
+        rehash(values, slots.empty() ? 64 : slots.size() * 2);
+
+    const uint32_t h = hashString(value);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        Slot &slot = slots[i];
+        if (slot.code == 0) {
+            uint32_t code = uint32_t(values.size());
+            values.append(value);
+            slot.hash = h;
+            slot.code = code + 1;
+            ++used;
+            return code;
+        }
+        if (slot.hash == h && values[slot.code - 1] == value)
+            return slot.code - 1;
+    }
+}
+
+int64_t StringIndex::find(const StringColumn &values, std::string_view value) const
+{
+    if (used != values.size()) {
+        // Index pas encore construit (colonne chargée telle quelle): recherche linéaire
+        for (size_t code = 0; code < values.size(); ++code) {
+            if (values[code] == value)
+                return int64_t(code);
+        }
+        return -1;
+    }
+    if (slots.empty())
+        return -1;
+    const uint32_t h = hashString(value);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const Slot &slot = slots[i];
+        if (slot.code == 0)
+            return -1;
+        if (slot.hash == h && values[slot.code - 1] == value)
+            return int64_t(slot.code - 1);
+    }
+}
+
+void StringIndex::clear()
+{
+    slots.clear();
+    used = 0;
+}
+
+void StringIndex::rehash(const StringColumn &values, size_t capacity)
+{
+    while ((values.size() + 1) * 4 > capacity * 3)
+        capacity *= 2;
+    std::vector<Slot> previous(capacity, Slot{0, 0});
+    previous.swap(slots);
+    const size_t mask = capacity - 1;
+    auto insert = [&](uint32_t h, uint32_t code) {
+        size_t i = h & mask;
+        while (slots[i].code != 0)
+            i = (i + 1) & mask;
+        slots[i] = Slot{h, code + 1};
+    };
+
+    if (used == values.size()) {
+        // Simple agrandissement: les empreintes déjà calculées sont réutilisées
+        for (const Slot &slot : previous) {
+            if (slot.code != 0)
+                insert(slot.hash, slot.code - 1);
+        }
+    } else {
+        for (size_t code = 0; code < values.size(); ++code)
+            insert(hashString(values[code]), uint32_t(code));
+    }
+    used = values.size();
+}
+
+StringPool &StringPool::instance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+size_t StringPool::memoryUsage() const
+{
+    return types.values.memoryUsage() + types.index.memoryUsage()
+        + statuts.values.memoryUsage() + statuts.index.memoryUsage();
+}
+
+void ColumnStore::setStringPool(StringPool *pool)
+{
+    sharedPool = pool;
+    pooled = pool != nullptr;
+    if (!pooled)
+        return;
+    syncShared(pool->types, data.typeValues);
+    syncShared(pool->statuts, data.statutValues);
+}
+
+uint32_t ColumnStore::internType(std::string_view value)
+{
+    if (!pooled)
+        return typeIndex.intern(data.typeValues, value);
+    const uint32_t code = sharedPool->types.index.intern(sharedPool->types.values, value);
+    syncShared(sharedPool->types, data.typeValues);
+    return code;
+}
+
+uint32_t ColumnStore::internStatut(std::string_view value)
+{
+    if (!pooled)
+        return statutIndex.intern(data.statutValues, value);
+    const uint32_t code = sharedPool->statuts.index.intern(sharedPool->statuts.values, value);
+    syncShared(sharedPool->statuts, data.statutValues);
+    return code;
+}
+
+int64_t ColumnStore::findType(std::string_view value) const
+{
+    if (!pooled)
+        return typeIndex.find(data.typeValues, value);
+    // Une valeur ajoutée par un autre document n'existe pas encore ici
+    const int64_t code = sharedPool->types.index.find(sharedPool->types.values, value);
+    return code < int64_t(data.typeValues.size()) ? code : -1;
+}
+
+std::vector<uint32_t> ColumnStore::internTypes(const StringColumn &source)
+{
+    if (!pooled)
+        return internAll(typeIndex, data.typeValues, source);
+    std::vector<uint32_t> codeMap = internAll(sharedPool->types.index, sharedPool->types.values, source);
+    syncShared(sharedPool->types, data.typeValues);
+    return codeMap;
+}
+
+std::vector<uint32_t> ColumnStore::internStatuts(const StringColumn &source)
+{
+    if (!pooled)
+        return internAll(statutIndex, data.statutValues, source);
+    std::vector<uint32_t> codeMap = internAll(sharedPool->statuts.index, sharedPool->statuts.values, source);
+    syncShared(sharedPool->statuts, data.statutValues);
+    return codeMap;
+}
+
+void ColumnStore::appendRow(const RowValues &row)
+{
+    data.ids.append(row.id);
+    data.noms.append(internNom(row.nom));
+    data.types.append(internType(row.type));
+    data.dates.append(row.date);
+    data.statuts.append(internStatut(row.statut));
+    data.valeurs.append(row.valeur);
+    ++modificationCount;
+}
+
+void ColumnStore::appendTable(const ColumnTable &other)
+{
+    appendColumn(data.ids, other.ids);
+    appendCodes(data.noms, other.noms, internAll(nomIndex, data.nomValues, other.nomValues));
+    appendCodes(data.types, other.types, internTypes(other.typeValues));
+    appendColumn(data.dates, other.dates);
+    appendCodes(data.statuts, other.statuts, internStatuts(other.statutValues));
+    appendColumn(data.valeurs, other.valeurs);
+    ++modificationCount;
+}
+
+void ColumnStore::appendRows(const ColumnRows &values)
+{
+    if (values.ids.empty())
+        return;
+    const size_t count = values.ids.size();
+    data.ids.append(values.ids.data(), count);
+    data.noms.append(values.noms.data(), count);
+    data.types.append(values.types.data(), count);
+    data.dates.append(values.dates.data(), count);
+    data.statuts.append(values.statuts.data(), count);
+    data.valeurs.append(values.valeurs.data(), count);
+    ++modificationCount;
+}
+
+size_t ColumnRows::memoryUsage() const
+{
+    return rows.capacity() * sizeof(uint32_t) + ids.capacity() * sizeof(int64_t)
+        + (noms.capacity() + types.capacity() + statuts.capacity()) * sizeof(uint32_t)
+        + dates.capacity() * sizeof(int32_t) + valeurs.capacity() * sizeof(double);
+}
+
+ColumnRows ColumnStore::extractRows(const std::vector<uint32_t> &rows, int column) const
+{
+    ColumnRows values;
+    values.rows = rows;
+    auto gather = [&rows](const auto &source, auto &target) {
+        target.resize(rows.size());
+        parallelFor(rows.size(), 65536, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+                target[i] = source[rows[i]];
+        });
+    };
+    if (column < 0 || column == ColumnTable::Id)
+        gather(data.ids, values.ids);
+    if (column < 0 || column == ColumnTable::Nom)
+        gather(data.noms, values.noms);
+    if (column < 0 || column == ColumnTable::Type)
+        gather(data.types, values.types);
+    if (column < 0 || column == ColumnTable::Date)
+        gather(data.dates, values.dates);
+    if (column < 0 || column == ColumnTable::Statut)
+        gather(data.statuts, values.statuts);
+    if (column < 0 || column == ColumnTable::Valeur)
+        gather(data.valeurs, values.valeurs);
+    return values;
+}
+
+void ColumnStore::removeRows(const std::vector<uint32_t> &rows)
+{
+    if (rows.empty())
+        return;
+    // Une colonne par tâche: chacune est recopiée par plages à partir du
+    // bloc de la première ligne retirée, les blocs précédents restent partagés
+    parallelFor(ColumnTable::ColumnCount, 1, [&](size_t first, size_t last) {
+        for (size_t column = first; column < last; ++column) {
+            switch (column) {
+            case ColumnTable::Id: data.ids.removeSorted(rows); break;
+            case ColumnTable::Nom: data.noms.removeSorted(rows); break;
+            case ColumnTable::Type: data.types.removeSorted(rows); break;
+            case ColumnTable::Date: data.dates.removeSorted(rows); break;
+            case ColumnTable::Statut: data.statuts.removeSorted(rows); break;
+            default: data.valeurs.removeSorted(rows); break;
+            }
+        }
+    });
+    ++modificationCount;
+}
+
+void ColumnStore::insertRows(const ColumnRows &values)
+{
+    if (values.rows.empty())
+        return;
+    parallelFor(ColumnTable::ColumnCount, 1, [&](size_t first, size_t last) {
+        for (size_t column = first; column < last; ++column) {
+            switch (column) {
+            case ColumnTable::Id: data.ids.insertSorted(values.rows, values.ids); break;
+            case ColumnTable::Nom: data.noms.insertSorted(values.rows, values.noms); break;
+            case ColumnTable::Type: data.types.insertSorted(values.rows, values.types); break;
+            case ColumnTable::Date: data.dates.insertSorted(values.rows, values.dates); break;
+            case ColumnTable::Statut: data.statuts.insertSorted(values.rows, values.statuts); break;
+            default: data.valeurs.insertSorted(values.rows, values.valeurs); break;
+            }
+        }
+    });
+    ++modificationCount;
+}
+
+void ColumnStore::assignColumn(const ColumnRows &values, int column)
+{
+    auto scatter = [&values](auto &target, const auto &source) {
+        for (size_t i = 0; i < values.rows.size(); ++i)
+            target.set(values.rows[i], source[i]);
+    };
+    switch (column) {
+    case ColumnTable::Id: scatter(data.ids, values.ids); break;
+    case ColumnTable::Nom: scatter(data.noms, values.noms); break;
+    case ColumnTable::Type: scatter(data.types, values.types); break;
+    case ColumnTable::Date: scatter(data.dates, values.dates); break;
+    case ColumnTable::Statut: scatter(data.statuts, values.statuts); break;
+    case ColumnTable::Valeur: scatter(data.valeurs, values.valeurs); break;
+    default: return;
+    }
+    ++modificationCount;
+}
+
+ColumnRows ColumnStore::encodeRows(const ColumnTable &other)
+{
+    ColumnRows values;
+    const size_t count = other.rowCount();
+    const std::vector<uint32_t> nomCodes = internAll(nomIndex, data.nomValues, other.nomValues);
+    const std::vector<uint32_t> typeCodes = internTypes(other.typeValues);
+    const std::vector<uint32_t> statutCodes = internStatuts(other.statutValues);
+    for (size_t row = 0; row < count; ++row) {
+        values.ids.push_back(other.ids[row]);
+        values.noms.push_back(nomCodes[other.noms[row]]);
+        values.types.push_back(typeCodes[other.types[row]]);
+        values.dates.push_back(other.dates[row]);
+        values.statuts.push_back(statutCodes[other.statuts[row]]);
+        values.valeurs.push_back(other.valeurs[row]);
+    }
+    return values;
+}
+
+void ColumnStore::assign(const ColumnTable &table)
+{
+    clear();
+    data = table;
+    pooled = false;
+}
+
+void ColumnStore::adoptStorage(const ColumnTable &copy)
+{
+    data.ids = copy.ids;
+    data.noms = copy.noms;
+    data.types = copy.types;
+    data.dates = copy.dates;
+    data.statuts = copy.statuts;
+    data.valeurs = copy.valeurs;
+    // Les index de hachage sont reconstruits au prochain ajout de valeur
+    data.nomValues = copy.nomValues;
+    nomIndex.clear();
+    if (!pooled) {
+        data.typeValues = copy.typeValues;
+        data.statutValues = copy.statutValues;
+        typeIndex.clear();
+        statutIndex.clear();
+    }
+}
+
+size_t ColumnStore::compactNoms()
+{
+    const BlockVector<uint32_t> &noms = data.noms;
+    const size_t valueCount = data.nomValues.size();
+    std::vector<uint32_t> remap(valueCount, 0);
+    for (size_t b = 0; b < noms.blockCount(); ++b) {
+        const uint32_t *codes = noms.blockData(b);
+        for (size_t i = 0, n = noms.blockLength(b); i < n; ++i)
+            remap[codes[i]] = 1;
+    }
+    StringColumn kept;
+    uint32_t next = 0;
+    for (size_t code = 0; code < valueCount; ++code) {
+        if (!remap[code])
+            continue;
+        remap[code] = next++;
+        kept.append(data.nomValues[code]);
+    }
+    const size_t removed = valueCount - next;
+    if (removed == 0)
+        return 0;
+
+    // Blocs recodés à part: un instantané garde les anciens
+    std::vector<std::vector<uint32_t>> recoded(noms.blockCount());
+    parallelFor(recoded.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            const uint32_t *codes = noms.blockData(b);
+            recoded[b].resize(noms.blockLength(b));
+            for (size_t i = 0; i < recoded[b].size(); ++i)
+                recoded[b][i] = remap[codes[i]];
+        }
+    });
+    BlockVector<uint32_t> compacted;
+    for (const std::vector<uint32_t> &block : recoded)
+        compacted.append(block.data(), block.size());
+    data.noms = std::move(compacted);
+    data.nomValues = std::move(kept);
+    nomIndex.clear();
+    ++modificationCount;
+    return removed;
+}
+
+void ColumnStore::clear()
+{
+    data.clear();
+    nomIndex.clear();
+    typeIndex.clear();
+    statutIndex.clear();
+    setStringPool(sharedPool);
+    ++modificationCount;
+}
+
+size_t ColumnStore::memoryUsage() const
+{
+    size_t bytes = data.ids.memoryUsage() + data.noms.memoryUsage() + data.types.memoryUsage()
+        + data.dates.memoryUsage() + data.statuts.memoryUsage() + data.valeurs.memoryUsage()
+        + data.nomValues.memoryUsage() + nomIndex.memoryUsage();
+    if (!pooled) {
+        bytes += data.typeValues.memoryUsage() + data.statutValues.memoryUsage()
+            + typeIndex.memoryUsage() + statutIndex.memoryUsage();
+    }
+    return bytes;
+}
@@ -0,0 +1,195 @@
+// columnstore.h
+#ifndef COLUMNSTORE_H
+#define COLUMNSTORE_H
+
+#include "blockvector.h"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Conversion date civile <-> nombre de jours depuis le 1970-01-01
+int32_t daysFromCivil(int year, unsigned month, unsigned day);
+void civilFromDays(int32_t days, int &year, unsigned &month, unsigned &day);
+// Écrit "AAAA-MM-JJ" (10 caractères, sans zéro terminal)
+void formatDate(int32_t days, char *out);
+
+// Données colonnaires d'un tableau. La copie partage les blocs, elle sert
+// d'instantané en lecture seule pour les traitements en arrière-plan.
+struct ColumnTable
+{
+    enum Column { Id, Nom, Type, Date, Statut, Valeur, ColumnCount };
+
+    BlockVector<int64_t> ids;
+    BlockVector<uint32_t> noms;      // codes dans nomValues
+    BlockVector<uint32_t> types;     // codes dans typeValues
+    BlockVector<int32_t> dates;      // jours depuis 1970-01-01
+    BlockVector<uint32_t> statuts;   // codes dans statutValues
+    BlockVector<double> valeurs;
+
+    StringColumn nomValues;
+    StringColumn typeValues;
+    StringColumn statutValues;
+
+    size_t rowCount() const { return ids.size(); }
+
+    void clear() { *this = ColumnTable(); }
+
+    std::string_view nom(size_t row) const { return nomValues[noms[row]]; }
+    std::string_view type(size_t row) const { return typeValues[types[row]]; }
+    std::string_view statut(size_t row) const { return statutValues[statuts[row]]; }
+};
+
+using ColumnTablePtr = std::shared_ptr<const ColumnTable>;
+
+// Index de hachage valeur -> code au-dessus d'une StringColumn
+class StringIndex
+{
+public:
+    uint32_t intern(StringColumn &values, std::string_view value);
+    int64_t find(const StringColumn &values, std::string_view value) const;
+    void clear();
+    size_t memoryUsage() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t code;   // code + 1, 0 = libre
+    };
+
+    std::vector<Slot> slots;
+    size_t used = 0;
+
+    void rehash(const StringColumn &values, size_t capacity);
+};
+
+// Dictionnaires communs à tout le processus pour les colonnes dont les
+// valeurs se répètent d'un jeu de données à l'autre (Type, Statut): chaque
+// valeur n'est stockée qu'une fois et garde le même code dans tous les
+// documents ouverts. Thread graphique seulement. Un magasin qui s'en sert
+// garde une copie des valeurs (segments partagés), reprise après chaque
+// ajout: ses instantanés ne voient jamais le dictionnaire commun grandir.
+class StringPool
+{
+public:
+    struct Dictionary
+    {
+        StringColumn values;
+        StringIndex index;
+    };
+
+    static StringPool &instance();
+
+    Dictionary types;
+    Dictionary statuts;
+
+    size_t memoryUsage() const;
+};
+
+// Une ligne sous forme décodée, pour l'ajout unitaire
+struct RowValues
+{
+    int64_t id = 0;
+    std::string_view nom;
+    std::string_view type;
+    int32_t date = 0;
+    std::string_view statut;
+    double valeur = 0.0;
+};
+
+// Lignes extraites du tableau, colonne par colonne, avec leur position.
+// Les codes Nom/Type/Statut renvoient aux dictionnaires du magasin, qui ne
+// font que grandir (sauf compactNoms, qui vide l'historique): c'est tout ce
+// qu'il faut garder pour annuler une suppression ou une modification. Une
+// modification ne remplit que la colonne concernée.
+struct ColumnRows
+{
+    std::vector<uint32_t> rows;      // positions croissantes
+    std::vector<int64_t> ids;
+    std::vector<uint32_t> noms;
+    std::vector<uint32_t> types;
+    std::vector<int32_t> dates;
+    std::vector<uint32_t> statuts;
+    std::vector<double> valeurs;
+
+    size_t size() const { return rows.size(); }
+    size_t memoryUsage() const;
+};
+
+// Stockage colonnaire du tableau de données: colonnes typées contiguës par
+// blocs, Nom/Type/Statut encodés par dictionnaire.
+class ColumnStore
+{
+public:
+    const ColumnTable &table() const { return data; }
+    size_t rowCount() const { return data.rowCount(); }
+
+    // Incrémenté à chaque modification (invalidation des caches et résultats)
+    uint64_t version() const { return modificationCount; }
+
+    ColumnTablePtr snapshot() const
+    {
+        return std::make_shared<ColumnTable>(data);
+    }
+
+    void appendRow(const RowValues &row);
+    // Ajoute les lignes d'un autre tableau (codes de dictionnaire réassignés)
+    void appendTable(const ColumnTable &other);
+    // Ajoute à la fin des lignes déjà codées dans ces dictionnaires (rows ignoré)
+    void appendRows(const ColumnRows &values);
+
+    uint32_t internNom(std::string_view value) { return nomIndex.intern(data.nomValues, value); }
+    uint32_t internType(std::string_view value);
+    uint32_t internStatut(std::string_view value);
+    // Code d'une valeur de Type existante, -1 si absente
+    int64_t findType(std::string_view value) const;
+
+    // Type et Statut codés dans le dictionnaire commun pool (nul: dictionnaires
+    // propres). À choisir sur un magasin vide; repris après clear().
+    void setStringPool(StringPool *pool);
+    bool usesStringPool() const { return pooled; }
+
+    // Valeurs des lignes rows (triées), toutes les colonnes ou une seule
+    ColumnRows extractRows(const std::vector<uint32_t> &rows, int column = -1) const;
+    // Retire les lignes rows (triées, sans doublon)
+    void removeRows(const std::vector<uint32_t> &rows);
+    // Insère les lignes aux positions finales values.rows
+    void insertRows(const ColumnRows &values);
+    // Écrit la colonne column des lignes values.rows
+    void assignColumn(const ColumnRows &values, int column);
+    // Codes des lignes d'un autre tableau dans ces dictionnaires (positions à remplir)
+    ColumnRows encodeRows(const ColumnTable &other);
+
+    // Remplace tout le contenu; les index des dictionnaires seront
+    // reconstruits au premier besoin. Le tableau garde ses propres
+    // dictionnaires (recoder Type et Statut dans le dictionnaire commun
+    // ferait perdre les blocs projetés sans copie d'un fichier .dat).
+    void assign(const ColumnTable &table);
+    // Reprend les blocs d'une copie au contenu identique (relue depuis un
+    // fichier projeté): seule la mémoire qui porte les données change, ni
+    // les valeurs ni la version, donc aucun cache n'est invalidé
+    void adoptStorage(const ColumnTable &copy);
+    // Retire du dictionnaire Nom les valeurs qu'aucune ligne n'utilise plus;
+    // les autres gardent leur ordre mais changent de code. Renvoie le nombre
+    // de valeurs retirées (0: rien n'a changé, pas de nouvelle version).
+    size_t compactNoms();
+    void clear();
+    // Mémoire allouée (hors blocs projetés et dictionnaire commun)
+    size_t memoryUsage() const;
+
+private:
+    ColumnTable data;
+    StringIndex nomIndex;
+    StringIndex typeIndex;
+    StringIndex statutIndex;
+    StringPool *sharedPool = nullptr;
+    bool pooled = false;
+    uint64_t modificationCount = 0;
+
+    std::vector<uint32_t> internTypes(const StringColumn &source);
+    std::vector<uint32_t> internStatuts(const StringColumn &source);
+};
+
+#endif // COLUMNSTORE_H
@@ -0,0 +1,126 @@
+// computedcolumns.cpp
+#include "computedcolumns.h"
+#include "parallel.h"
+#include "profiler.h"
+
+#include <algorithm>
+
+void ComputedColumns::add(const std::string &name, Formula formula)
+{
+    Column column;
+    column.name = name;
+    column.formula = std::move(formula);
+    columns.push_back(std::move(column));
+}
+
+void ComputedColumns::remove(size_t index)
+{
+    columns.erase(columns.begin() + std::ptrdiff_t(index));
+}
+
+bool ComputedColumns::dependsOn(int column) const
+{
+    return std::any_of(columns.begin(), columns.end(), [column](const Column &computed) {
+        return computed.formula.dependsOn(column);
+    });
+}
+
+double ComputedColumns::value(const ColumnTable &table, size_t index, size_t row)
+{
+    Column &column = columns[index];
+    const size_t block = row >> BlockShift;
+    if (column.blocks.size() <= block)
+        column.blocks.resize(table.ids.blockCount());
+    Block &entry = column.blocks[block];
+    // Bloc jamais lu, invalidé, ou dernier bloc qui a grandi depuis
+    if ((row & BlockVector<double>::BlockMask) >= entry.values.size())
+        compute(table, column, block);
+    entry.lastUse = ++useCount;
+    return entry.values[row & BlockVector<double>::BlockMask];
+}
+
+void ComputedColumns::compute(const ColumnTable &table, Column &column, size_t block)
+{
+    const size_t begin = block << BlockShift;
+    const size_t length = table.ids.blockLength(block);
+    PROFILE_SCOPE_AS(scope, "Colonne calculée: bloc");
+    scope.addItems(length);
+
+    // Place pour ce bloc: le moins récemment lu est oublié
+    if (column.blocks[block].values.empty() && column.cached >= MaxCachedBlocks) {
+        size_t oldest = column.blocks.size();
+        for (size_t b = 0; b < column.blocks.size(); ++b) {
+            if (!column.blocks[b].values.empty()
+                && (oldest == column.blocks.size() || column.blocks[b].lastUse < column.blocks[oldest].lastUse))
+                oldest = b;
+        }
+        drop(column, oldest);
+    }
+
+    column.formula.bind(table);
+    std::vector<double> values(length);
+    const Formula &formula = column.formula;
+    const size_t tiles = (length + Formula::TileSize - 1) / Formula::TileSize;
+    parallelFor(tiles, 4, [&](size_t first, size_t last) {
+        const size_t from = begin + first * Formula::TileSize;
+        const size_t to = std::min(begin + length, begin + last * Formula::TileSize);
+        formula.evaluate(table, from, to, values.data() + (from - begin));
+    });
+    if (column.blocks[block].values.empty())
+        ++column.cached;
+    column.blocks[block].values = std::move(values);
+}
+
+void ComputedColumns::drop(Column &column, size_t block)
+{
+    if (block >= column.blocks.size() || column.blocks[block].values.empty())
+        return;
+    std::vector<double>().swap(column.blocks[block].values);
+    --column.cached;
+}
+
+void ComputedColumns::invalidateFrom(size_t row)
+{
+    for (Column &column : columns) {
+        for (size_t b = row >> BlockShift; b < column.blocks.size(); ++b)
+            drop(column, b);
+    }
+}
+
+void ComputedColumns::invalidateRows(const std::vector<uint32_t> &rows, int column)
+{
+    for (Column &computed : columns) {
+        const bool affected = column >= 0 ? computed.formula.dependsOn(column)
+                                          : (computed.formula.dependencies() & ~(1u << ColumnTable::Id)) != 0;
+        if (!affected)
+            continue;
+        for (uint32_t row : rows)
+            drop(computed, row >> BlockShift);
+    }
+}
+
+void ComputedColumns::invalidateAll()
+{
+    for (Column &column : columns) {
+        column.blocks.clear();
+        column.cached = 0;
+        column.formula.unbind();
+    }
+}
+
+void ComputedColumns::rebindAll()
+{
+    for (Column &column : columns)
+        column.formula.unbind();
+}
+
+size_t ComputedColumns::memoryUsage() const
+{
+    size_t bytes = 0;
+    for (const Column &column : columns) {
+        bytes += column.blocks.capacity() * sizeof(Block);
+        for (const Block &block : column.blocks)
+            bytes += block.values.capacity() * sizeof(double);
+    }
+    return bytes;
+}
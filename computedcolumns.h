@@ -0,0 +1,71 @@
+// computedcolumns.h
+#ifndef COMPUTEDCOLUMNS_H
+#define COMPUTEDCOLUMNS_H
+
+#include "formula.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Colonnes calculées d'un tableau. Rien n'est calculé à l'ajout: les valeurs
+// d'un bloc (BlockVector::BlockSize lignes) le sont à la première lecture
+// d'une de ses lignes, puis gardées jusqu'à ce qu'une colonne lue par la
+// formule change dans ce bloc. Seuls les blocs affichés existent donc en
+// mémoire, au plus MaxCachedBlocks par colonne (les moins récemment lus
+// sont oubliés au-delà). Thread graphique seulement.
+class ComputedColumns
+{
+public:
+    static constexpr size_t BlockShift = BlockVector<double>::BlockShift;
+    static constexpr size_t MaxCachedBlocks = 64;
+
+    size_t size() const { return columns.size(); }
+
+    // formula déjà compilée
+    void add(const std::string &name, Formula formula);
+    void remove(size_t index);
+
+    const std::string &name(size_t index) const { return columns[index].name; }
+    const Formula &formula(size_t index) const { return columns[index].formula; }
+    // Une des formules lit cette colonne de ColumnTable
+    bool dependsOn(int column) const;
+
+    // Valeur d'une ligne; calcule son bloc s'il n'est pas en cache
+    double value(const ColumnTable &table, size_t index, size_t row);
+
+    // Lignes à partir de row ajoutées, retirées ou décalées
+    void invalidateFrom(size_t row);
+    // Valeurs de column modifiées (-1: toutes les colonnes sauf Id)
+    void invalidateRows(const std::vector<uint32_t> &rows, int column);
+    // Autre tableau: dictionnaires compris
+    void invalidateAll();
+    // Mêmes valeurs, codes de dictionnaire renumérotés: seules les formules
+    // sont à relier, les valeurs en cache restent justes
+    void rebindAll();
+
+    size_t memoryUsage() const;
+
+private:
+    struct Block
+    {
+        std::vector<double> values;   // vide: à calculer
+        uint64_t lastUse = 0;
+    };
+
+    struct Column
+    {
+        std::string name;
+        Formula formula;
+        std::vector<Block> blocks;
+        size_t cached = 0;
+    };
+
+    std::vector<Column> columns;
+    uint64_t useCount = 0;
+
+    void compute(const ColumnTable &table, Column &column, size_t block);
+    static void drop(Column &column, size_t block);
+};
+
+#endif // COMPUTEDCOLUMNS_H
@@ -0,0 +1,288 @@
+// csvparser.cpp
+#include "csvparser.h"
+
+#include <charconv>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSVPARSER_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline int countTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Masque des octets de [p, p + 16) égaux au séparateur, à '\n' ou à '"'
+inline uint32_t matchMask16(const char *p, char delimiter)
+{
+#ifdef CSVPARSER_SSE2
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i hits = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(delimiter)),
+                     _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+    return uint32_t(_mm_movemask_epi8(hits));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < 16; ++i) {
+        if (p[i] == delimiter || p[i] == '\n' || p[i] == '"')
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+inline uint32_t matchMaskTail(const char *p, size_t length, char delimiter)
+{
+    uint32_t mask = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (p[i] == delimiter || p[i] == '\n' || p[i] == '"')
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+inline std::string_view makeField(const char *begin, const char *end)
+{
+    if (end > begin && end[-1] == '\r')
+        --end;
+    return std::string_view(begin, size_t(end - begin));
+}
+
+inline bool parseDigits(const char *p, int count, unsigned &value)
+{
+    value = 0;
+    for (int i = 0; i < count; ++i) {
+        unsigned digit = unsigned(p[i] - '0');
+        if (digit > 9)
+            return false;
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+std::string_view trimmed(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+        text.remove_suffix(1);
+    return text;
+}
+
+} // namespace
+
+bool parseDateField(std::string_view text, int32_t &days)
+{
+    text = trimmed(text);
+    if (text.size() < 10)
+        return false;
+    const char *p = text.data();
+    unsigned year, month, day;
+    if (p[4] == '-' && p[7] == '-') {
+        // AAAA-MM-JJ (éventuellement suivi d'une heure)
+        if (!parseDigits(p, 4, year) || !parseDigits(p + 5, 2, month) || !parseDigits(p + 8, 2, day))
+            return false;
+    } else if (p[2] == '/' && p[5] == '/') {
+        // JJ/MM/AAAA
+        if (!parseDigits(p, 2, day) || !parseDigits(p + 3, 2, month) || !parseDigits(p + 6, 4, year))
+            return false;
+    } else {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+    days = daysFromCivil(int(year), month, day);
+    return true;
+}
+
+bool parseDoubleField(std::string_view text, double &value)
+{
+    text = trimmed(text);
+    if (text.empty())
+        return false;
+    const char *end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    if (result.ec == std::errc() && result.ptr == end)
+        return true;
+
+    // Virgule décimale (fichiers ';' à la française)
+    char buffer[64];
+    if (text.size() >= sizeof(buffer))
+        return false;
+    for (size_t i = 0; i < text.size(); ++i)
+        buffer[i] = text[i] == ',' ? '.' : text[i];
+    result = std::from_chars(buffer, buffer + text.size(), value);
+    return result.ec == std::errc() && result.ptr == buffer + text.size();
+}
+
+char CsvParser::detectDelimiter(std::string_view firstLine)
+{
+    size_t semicolons = 0, commas = 0, tabs = 0;
+    for (char c : firstLine) {
+        if (c == '\n')
+            break;
+        semicolons += c == ';';
+        commas += c == ',';
+        tabs += c == '\t';
+    }
+    if (tabs > semicolons && tabs > commas)
+        return '\t';
+    if (commas > semicolons)
+        return ',';
+    return ';';
+}
+
+const char *CsvParser::parse(const char *begin, const char *end, ColumnStore &out,
+                             size_t maxRows, bool atEnd)
+{
+    std::string_view fields[FieldCount];
+    const char *lineStart = begin;
+    const char *fieldStart = begin;
+    int field = 0;
+    size_t lines = 0;
+
+    const size_t length = size_t(end - begin);
+    size_t offset = 0;
+    while (offset < length) {
+        const char *block = begin + offset;
+        uint32_t mask = length - offset >= 16 ? matchMask16(block, delimiter)
+                                              : matchMaskTail(block, length - offset, delimiter);
+        size_t next = offset + 16;
+        while (mask) {
+            const char *pos = block + countTrailingZeros(mask);
+            mask &= mask - 1;
+            if (*pos == delimiter) {
+                if (field < FieldCount)
+                    fields[field] = std::string_view(fieldStart, size_t(pos - fieldStart));
+                ++field;
+                fieldStart = pos + 1;
+            } else if (*pos == '\n') {
+                if (field < FieldCount)
+                    fields[field] = makeField(fieldStart, pos);
+                ++field;
+                if (field > 1 || !fields[0].empty())
+                    addRow(fields, field < FieldCount ? field : FieldCount, out);
+                lineStart = fieldStart = pos + 1;
+                field = 0;
+                if (++lines >= maxRows)
+                    return lineStart;
+            } else {
+                // Guillemet: la ligne entière repasse par l'analyse scalaire
+                const char *lineEnd = parseQuotedLine(lineStart, end, out, atEnd);
+                if (!lineEnd)
+                    return lineStart;
+                lineStart = fieldStart = lineEnd;
+                field = 0;
+                next = size_t(lineEnd - begin);
+                if (++lines >= maxRows)
+                    return lineStart;
+                break;
+            }
+        }
+        offset = next;
+    }
+
+    if (atEnd && lineStart < end) {
+        if (field < FieldCount)
+            fields[field] = makeField(fieldStart, end);
+        ++field;
+        if (field > 1 || !fields[0].empty())
+            addRow(fields, field < FieldCount ? field : FieldCount, out);
+        lineStart = end;
+    }
+    return lineStart;
+}
+
+const char *CsvParser::parseQuotedLine(const char *line, const char *end, ColumnStore &out, bool atEnd)
+{
+    std::string overflow;
+    for (std::string &value : quotedFields)
+        value.clear();
+
+    const char *p = line;
+    int field = 0;
+    for (;;) {
+        std::string &value = field < FieldCount ? quotedFields[field] : overflow;
+        value.clear();
+        if (p < end && *p == '"') {
+            ++p;
+            for (;;) {
+                if (p >= end) {
+                    if (!atEnd)
+                        return nullptr;
+                    break;
+                }
+                if (*p == '"') {
+                    if (p + 1 < end && p[1] == '"') {
+                        value += '"';
+                        p += 2;
+                        continue;
+                    }
+                    ++p;
+                    break;
+                }
+                value += *p++;
+            }
+        }
+        while (p < end && *p != delimiter && *p != '\n')
+            value += *p++;
+        ++field;
+        if (p >= end) {
+            if (!atEnd)
+                return nullptr;
+            break;
+        }
+        if (*p++ == '\n')
+            break;
+    }
+
+    std::string_view fields[FieldCount];
+    const int count = field < FieldCount ? field : FieldCount;
+    for (int i = 0; i < count; ++i)
+        fields[i] = makeField(quotedFields[i].data(), quotedFields[i].data() + quotedFields[i].size());
+    addRow(fields, count, out);
+    return p;
+}
+
+void CsvParser::addRow(const std::string_view *fields, int count, ColumnStore &out)
+{
+    RowValues row;
+    const std::string_view idField = trimmed(fields[ColumnTable::Id]);
+    const auto idResult = std::from_chars(idField.data(), idField.data() + idField.size(), row.id);
+    const bool idValid = count > 0 && idResult.ec == std::errc()
+        && idResult.ptr == idField.data() + idField.size() && !idField.empty();
+
+    // Ligne d'en-tête éventuelle
+    if (!headerChecked) {
+        headerChecked = true;
+        if (!idValid)
+            return;
+    }
+
+    if (count < FieldCount || !idValid
+        || !parseDateField(fields[ColumnTable::Date], row.date)
+        || !parseDoubleField(fields[ColumnTable::Valeur], row.valeur)) {
+        ++errors;
+        return;
+    }
+
+    row.nom = fields[ColumnTable::Nom];
+    row.type = fields[ColumnTable::Type];
+    row.statut = fields[ColumnTable::Statut];
+    out.appendRow(row);
+    ++rows;
+}
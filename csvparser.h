@@ -0,0 +1,50 @@
+// csvparser.h
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+#include "columnstore.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Analyseur de fichiers texte délimités (CSV, .dat texte) vers le stockage
+// colonnaire. Les séparateurs et fins de ligne sont repérés 16 octets à la
+// fois (SSE2 lorsqu'il est disponible); les lignes contenant des guillemets
+// repassent par une analyse scalaire.
+class CsvParser
+{
+public:
+    explicit CsvParser(char delimiter = ';') : delimiter(delimiter) {}
+
+    // Déduit le séparateur (';', ',' ou tabulation) de la première ligne
+    static char detectDelimiter(std::string_view firstLine);
+
+    char fieldDelimiter() const { return delimiter; }
+
+    // Analyse les lignes de [begin, end) et les ajoute à out, au plus maxRows.
+    // Renvoie la position qui suit la dernière ligne consommée. La dernière
+    // ligne sans saut de ligne final n'est lue que si atEnd est vrai.
+    const char *parse(const char *begin, const char *end, ColumnStore &out,
+                      size_t maxRows, bool atEnd);
+
+    size_t rowsParsed() const { return rows; }
+    size_t errorCount() const { return errors; }
+
+private:
+    static constexpr int FieldCount = ColumnTable::ColumnCount;
+
+    char delimiter;
+    size_t rows = 0;
+    size_t errors = 0;
+    bool headerChecked = false;
+    std::string quotedFields[FieldCount];
+
+    void addRow(const std::string_view *fields, int count, ColumnStore &out);
+    const char *parseQuotedLine(const char *line, const char *end, ColumnStore &out, bool atEnd);
+};
+
+bool parseDateField(std::string_view text, int32_t &days);
+bool parseDoubleField(std::string_view text, double &value);
+
+#endif // CSVPARSER_H
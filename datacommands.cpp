@@ -0,0 +1,60 @@
+// datacommands.cpp
+#include "datacommands.h"
+#include "datatablemodel.h"
+
+InsertRowsCommand::InsertRowsCommand(DataTableModel *model, ColumnRows values)
+    : model(model)
+    , values(std::move(values))
+{
+    const size_t count = this->values.size();
+    setText(count == 1 ? QString("Ajout d'une ligne") : QString("Ajout de %1 lignes").arg(count));
+}
+
+void InsertRowsCommand::redo()
+{
+    model->placeRows(values);
+}
+
+void InsertRowsCommand::undo()
+{
+    model->eraseRows(values.rows);
+}
+
+RemoveRowsCommand::RemoveRowsCommand(DataTableModel *model, std::vector<uint32_t> rows)
+    : model(model)
+{
+    removed.rows = std::move(rows);
+    const size_t count = removed.size();
+    setText(count == 1 ? QString("Suppression d'une ligne") : QString("Suppression de %1 lignes").arg(count));
+}
+
+void RemoveRowsCommand::redo()
+{
+    removed = model->eraseRows(removed.rows);
+}
+
+void RemoveRowsCommand::undo()
+{
+    model->placeRows(removed);
+}
+
+EditValuesCommand::EditValuesCommand(DataTableModel *model, ColumnRows values, int column)
+    : model(model)
+    , values(std::move(values))
+    , column(column)
+{
+    const size_t count = this->values.size();
+    const QString header = model->headerData(column, Qt::Horizontal).toString();
+    setText(count == 1 ? QString("Modification de %1").arg(header)
+                       : QString("Modification de %1 sur %2 lignes").arg(header).arg(count));
+}
+
+void EditValuesCommand::redo()
+{
+    previous = model->replaceValues(values, column);
+}
+
+void EditValuesCommand::undo()
+{
+    model->replaceValues(previous, column);
+}
@@ -0,0 +1,61 @@
+// datacommands.h
+#ifndef DATACOMMANDS_H
+#define DATACOMMANDS_H
+
+#include "columnstore.h"
+
+#include <QUndoCommand>
+
+#include <vector>
+
+class DataTableModel;
+
+// Commandes d'annulation du tableau de données. Elles ne gardent que les
+// colonnes touchées (ColumnRows), jamais une copie des lignes entières sous
+// forme de texte: supprimer 500 000 lignes coûte 36 octets par ligne.
+
+// Ajout de lignes (saisie, collage) aux positions values.rows
+class InsertRowsCommand : public QUndoCommand
+{
+public:
+    InsertRowsCommand(DataTableModel *model, ColumnRows values);
+
+    void redo() override;
+    void undo() override;
+
+private:
+    DataTableModel *model;
+    ColumnRows values;
+};
+
+// Suppression de lignes; leurs valeurs sont relevées au premier redo()
+class RemoveRowsCommand : public QUndoCommand
+{
+public:
+    RemoveRowsCommand(DataTableModel *model, std::vector<uint32_t> rows);
+
+    void redo() override;
+    void undo() override;
+
+private:
+    DataTableModel *model;
+    ColumnRows removed;
+};
+
+// Modification d'une colonne sur une ou plusieurs lignes
+class EditValuesCommand : public QUndoCommand
+{
+public:
+    EditValuesCommand(DataTableModel *model, ColumnRows values, int column);
+
+    void redo() override;
+    void undo() override;
+
+private:
+    DataTableModel *model;
+    ColumnRows values;
+    ColumnRows previous;
+    int column;
+};
+
+#endif // DATACOMMANDS_H
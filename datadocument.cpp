@@ -0,0 +1,53 @@
+// datadocument.cpp
+#include "datadocument.h"
+#include "datatablemodel.h"
+#include "dataview.h"
+#include "searchcontroller.h"
+#include "summarycontroller.h"
+
+#include <QFileInfo>
+#include <QUndoStack>
+
+DataDocument::DataDocument(const QString &title, QObject *parent)
+    : QObject(parent)
+    , name(title)
+    , tableModel(new DataTableModel(this))
+    , history(new QUndoStack(this))
+    , rowView(new DataView(tableModel, this))
+    , searchControl(new SearchController(this))
+    , summaryControl(new SummaryController(rowView, tableModel, this))
+{
+    history->setUndoLimit(100);
+    tableModel->setUndoStack(history);
+    // L'index des noms sert aussi au filtre rapide de ce document
+    connect(searchControl, &SearchController::indexReady, this, [this]() {
+        rowView->setNomIndex(searchControl->nomIndex());
+    });
+    // Dictionnaire Nom compacté: l'index donne les anciens codes
+    connect(tableModel, &DataTableModel::nomsCompacted, this, [this]() {
+        searchControl->invalidateIndex();
+        rowView->setNomIndex(nullptr);
+        searchControl->rebuildIndex(tableModel->store().snapshot());
+    });
+}
+
+DataDocument::~DataDocument()
+{
+    // Dans l'ordre inverse des dépendances: chacun attend ses tâches en cours
+    delete summaryControl;
+    delete searchControl;
+    delete rowView;
+    delete history;
+    delete tableModel;
+}
+
+void DataDocument::setFileName(const QString &fileName)
+{
+    path = fileName;
+    name = QFileInfo(fileName).fileName();
+}
+
+bool DataDocument::isBlank() const
+{
+    return path.isEmpty() && tableModel->rowCount() == 0 && history->count() == 0 && !load.loader;
+}
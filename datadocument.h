@@ -0,0 +1,80 @@
+// datadocument.h
+#ifndef DATADOCUMENT_H
+#define DATADOCUMENT_H
+
+#include "taskscheduler.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+class DataTableModel;
+class DataView;
+class FileLoader;
+class QUndoStack;
+class SearchController;
+class SummaryController;
+
+// Un jeu de données ouvert: modèle, vue composée (filtres et tri),
+// historique, recherche et synthèse. Plusieurs documents coexistent, un seul
+// est relié à l'interface; les autres gardent tout leur état (permutations
+// de tri, index, résultats) pour que le retour sur leur onglet ne recalcule
+// rien.
+class DataDocument : public QObject
+{
+    Q_OBJECT
+
+public:
+    // État de l'interface propre au document, rétabli à son activation
+    struct ViewState
+    {
+        QString searchText;
+        int currentMatch = -1;
+        bool searchStale = false;   // lignes déplacées pendant qu'il était caché
+        QByteArray headerState;     // largeurs de colonnes et indicateur de tri
+    };
+
+    // Chargement en cours vers ce document
+    struct LoadState
+    {
+        QPointer<FileLoader> loader;
+        quint64 taskId = 0;
+        TaskContextPtr task;
+        QElapsedTimer timer;
+        bool firstBatchPending = false;
+    };
+
+    explicit DataDocument(const QString &title, QObject *parent = nullptr);
+    ~DataDocument() override;
+
+    DataTableModel *model() const { return tableModel; }
+    DataView *view() const { return rowView; }
+    QUndoStack *undoStack() const { return history; }
+    SearchController *search() const { return searchControl; }
+    SummaryController *summary() const { return summaryControl; }
+
+    QString title() const { return name; }
+    QString fileName() const { return path; }
+    // Le titre devient le nom du fichier
+    void setFileName(const QString &fileName);
+
+    // Vide, sans fichier, historique ni chargement: peut recevoir le
+    // prochain fichier ouvert au lieu d'un nouvel onglet
+    bool isBlank() const;
+
+    ViewState ui;
+    LoadState load;
+
+private:
+    QString name;
+    QString path;
+    DataTableModel *tableModel;
+    QUndoStack *history;
+    DataView *rowView;
+    SearchController *searchControl;
+    SummaryController *summaryControl;
+};
+
+#endif // DATADOCUMENT_H
@@ -0,0 +1,456 @@
+// datatablemodel.cpp
+#include "datatablemodel.h"
+#include "csvparser.h"
+#include "datacommands.h"
+#include "profiler.h"
+
+#include <QColor>
+#include <QDate>
+#include <QUndoStack>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Jour julien du 1970-01-01
+constexpr qint64 EpochJulianDay = 2440588;
+
+QString fromUtf8(std::string_view value)
+{
+    return QString::fromUtf8(value.data(), qsizetype(value.size()));
+}
+
+// Plage [first, last] de lignes consécutives
+struct RowRun
+{
+    uint32_t first;
+    uint32_t last;
+};
+
+// rows triées, sans doublon
+std::vector<RowRun> contiguousRuns(const std::vector<uint32_t> &rows)
+{
+    std::vector<RowRun> runs;
+    for (uint32_t row : rows) {
+        if (!runs.empty() && runs.back().last + 1 == row)
+            runs.back().last = row;
+        else
+            runs.push_back({row, row});
+    }
+    return runs;
+}
+
+} // namespace
+
+DataTableModel::DataTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , headers({"ID", "Nom", "Type", "Date", "Statut", "Valeur"})
+{
+    // Type et Statut: mêmes codes dans tous les documents ouverts
+    columns.setStringPool(&StringPool::instance());
+}
+
+int DataTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return signalledRows >= 0 ? signalledRows : int(columns.rowCount());
+}
+
+int DataTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnTable::ColumnCount + int(computed.size());
+}
+
+QVariant DataTableModel::data(const QModelIndex &index, int role) const
+{
+    PROFILE_AGGREGATE("Modèle: data()");
+    // Pendant une suppression en plusieurs plages, les vues peuvent encore
+    // désigner des lignes au-delà de la fin
+    if (!index.isValid() || size_t(index.row()) >= columns.rowCount())
+        return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return displayText(index.row(), index.column());
+    if (role == Qt::BackgroundRole && hasHighlights) {
+        const size_t row = size_t(index.row());
+        if (row < highlighted.size() && highlighted[row])
+            return QColor(255, 236, 140);
+    }
+    return QVariant();
+}
+
+QVariant DataTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    const bool computedSection = orientation == Qt::Horizontal && isComputedColumn(section)
+                                 && size_t(section - ColumnTable::ColumnCount) < computed.size();
+    if (role == Qt::ToolTipRole && computedSection)
+        return "= " + QString::fromStdString(computed.formula(size_t(section - ColumnTable::ColumnCount)).text());
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (computedSection)
+        return QString::fromStdString(computed.name(size_t(section - ColumnTable::ColumnCount)));
+    if (orientation == Qt::Horizontal)
+        return headers.value(section);
+    return section + 1;
+}
+
+Qt::ItemFlags DataTableModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags result = QAbstractTableModel::flags(index);
+    if (index.isValid() && undoStack && !isComputedColumn(index.column()))
+        result |= Qt::ItemIsEditable;
+    return result;
+}
+
+bool DataTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || !undoStack)
+        return false;
+    const QString text = value.toString();
+    if (text == displayText(index.row(), index.column()))
+        return false;
+    ColumnRows values;
+    if (!encodeValue(index.column(), text, values))
+        return false;
+    values.rows.push_back(uint32_t(index.row()));
+    undoStack->push(new EditValuesCommand(this, std::move(values), index.column()));
+    return true;
+}
+
+bool DataTableModel::encodeValue(int column, const QString &text, ColumnRows &values)
+{
+    const QByteArray utf8 = text.trimmed().toUtf8();
+    const std::string_view field(utf8.constData(), size_t(utf8.size()));
+    switch (column) {
+    case ColumnTable::Id: {
+        bool ok = false;
+        const qint64 id = text.trimmed().toLongLong(&ok);
+        if (ok)
+            values.ids.push_back(id);
+        return ok;
+    }
+    case ColumnTable::Nom:
+        values.noms.push_back(columns.internNom(field));
+        return true;
+    case ColumnTable::Type:
+        values.types.push_back(columns.internType(field));
+        return true;
+    case ColumnTable::Date: {
+        int32_t days = 0;
+        if (!parseDateField(field, days))
+            return false;
+        values.dates.push_back(days);
+        return true;
+    }
+    case ColumnTable::Statut:
+        values.statuts.push_back(columns.internStatut(field));
+        return true;
+    case ColumnTable::Valeur: {
+        double number = 0.0;
+        if (!parseDoubleField(field, number))
+            return false;
+        values.valeurs.push_back(number);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+QString DataTableModel::displayText(int row, int column) const
+{
+    const ColumnTable &table = columns.table();
+    const size_t r = size_t(row);
+    switch (column) {
+    case ColumnTable::Id:
+        return QString::number(table.ids[r]);
+    case ColumnTable::Nom:
+        return fromUtf8(table.nom(r));
+    case ColumnTable::Type:
+        return cachedText(typeTexts, table.typeValues, table.types[r]);
+    case ColumnTable::Date:
+        return QDate::fromJulianDay(table.dates[r] + EpochJulianDay).toString(Qt::ISODate);
+    case ColumnTable::Statut:
+        return cachedText(statutTexts, table.statutValues, table.statuts[r]);
+    case ColumnTable::Valeur:
+        return QString::number(table.valeurs[r], 'f', 2);
+    default:
+        return computedText(row, column);
+    }
+}
+
+QString DataTableModel::computedText(int row, int column) const
+{
+    const size_t index = size_t(column - ColumnTable::ColumnCount);
+    if (column < ColumnTable::ColumnCount || index >= computed.size())
+        return QString();
+    const double value = computed.value(columns.table(), index, size_t(row));
+    // Division par zéro, date hors limites...: cellule vide
+    if (!std::isfinite(value))
+        return QString();
+    switch (computed.formula(index).resultType()) {
+    case Formula::Type::Boolean:
+        return value != 0.0 ? QStringLiteral("Oui") : QStringLiteral("Non");
+    case Formula::Type::Date:
+        return QDate::fromJulianDay(qint64(value) + EpochJulianDay).toString(Qt::ISODate);
+    case Formula::Type::Number:
+        break;
+    }
+    // Entiers (année, mois...) sans décimales, le reste comme Valeur
+    if (value == std::floor(value) && std::fabs(value) < 1e15)
+        return QString::number(qint64(value));
+    return QString::number(value, 'f', 2);
+}
+
+bool DataTableModel::addComputedColumn(const QString &name, const QString &formula, QString *errorMessage)
+{
+    // Compilée avant l'insertion: une formule invalide ne change rien au modèle
+    Formula compiled;
+    std::string error;
+    if (!compiled.compile(formula.trimmed().toStdString(), &error)) {
+        if (errorMessage)
+            *errorMessage = QString::fromStdString(error);
+        return false;
+    }
+    const int column = columnCount();
+    beginInsertColumns(QModelIndex(), column, column);
+    computed.add(name.toStdString(), std::move(compiled));
+    endInsertColumns();
+    return true;
+}
+
+void DataTableModel::removeComputedColumn(int column)
+{
+    if (!isComputedColumn(column) || column >= columnCount())
+        return;
+    beginRemoveColumns(QModelIndex(), column, column);
+    computed.remove(size_t(column - ColumnTable::ColumnCount));
+    endRemoveColumns();
+}
+
+QString DataTableModel::cachedText(QVector<QString> &cache, const StringColumn &values, uint32_t code)
+{
+    if (code >= uint32_t(cache.size())) {
+        for (qsizetype i = cache.size(); i < qsizetype(values.size()); ++i)
+            cache.append(fromUtf8(values[size_t(i)]));
+    }
+    return cache.value(code);
+}
+
+void DataTableModel::addHighlights(const uint32_t *rows, size_t count)
+{
+    if (count == 0)
+        return;
+    if (highlighted.size() < columns.rowCount())
+        highlighted.resize(columns.rowCount(), false);
+    for (size_t i = 0; i < count; ++i) {
+        if (rows[i] < highlighted.size())
+            highlighted[rows[i]] = true;
+    }
+    hasHighlights = true;
+    refreshHighlights();
+}
+
+void DataTableModel::clearHighlights()
+{
+    if (!hasHighlights)
+        return;
+    std::vector<bool>().swap(highlighted);
+    hasHighlights = false;
+    refreshHighlights();
+}
+
+void DataTableModel::refreshHighlights()
+{
+    // Un seul signal pour toute la table: la vue ne repeint que le visible
+    if (columns.rowCount() > 0) {
+        emit dataChanged(index(0, 0), index(int(columns.rowCount()) - 1, columnCount() - 1),
+                         {Qt::BackgroundRole});
+    }
+}
+
+void DataTableModel::appendRow(const RowValues &row)
+{
+    const int position = int(columns.rowCount());
+    beginInsertRows(QModelIndex(), position, position);
+    columns.appendRow(row);
+    computed.invalidateFrom(size_t(position));
+    endInsertRows();
+}
+
+void DataTableModel::appendTable(const ColumnTable &batch)
+{
+    if (batch.rowCount() == 0)
+        return;
+    const int first = int(columns.rowCount());
+    beginInsertRows(QModelIndex(), first, first + int(batch.rowCount()) - 1);
+    columns.appendTable(batch);
+    computed.invalidateFrom(size_t(first));
+    endInsertRows();
+}
+
+ColumnRows DataTableModel::eraseRows(const std::vector<uint32_t> &rows)
+{
+    if (rows.empty())
+        return ColumnRows();
+    const std::vector<RowRun> runs = contiguousRuns(rows);
+    const bool reset = runs.size() > MaxSignalledRuns;
+    if (reset)
+        beginResetModel();
+    else
+        signalledRows = int(columns.rowCount());
+
+    ColumnRows removed = columns.extractRows(rows);
+    columns.removeRows(rows);
+    computed.invalidateFrom(rows.front());
+    // Les numéros de lignes ont changé: la recherche sera relancée
+    std::vector<bool>().swap(highlighted);
+    hasHighlights = false;
+    emit rowsErased(rows);
+
+    if (reset) {
+        endResetModel();
+        return removed;
+    }
+    // De la dernière plage à la première: les précédentes gardent leurs numéros
+    for (size_t i = runs.size(); i-- > 0;) {
+        beginRemoveRows(QModelIndex(), int(runs[i].first), int(runs[i].last));
+        signalledRows = i == 0 ? -1 : signalledRows - int(runs[i].last - runs[i].first + 1);
+        endRemoveRows();
+    }
+    return removed;
+}
+
+void DataTableModel::placeRows(const ColumnRows &values)
+{
+    const std::vector<uint32_t> &rows = values.rows;
+    if (rows.empty())
+        return;
+    const std::vector<RowRun> runs = contiguousRuns(rows);
+    const bool reset = runs.size() > MaxSignalledRuns;
+    if (reset)
+        beginResetModel();
+    else
+        signalledRows = int(columns.rowCount());
+
+    columns.insertRows(values);
+    computed.invalidateFrom(rows.front());
+    std::vector<bool>().swap(highlighted);
+    hasHighlights = false;
+    emit rowsPlaced(rows);
+
+    if (reset) {
+        endResetModel();
+        return;
+    }
+    // Positions finales: de la première plage à la dernière, chacune est à
+    // sa place une fois les précédentes insérées
+    for (size_t i = 0; i < runs.size(); ++i) {
+        beginInsertRows(QModelIndex(), int(runs[i].first), int(runs[i].last));
+        signalledRows = i + 1 == runs.size() ? -1 : signalledRows + int(runs[i].last - runs[i].first + 1);
+        endInsertRows();
+    }
+}
+
+ColumnRows DataTableModel::replaceValues(const ColumnRows &values, int column)
+{
+    if (values.rows.empty())
+        return ColumnRows();
+    ColumnRows previous = columns.extractRows(values.rows, column);
+    columns.assignColumn(values, column);
+    computed.invalidateRows(values.rows, column);
+
+    // Un seul signal pour la plage couverte (et les colonnes calculées qui en dépendent)
+    const auto [low, high] = std::minmax_element(values.rows.begin(), values.rows.end());
+    emit dataChanged(index(int(*low), column), index(int(*high), column), {Qt::DisplayRole, Qt::EditRole});
+    if (computed.dependsOn(column))
+        emit dataChanged(index(int(*low), ColumnTable::ColumnCount), index(int(*high), columnCount() - 1),
+                         {Qt::DisplayRole, Qt::EditRole});
+    emit valuesChanged(values.rows, column, previous);
+    return previous;
+}
+
+void DataTableModel::appendRows(const ColumnRows &values)
+{
+    if (values.ids.empty())
+        return;
+    const int first = int(columns.rowCount());
+    beginInsertRows(QModelIndex(), first, first + int(values.ids.size()) - 1);
+    columns.appendRows(values);
+    computed.invalidateFrom(size_t(first));
+    endInsertRows();
+}
+
+void DataTableModel::updateRows(const ColumnRows &values)
+{
+    const std::vector<uint32_t> &rows = values.rows;
+    if (rows.empty())
+        return;
+    ColumnRows previous = columns.extractRows(rows);
+    for (int column = ColumnTable::Nom; column < ColumnTable::ColumnCount; ++column)
+        columns.assignColumn(values, column);
+    computed.invalidateRows(rows, -1);
+
+    // Plages contiguës, les petits trous comblés: la vue ne repeint de toute
+    // façon que ses lignes visibles, mais chaque signal a un coût fixe
+    constexpr uint32_t MergeGap = 64;
+    constexpr size_t MaxRanges = 32;
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (uint32_t row : rows) {
+        if (!ranges.empty() && row - ranges.back().second <= MergeGap)
+            ranges.back().second = row;
+        else
+            ranges.emplace_back(row, row);
+    }
+    if (ranges.size() > MaxRanges)
+        ranges.assign(1, {rows.front(), rows.back()});
+    const int lastColumn = columnCount() - 1;
+    for (const auto &[low, high] : ranges)
+        emit dataChanged(index(int(low), ColumnTable::Nom), index(int(high), lastColumn),
+                         {Qt::DisplayRole, Qt::EditRole});
+    emit valuesChanged(rows, -1, previous);
+}
+
+size_t DataTableModel::compactNoms()
+{
+    const size_t removed = columns.compactNoms();
+    if (removed == 0)
+        return 0;
+    computed.rebindAll();
+    // Les commandes gardent des lignes codées avec les anciens codes
+    if (undoStack)
+        undoStack->clear();
+    emit nomsCompacted();
+    return removed;
+}
+
+void DataTableModel::setTable(const ColumnTable &table)
+{
+    beginResetModel();
+    columns.assign(table);
+    computed.invalidateAll();
+    std::vector<bool>().swap(highlighted);
+    hasHighlights = false;
+    typeTexts.clear();
+    statutTexts.clear();
+    endResetModel();
+}
+
+void DataTableModel::adoptStorage(const ColumnTable &copy)
+{
+    // Mêmes valeurs: ni signal ni invalidation
+    columns.adoptStorage(copy);
+}
+
+void DataTableModel::clear()
+{
+    beginResetModel();
+    columns.clear();
+    computed.invalidateAll();
+    std::vector<bool>().swap(highlighted);
+    hasHighlights = false;
+    typeTexts.clear();
+    statutTexts.clear();
+    endResetModel();
+}
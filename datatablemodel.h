@@ -0,0 +1,124 @@
+// datatablemodel.h
+#ifndef DATATABLEMODEL_H
+#define DATATABLEMODEL_H
+
+#include "columnstore.h"
+#include "computedcolumns.h"
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+class QUndoStack;
+
+// Modèle de table au-dessus du stockage colonnaire. Les valeurs ne sont
+// formatées qu'à la demande de la vue, donc uniquement pour les lignes visibles.
+class DataTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit DataTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    // L'édition depuis la vue passe par la pile d'annulation
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    void setUndoStack(QUndoStack *stack) { undoStack = stack; }
+
+    const ColumnStore &store() const { return columns; }
+
+    void appendRow(const RowValues &row);
+    void appendTable(const ColumnTable &batch);
+    void setTable(const ColumnTable &table);
+    // Même contenu, porté par d'autres blocs (copie projetée, voir MemoryBudget)
+    void adoptStorage(const ColumnTable &copy);
+    void clear();
+
+    // Colonnes calculées, après celles du tableau et non modifiables. Faux
+    // si la formule est invalide (errorMessage explique pourquoi)
+    bool addComputedColumn(const QString &name, const QString &formula, QString *errorMessage);
+    void removeComputedColumn(int column);
+    bool isComputedColumn(int column) const { return column >= ColumnTable::ColumnCount; }
+    const ComputedColumns &computedColumns() const { return computed; }
+
+    // Texte affiché d'une cellule
+    QString displayText(int row, int column) const;
+    // Ajoute à values la valeur saisie pour une colonne; faux si le texte est invalide
+    bool encodeValue(int column, const QString &text, ColumnRows &values);
+    // Lignes d'un autre tableau (collage) codées dans les dictionnaires du modèle
+    ColumnRows encodeRows(const ColumnTable &table) { return columns.encodeRows(table); }
+
+    // Opérations groupées (utilisées par les commandes d'annulation). Chaque
+    // plage contiguë de lignes est signalée par son beginRemoveRows (de la
+    // dernière à la première) ou beginInsertRows (de la première à la
+    // dernière): sélection, ligne courante et défilement sont conservés.
+    // Au-delà de MaxSignalledRuns plages, une seule remise à zéro coûte moins
+    // aux vues que la suite de signaux. Les données sont modifiées en une fois
+    // avant le premier signal; rowCount() suit les plages déjà signalées.
+    static constexpr size_t MaxSignalledRuns = 128;
+    // Vrai entre la modification des données et le dernier signal de plage
+    bool isRestructuring() const { return signalledRows >= 0; }
+    // Retire les lignes (triées, sans doublon) et renvoie leurs valeurs
+    ColumnRows eraseRows(const std::vector<uint32_t> &rows);
+    // Insère les lignes aux positions finales values.rows
+    void placeRows(const ColumnRows &values);
+    // Remplace une colonne des lignes values.rows; renvoie les anciennes valeurs
+    ColumnRows replaceValues(const ColumnRows &values, int column);
+
+    // Flux de données: lots déjà codés dans les dictionnaires du modèle.
+    // Ajoute les lignes à la fin (un seul beginInsertRows)
+    void appendRows(const ColumnRows &values);
+    // Remplace toutes les colonnes sauf Id des lignes values.rows (triées, sans
+    // doublon). Les lignes touchées sont signalées par quelques plages
+    // fusionnées, puis par valuesChanged avec la colonne -1.
+    void updateRows(const ColumnRows &values);
+    // Retire du dictionnaire Nom les valeurs des lignes disparues (voir
+    // ColumnStore::compactNoms). Les codes changent: l'historique
+    // d'annulation est vidé et nomsCompacted signale les index à refaire.
+    size_t compactNoms();
+
+    // Mise en évidence des lignes trouvées par la recherche
+    void addHighlights(const uint32_t *rows, size_t count);
+    void clearHighlights();
+
+signals:
+    // Émis pendant l'opération, données déjà à jour, avant le premier
+    // signal de plage (ou dans la remise à zéro)
+    void rowsErased(const std::vector<uint32_t> &rows);
+    void rowsPlaced(const std::vector<uint32_t> &rows);
+    // Émis après la modification; column vaut -1 quand toutes les colonnes
+    // sauf Id ont changé (previous les contient alors toutes)
+    void valuesChanged(const std::vector<uint32_t> &rows, int column, const ColumnRows &previous);
+    // Codes Nom renumérotés, valeurs et lignes inchangées
+    void nomsCompacted();
+
+private:
+    ColumnStore columns;
+    QUndoStack *undoStack = nullptr;
+    QStringList headers;
+    // Calculées à l'affichage, d'où mutable
+    mutable ComputedColumns computed;
+
+    // Cache des QString des petits dictionnaires (Type, Statut)
+    mutable QVector<QString> typeTexts;
+    mutable QVector<QString> statutTexts;
+
+    std::vector<bool> highlighted;
+    bool hasHighlights = false;
+    // Nombre de lignes annoncé aux vues pendant eraseRows/placeRows, -1 sinon
+    int signalledRows = -1;
+
+    void refreshHighlights();
+    QString computedText(int row, int column) const;
+
+    static QString cachedText(QVector<QString> &cache, const StringColumn &values, uint32_t code);
+};
+
+#endif // DATATABLEMODEL_H
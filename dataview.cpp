@@ -0,0 +1,573 @@
+// dataview.cpp
+#include "dataview.h"
+#include "datatablemodel.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "rowremap.h"
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+// Lignes retenues par le filtre texte parmi candidates (toutes si nul)
+std::vector<uint32_t> filterRows(const ColumnTable &table, const TrigramIndex *index, const std::string &query,
+                                 const std::vector<uint32_t> *candidates, const std::atomic<bool> &cancelled)
+{
+    PROFILE_SCOPE("Filtre");
+    std::vector<uint32_t> rows;
+    SearchEngine::search(table, index, query, candidates, cancelled, [&rows](std::vector<uint32_t> &&batch) {
+        rows.insert(rows.end(), batch.begin(), batch.end());
+    });
+    return rows;
+}
+
+} // namespace
+
+DataView::DataView(DataTableModel *source, QObject *parent)
+    : QObject(parent)
+    , source(source)
+    , proxy(new DataViewModel(this))
+    , filterDelay(new QTimer(this))
+{
+    proxy->setSourceModel(source);
+    categories.rebuild(source->store().table());
+    dates.rebuild(source->store().table().dates);
+    filterDelay->setSingleShot(true);
+    filterDelay->setInterval(200);
+    connect(filterDelay, &QTimer::timeout, this, &DataView::refresh);
+
+    // Nouvelles données: rechargement complet ou lignes ajoutées
+    connect(source, &QAbstractItemModel::modelReset, this, &DataView::onSourceReset);
+    connect(source, &QAbstractItemModel::rowsInserted, this, &DataView::onRowsInserted);
+    connect(source, &QAbstractItemModel::rowsRemoved, this, &DataView::finishRestructure);
+    // Modifications groupées (ajout, suppression, édition)
+    connect(source, &DataTableModel::rowsErased, this, &DataView::onRowsErased);
+    connect(source, &DataTableModel::rowsPlaced, this, &DataView::onRowsPlaced);
+    connect(source, &DataTableModel::valuesChanged, this, &DataView::onValuesChanged);
+}
+
+DataView::~DataView()
+{
+    // Les tâches en cours rappellent cet objet: on attend leur fin
+    cancel();
+    for (std::future<void> &job : jobs)
+        job.wait();
+}
+
+void DataView::setTextFilter(const QString &text)
+{
+    if (text == filterText)
+        return;
+    filterText = text;
+    // Le calcul en cours ne correspond plus à la saisie
+    if (cancelToken)
+        cancelToken->store(true);
+    filterDelay->start();
+}
+
+void DataView::applyNow()
+{
+    if (filterDelay->isActive())
+        refresh();
+}
+
+void DataView::setCategory(const QString &type)
+{
+    if (type == categoryName)
+        return;
+    categoryName = type;
+    publish(0);
+}
+
+void DataView::setDateRange(const DateRange &range)
+{
+    if (range == period)
+        return;
+    period = range;
+    publish(0);
+}
+
+int64_t DataView::categoryCode() const
+{
+    const std::string name = categoryName.toUtf8().toStdString();
+    return source->store().findType(name);
+}
+
+std::vector<uint32_t> DataView::restrictToCategory(const std::vector<uint32_t> &rows) const
+{
+    const int64_t code = categoryCode();
+    if (code < 0)
+        return {};
+    const RowBitmap &bitmap = categories.bitmap(uint32_t(code));
+
+    // Intersection par tranches en parallèle, raccordées dans l'ordre
+    constexpr size_t Slice = 65536;
+    const size_t sliceCount = (rows.size() + Slice - 1) / Slice;
+    std::vector<std::vector<uint32_t>> parts(sliceCount);
+    parallelFor(sliceCount, 1, [&](size_t first, size_t last) {
+        for (size_t slice = first; slice < last; ++slice) {
+            const size_t begin = slice * Slice;
+            bitmap.intersect(rows.data() + begin, std::min(Slice, rows.size() - begin), parts[slice]);
+        }
+    });
+    std::vector<uint32_t> result;
+    for (const auto &part : parts)
+        result.insert(result.end(), part.begin(), part.end());
+    return result;
+}
+
+std::vector<uint32_t> DataView::restrictToPeriod(const std::vector<uint32_t> &rows) const
+{
+    const BlockVector<int32_t> &column = source->store().table().dates;
+    constexpr size_t Slice = 65536;
+    const size_t sliceCount = (rows.size() + Slice - 1) / Slice;
+    std::vector<std::vector<uint32_t>> parts(sliceCount);
+    parallelFor(sliceCount, 1, [&](size_t first, size_t last) {
+        for (size_t slice = first; slice < last; ++slice) {
+            const size_t begin = slice * Slice;
+            dates.restrict(column, rows.data() + begin, std::min(Slice, rows.size() - begin), period, parts[slice]);
+        }
+    });
+    std::vector<uint32_t> result;
+    for (const auto &part : parts)
+        result.insert(result.end(), part.begin(), part.end());
+    return result;
+}
+
+void DataView::setSort(const SortKeys &keys)
+{
+    if (keys == sorting)
+        return;
+    sorting = keys;
+    publish(0);
+}
+
+bool DataView::isUpdating() const
+{
+    return running || filterDelay->isActive() || sortRunning || restructured;
+}
+
+void DataView::publish(qint64 elapsedMs, bool coalesce)
+{
+    // Durée des intersections (ensembles de catégories, zones de dates)
+    // calculées ici, ajoutée à celle du calcul qui a précédé
+    QElapsedTimer timer;
+    timer.start();
+    const bool byText = !filterText.isEmpty();
+    const bool byCategory = !categoryName.isEmpty();
+    const bool byPeriod = period.isValid();
+
+    if (!byText && !byCategory && !byPeriod) {
+        present(RowList(), true, elapsedMs, coalesce);
+        return;
+    }
+    if (!byText && !byCategory) {
+        // Période seule: les zones hors période ne sont pas lues
+        RowList rows = std::make_shared<std::vector<uint32_t>>(dates.select(source->store().table().dates, period));
+        present(std::move(rows), false, elapsedMs + timer.elapsed(), coalesce);
+        return;
+    }
+
+    RowList rows;
+    if (!byText) {
+        const int64_t code = categoryCode();
+        if (code >= 0)
+            rows = categories.rows(uint32_t(code));
+    } else if (!textRows) {
+        // Filtre texte en cours de calcul: il publiera son résultat
+        return;
+    } else if (!byCategory) {
+        rows = textRows;
+    } else {
+        rows = std::make_shared<std::vector<uint32_t>>(restrictToCategory(*textRows));
+    }
+    if (byPeriod && rows)
+        rows = std::make_shared<std::vector<uint32_t>>(restrictToPeriod(*rows));
+    present(std::move(rows), false, elapsedMs + timer.elapsed(), coalesce);
+}
+
+void DataView::present(RowList rows, bool allRows, qint64 elapsedMs, bool coalesce)
+{
+    if (sorting.empty()) {
+        if (sortToken)
+            sortToken->store(true);
+        ++sortGeneration;
+        sortRunning = false;
+        sortPending = false;
+        if (allRows)
+            proxy->showAllRows();
+        else
+            proxy->setRows(std::move(rows), true);
+        emit viewUpdated(qint64(proxy->rowCount()), elapsedMs);
+        return;
+    }
+    if (coalesce && sortRunning) {
+        sortPending = true;
+        return;
+    }
+    orderRows(std::move(rows), allRows, elapsedMs);
+}
+
+void DataView::orderRows(RowList rows, bool allRows, qint64 elapsedMs)
+{
+    if (sortToken)
+        sortToken->store(true);
+    const quint64 current = ++sortGeneration;
+    sortToken = std::make_shared<std::atomic<bool>>(false);
+    sortRunning = true;
+    sortPending = false;
+
+    // Copie de l'entrée en cache: le calcul la complète sans toucher au cache
+    std::shared_ptr<SortCache::Entry> entry;
+    if (const SortCache::Entry *cached = sortCache.find(sorting))
+        entry = std::make_shared<SortCache::Entry>(*cached);
+    auto token = sortToken;
+    const SortKeys keys = sorting;
+    const quint64 stamp = layoutStamp;
+    ColumnTablePtr table = source->store().snapshot();
+
+    track(runAsync([this, table, keys, entry, rows, allRows, elapsedMs, token, current, stamp]() mutable {
+        QElapsedTimer timer;
+        timer.start();
+        bool updated = false;
+        if (!entry) {
+            auto permutation = std::make_shared<std::vector<uint32_t>>(SortEngine::sort(*table, keys, *token));
+            if (token->load())
+                return;
+            entry = std::make_shared<SortCache::Entry>();
+            entry->keys = keys;
+            entry->permutation = std::move(permutation);
+            entry->rowCount = table->rowCount();
+            updated = true;
+        } else if (entry->rowCount != table->rowCount() || !entry->moved.empty()) {
+            // Lignes ajoutées ou modifiées depuis: simple mise à jour
+            entry->permutation = std::make_shared<std::vector<uint32_t>>(
+                SortEngine::update(*table, keys, *entry->permutation, entry->rowCount, entry->moved));
+            entry->positions.reset();
+            entry->rowCount = table->rowCount();
+            entry->moved.clear();
+            updated = true;
+        }
+
+        RowList ordered;
+        if (allRows) {
+            ordered = entry->permutation;
+        } else {
+            if (!entry->positions) {
+                entry->positions = std::make_shared<std::vector<uint32_t>>(SortEngine::inverse(*entry->permutation));
+                updated = true;
+            }
+            ordered = std::make_shared<std::vector<uint32_t>>(
+                SortEngine::orderSubset(rows ? *rows : std::vector<uint32_t>(), *entry->positions));
+        }
+        if (token->load())
+            return;
+        const qint64 elapsed = elapsedMs + timer.elapsed();
+
+        QMetaObject::invokeMethod(this, [this, entry, ordered, updated, current, stamp, elapsed]() {
+            // Le calcul reste utile aux tris suivants même si la vue a changé
+            if (updated && stamp == layoutStamp)
+                sortCache.store(std::move(*entry));
+            if (current != sortGeneration)
+                return;
+            sortRunning = false;
+            proxy->setRows(ordered, false);
+            emit viewUpdated(qint64(proxy->rowCount()), elapsed);
+            if (sortPending)
+                publish(0);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void DataView::onSourceReset()
+{
+    if (restructured) {
+        finishRestructure();
+        return;
+    }
+    // Les numéros de lignes ne désignent plus les mêmes données
+    categories.rebuild(source->store().table());
+    dates.rebuild(source->store().table().dates);
+    sortCache.clear();
+    ++layoutStamp;
+    if (filterText.isEmpty()) {
+        cancel();
+        textRows.reset();
+        publish(0);
+        return;
+    }
+    // Rien n'est affiché tant que le filtre n'a pas été évalué
+    proxy->setRows(RowList(), true);
+    refresh();
+}
+
+void DataView::onRowsInserted(const QModelIndex &, int first, int last)
+{
+    if (restructured) {
+        finishRestructure();
+        return;
+    }
+    const ColumnTable &table = source->store().table();
+    categories.appendRows(table, size_t(first), size_t(last) + 1);
+    dates.appendRows(table.dates, size_t(first), size_t(last) + 1);
+
+    if (!filterText.isEmpty()) {
+        extendToNewRows();
+    } else if (!sorting.empty()) {
+        // Les nouvelles lignes prennent leur place au prochain tri
+        publish(0, true);
+    } else if (!categoryName.isEmpty() || period.isValid()) {
+        const bool byCategory = !categoryName.isEmpty();
+        const int64_t code = byCategory ? categoryCode() : -1;
+        std::vector<uint32_t> added;
+        for (size_t row = size_t(first); row <= size_t(last); ++row) {
+            if ((!byCategory || int64_t(table.types[row]) == code)
+                && (!period.isValid() || period.contains(table.dates[row])))
+                added.push_back(uint32_t(row));
+        }
+        proxy->appendRows(added);
+    }
+}
+
+void DataView::cancelSort()
+{
+    // Un tri en cours porte sur l'ancienne numérotation
+    if (sortToken)
+        sortToken->store(true);
+    ++sortGeneration;
+    sortRunning = false;
+    sortPending = false;
+    ++layoutStamp;
+}
+
+void DataView::onRowsErased(const std::vector<uint32_t> &rows)
+{
+    const ColumnStore &store = source->store();
+    restructured = true;
+    proxy->remapRemoved(rows);
+    categories.removeRows(rows);
+    dates.removeRows(store.table().dates, rows);
+    sortCache.rowsRemoved(rows, store.rowCount() + rows.size());
+    cancelSort();
+
+    if (filterText.isEmpty())
+        return;
+    if (running || filterDelay->isActive() || !textRows) {
+        // Calcul en cours sur l'ancienne numérotation: à refaire
+        refreshAfterRestructure = true;
+        return;
+    }
+    // Le résultat du filtre reste exact une fois renuméroté
+    textRows = std::make_shared<std::vector<uint32_t>>(rowsAfterRemoval(*textRows, rows));
+    coveredRows -= size_t(std::lower_bound(rows.begin(), rows.end(), uint32_t(coveredRows)) - rows.begin());
+    lastVersion = store.version();
+}
+
+void DataView::onRowsPlaced(const std::vector<uint32_t> &rows)
+{
+    const ColumnStore &store = source->store();
+    const size_t previousCount = store.rowCount() - rows.size();
+    // Ajout en fin de tableau: traité comme un chargement (onRowsInserted)
+    if (rows.front() >= previousCount)
+        return;
+
+    restructured = true;
+    proxy->remapInserted(rows);
+    categories.insertRows(store.table(), rows);
+    dates.insertRows(store.table().dates, rows);
+    sortCache.rowsInserted(rows, previousCount);
+    cancelSort();
+
+    // Les lignes insérées doivent passer le filtre texte
+    if (!filterText.isEmpty()) {
+        if (textRows)
+            textRows = std::make_shared<std::vector<uint32_t>>(rowsAfterInsertion(*textRows, rows));
+        refreshAfterRestructure = true;
+    }
+}
+
+void DataView::finishRestructure()
+{
+    // Une suppression ou insertion en plusieurs plages se termine au dernier signal
+    if (!restructured || source->isRestructuring())
+        return;
+    restructured = false;
+    proxy->endRemap();
+    if (refreshAfterRestructure) {
+        refreshAfterRestructure = false;
+        if (!filterText.isEmpty()) {
+            refresh();
+            return;
+        }
+    }
+    publish(0);
+}
+
+void DataView::onValuesChanged(const std::vector<uint32_t> &rows, int column, const ColumnRows &previous)
+{
+    const ColumnTable &table = source->store().table();
+    // column < 0: lot du flux de données, toutes les colonnes sauf Id
+    const bool allColumns = column < 0;
+    if (column == ColumnTable::Type || allColumns) {
+        for (size_t i = 0; i < rows.size(); ++i)
+            categories.updateRow(rows[i], previous.types[i], table.types[rows[i]]);
+    }
+    if (column == ColumnTable::Date || allColumns) {
+        for (uint32_t row : rows)
+            dates.updateRow(row, table.dates[row]);
+    }
+    if (allColumns)
+        sortCache.rowsChanged(rows, {ColumnTable::Nom, ColumnTable::Type, ColumnTable::Date,
+                                     ColumnTable::Statut, ColumnTable::Valeur});
+    else
+        sortCache.rowsChanged(rows, {column});
+    ++layoutStamp;
+
+    if (!filterText.isEmpty()) {
+        // Les lignes modifiées peuvent entrer dans le filtre ou en sortir.
+        // Le flux en modifie à chaque image: on regroupe au rythme de la saisie.
+        if (!allColumns)
+            refresh();
+        else if (!filterDelay->isActive())
+            filterDelay->start();
+    } else if (!sorting.empty() || ((column == ColumnTable::Type || allColumns) && !categoryName.isEmpty())
+               || ((column == ColumnTable::Date || allColumns) && period.isValid())) {
+        publish(0, true);
+    }
+}
+
+void DataView::track(std::future<void> job)
+{
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const std::future<void> &pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), jobs.end());
+    jobs.push_back(std::move(job));
+}
+
+void DataView::cancel()
+{
+    if (cancelToken)
+        cancelToken->store(true);
+    ++generation;
+    running = false;
+}
+
+void DataView::refresh()
+{
+    filterDelay->stop();
+    const bool previousComplete = textRows && !running;
+    RowList previousRows = std::move(textRows);
+    cancel();
+
+    const ColumnStore &store = source->store();
+    if (filterText.isEmpty()) {
+        lastQuery.clear();
+        coveredRows = store.rowCount();
+        publish(0);
+        return;
+    }
+
+    const std::string query = filterText.toUtf8().toStdString();
+    std::string folded;
+    foldCase(query, folded);
+
+    // Affinage: la nouvelle saisie prolonge l'ancienne sur les mêmes données,
+    // seules les lignes déjà retenues peuvent encore l'être
+    RowList candidates;
+    if (previousComplete && store.version() == lastVersion
+        && !lastQuery.empty() && folded.find(lastQuery) != std::string::npos) {
+        candidates = std::move(previousRows);
+    }
+    lastQuery = folded;
+    running = true;
+
+    const quint64 current = ++generation;
+    const quint64 version = store.version();
+    cancelToken = std::make_shared<std::atomic<bool>>(false);
+    auto token = cancelToken;
+    auto index = nomIndex;
+    ColumnTablePtr table = store.snapshot();
+
+    track(runAsync([this, table, index, query, candidates, token, current, version]() {
+        QElapsedTimer timer;
+        timer.start();
+        auto rows = std::make_shared<std::vector<uint32_t>>(
+            filterRows(*table, index.get(), query, candidates.get(), *token));
+        if (token->load())
+            return;
+        const size_t covered = table->rowCount();
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, rows, covered, current, version, elapsed]() {
+            if (current != generation)
+                return;
+            running = false;
+            textRows = rows;
+            coveredRows = covered;
+            lastVersion = version;
+            publish(elapsed);
+            extendToNewRows();
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void DataView::extendToNewRows()
+{
+    // Un seul calcul à la fois: les lignes arrivées entre-temps seront
+    // reprises à la fin du calcul en cours
+    if (filterText.isEmpty() || running || filterDelay->isActive() || !textRows || !cancelToken)
+        return;
+    const ColumnStore &store = source->store();
+    const size_t total = store.rowCount();
+    if (coveredRows >= total)
+        return;
+
+    auto candidates = std::make_shared<std::vector<uint32_t>>(total - coveredRows);
+    std::iota(candidates->begin(), candidates->end(), uint32_t(coveredRows));
+    running = true;
+
+    const quint64 current = generation;
+    const quint64 version = store.version();
+    auto token = cancelToken;
+    auto index = nomIndex;
+    const std::string query = filterText.toUtf8().toStdString();
+    ColumnTablePtr table = store.snapshot();
+
+    track(runAsync([this, table, index, query, candidates, token, current, total, version]() {
+        auto rows = std::make_shared<std::vector<uint32_t>>(
+            filterRows(*table, index.get(), query, candidates.get(), *token));
+        if (token->load())
+            return;
+        QMetaObject::invokeMethod(this, [this, rows, current, total, version]() {
+            if (current != generation)
+                return;
+            running = false;
+            coveredRows = total;
+            // Le résultat couvre désormais les données de cette version
+            lastVersion = version;
+            if (!sorting.empty()) {
+                // Le tri replacera les nouvelles lignes
+                DataViewModel::appendTo(textRows, *rows);
+                publish(0, true);
+            } else {
+                if (categoryName.isEmpty() && !period.isValid()) {
+                    // La vue partage textRows: on la prolonge, puis on reprend sa liste
+                    textRows.reset();
+                    proxy->appendRows(*rows);
+                    textRows = proxy->rows();
+                } else {
+                    DataViewModel::appendTo(textRows, *rows);
+                    std::vector<uint32_t> shown = categoryName.isEmpty() ? *rows : restrictToCategory(*rows);
+                    proxy->appendRows(period.isValid() ? restrictToPeriod(shown) : shown);
+                }
+                emit viewUpdated(qint64(proxy->rowCount()), 0);
+            }
+            extendToNewRows();
+        }, Qt::QueuedConnection);
+    }));
+}
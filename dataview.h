@@ -0,0 +1,135 @@
+// dataview.h
+#ifndef DATAVIEW_H
+#define DATAVIEW_H
+
+#include "categoryindex.h"
+#include "dateindex.h"
+#include "dataviewmodel.h"
+#include "searchengine.h"
+#include "sortengine.h"
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+class DataTableModel;
+class QTimer;
+
+// Compose les lignes affichées par la vue à partir des critères courants:
+// filtre texte, catégorie (valeur de Type), période (colonne Date) et tri. Le filtre texte et le tri
+// sont calculés sur la réserve de threads; un calcul dépassé est annulé et
+// son résultat ignoré. La catégorie s'appuie sur la partition précalculée
+// des lignes: changer de catégorie ne relit pas le tableau, le résultat du
+// filtre texte est simplement croisé avec l'ensemble de la catégorie. La
+// période passe par la carte de zones de la colonne Date. Le tri
+// remet les lignes retenues dans l'ordre d'une permutation gardée en cache.
+class DataView : public QObject
+{
+    Q_OBJECT
+
+public:
+    using RowList = DataViewModel::RowList;
+
+    explicit DataView(DataTableModel *source, QObject *parent = nullptr);
+    ~DataView() override;
+
+    DataViewModel *model() const { return proxy; }
+    const CategoryIndex &categoryIndex() const { return categories; }
+    const DateIndex &dateIndex() const { return dates; }
+
+    // Filtre texte appliqué après une courte pause de frappe
+    void setTextFilter(const QString &text);
+    // Applique tout de suite le filtre en attente
+    void applyNow();
+    QString textFilter() const { return filterText; }
+
+    // Valeur de Type à afficher, vide pour toutes
+    void setCategory(const QString &type);
+    QString category() const { return categoryName; }
+
+    // Période de la colonne Date à afficher, vide (par défaut) pour toutes
+    void setDateRange(const DateRange &range);
+    const DateRange &dateRange() const { return period; }
+
+    // Critères de tri, du plus au moins important; vide: ordre des lignes
+    void setSort(const SortKeys &keys);
+    const SortKeys &sortKeys() const { return sorting; }
+
+    // Filtre ou tri en cours de calcul: les lignes affichées ne
+    // correspondent pas encore aux critères courants
+    bool isUpdating() const;
+
+    void setNomIndex(std::shared_ptr<const TrigramIndex> index) { nomIndex = std::move(index); }
+
+signals:
+    void viewUpdated(qint64 visibleRows, qint64 elapsedMs);
+
+private:
+    DataTableModel *source;
+    DataViewModel *proxy;
+    QTimer *filterDelay;
+    QString filterText;
+    QString categoryName;
+    CategoryIndex categories;
+    DateRange period;
+    DateIndex dates;
+    std::shared_ptr<const TrigramIndex> nomIndex;
+
+    std::shared_ptr<std::atomic<bool>> cancelToken;
+    std::vector<std::future<void>> jobs;
+    quint64 generation = 0;
+    bool running = false;
+
+    // Résultat du filtre texte seul (nul tant qu'il n'est pas calculé) et
+    // nombre de lignes de la source qu'il couvre
+    RowList textRows;
+    size_t coveredRows = 0;
+    // Données sur lesquelles textRows a été calculé, pour l'affinage
+    std::string lastQuery;
+    quint64 lastVersion = 0;
+
+    SortKeys sorting;
+    SortCache sortCache;
+    std::shared_ptr<std::atomic<bool>> sortToken;
+    quint64 sortGeneration = 0;
+    bool sortRunning = false;
+    // Tri demandé pendant un tri en cours, lancé à sa fin
+    bool sortPending = false;
+    // Incrémenté quand les lignes existantes changent (rechargement): les
+    // permutations calculées avant ne sont plus à garder
+    quint64 layoutStamp = 0;
+
+    // Suppression/insertion au milieu de la source en cours: l'état a été
+    // renuméroté, la vue est recomposée à la fin du signal de la source
+    bool restructured = false;
+    bool refreshAfterRestructure = false;
+
+    void onSourceReset();
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsErased(const std::vector<uint32_t> &rows);
+    void onRowsPlaced(const std::vector<uint32_t> &rows);
+    void onValuesChanged(const std::vector<uint32_t> &rows, int column, const ColumnRows &previous);
+    void finishRestructure();
+    void cancelSort();
+    // coalesce: un tri en cours n'est pas interrompu, il sera refait à sa fin
+    void publish(qint64 elapsedMs, bool coalesce = false);
+    // rows nul et allRows: toutes les lignes de la source
+    void present(RowList rows, bool allRows, qint64 elapsedMs, bool coalesce);
+    void orderRows(RowList rows, bool allRows, qint64 elapsedMs);
+    // Code de la catégorie courante, -1 si elle n'existe pas (encore)
+    int64_t categoryCode() const;
+    std::vector<uint32_t> restrictToCategory(const std::vector<uint32_t> &rows) const;
+    std::vector<uint32_t> restrictToPeriod(const std::vector<uint32_t> &rows) const;
+
+    void refresh();
+    void extendToNewRows();
+    void cancel();
+    void track(std::future<void> job);
+};
+
+#endif // DATAVIEW_H
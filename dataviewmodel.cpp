@@ -0,0 +1,272 @@
+// dataviewmodel.cpp
+#include "dataviewmodel.h"
+#include "rowremap.h"
+
+#include <algorithm>
+
+DataViewModel::DataViewModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+void DataViewModel::setSourceModel(QAbstractItemModel *model)
+{
+    beginResetModel();
+    if (sourceModel())
+        sourceModel()->disconnect(this);
+    QAbstractProxyModel::setSourceModel(model);
+    visibleRows.reset();
+    proxyRowOf.clear();
+    restricted = false;
+    ascending = true;
+    if (model) {
+        connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, &DataViewModel::sourceAboutToInsertRows);
+        connect(model, &QAbstractItemModel::rowsInserted, this, &DataViewModel::sourceRowsInserted);
+        connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &DataViewModel::sourceAboutToRemoveRows);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &DataViewModel::sourceRowsRemoved);
+        connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &DataViewModel::sourceAboutToReset);
+        connect(model, &QAbstractItemModel::modelReset, this, &DataViewModel::sourceReset);
+        connect(model, &QAbstractItemModel::dataChanged, this, &DataViewModel::sourceDataChanged);
+        connect(model, &QAbstractItemModel::columnsAboutToBeInserted, this, &DataViewModel::sourceAboutToInsertColumns);
+        connect(model, &QAbstractItemModel::columnsInserted, this, &DataViewModel::endInsertColumns);
+        connect(model, &QAbstractItemModel::columnsAboutToBeRemoved, this, &DataViewModel::sourceAboutToRemoveColumns);
+        connect(model, &QAbstractItemModel::columnsRemoved, this, &DataViewModel::endRemoveColumns);
+    }
+    endResetModel();
+}
+
+QModelIndex DataViewModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel())
+        return QModelIndex();
+    const int row = restricted ? int((*visibleRows)[size_t(proxyIndex.row())]) : proxyIndex.row();
+    return sourceModel()->index(row, proxyIndex.column());
+}
+
+QModelIndex DataViewModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid())
+        return QModelIndex();
+    if (!restricted)
+        return index(sourceIndex.row(), sourceIndex.column());
+
+    const std::vector<uint32_t> &rows = *visibleRows;
+    const uint32_t sourceRow = uint32_t(sourceIndex.row());
+    if (ascending) {
+        auto it = std::lower_bound(rows.begin(), rows.end(), sourceRow);
+        if (it == rows.end() || *it != sourceRow)
+            return QModelIndex();
+        return index(int(it - rows.begin()), sourceIndex.column());
+    }
+
+    if (proxyRowOf.empty()) {
+        proxyRowOf.assign(size_t(sourceModel()->rowCount()), -1);
+        for (size_t i = 0; i < rows.size(); ++i)
+            proxyRowOf[rows[i]] = int32_t(i);
+    }
+    if (sourceRow >= proxyRowOf.size() || proxyRowOf[sourceRow] < 0)
+        return QModelIndex();
+    return index(proxyRowOf[sourceRow], sourceIndex.column());
+}
+
+QModelIndex DataViewModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex DataViewModel::parent(const QModelIndex &) const
+{
+    return QModelIndex();
+}
+
+int DataViewModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel())
+        return 0;
+    return restricted ? int(visibleRows->size()) : sourceModel()->rowCount();
+}
+
+int DataViewModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel())
+        return 0;
+    return sourceModel()->columnCount();
+}
+
+void DataViewModel::sort(int column, Qt::SortOrder order)
+{
+    emit sortRequested(column, order);
+}
+
+void DataViewModel::showAllRows()
+{
+    if (!restricted)
+        return;
+    beginResetModel();
+    visibleRows.reset();
+    std::vector<int32_t>().swap(proxyRowOf);
+    restricted = false;
+    ascending = true;
+    endResetModel();
+}
+
+void DataViewModel::setRows(RowList rows, bool sorted)
+{
+    beginResetModel();
+    if (!rows)
+        rows = std::make_shared<std::vector<uint32_t>>();
+    visibleRows = std::move(rows);
+    std::vector<int32_t>().swap(proxyRowOf);
+    ascending = sorted;
+    restricted = true;
+    endResetModel();
+}
+
+void DataViewModel::appendRows(const std::vector<uint32_t> &rows)
+{
+    if (!restricted || rows.empty())
+        return;
+    const int first = int(visibleRows->size());
+    beginInsertRows(QModelIndex(), first, first + int(rows.size()) - 1);
+    if (ascending && !visibleRows->empty() && rows.front() <= visibleRows->back())
+        ascending = false;
+    ascending = ascending && std::is_sorted(rows.begin(), rows.end());
+    appendTo(visibleRows, rows);
+    std::vector<int32_t>().swap(proxyRowOf);
+    endInsertRows();
+}
+
+void DataViewModel::appendTo(RowList &list, const std::vector<uint32_t> &rows)
+{
+    if (list && list.use_count() == 1) {
+        // Seul détenteur: ajout sur place (les listes ne sont jamais créées const)
+        auto &owned = const_cast<std::vector<uint32_t> &>(*list);
+        owned.insert(owned.end(), rows.begin(), rows.end());
+        return;
+    }
+    // Liste partagée (index de catégories, calcul en cours...): copie avant ajout
+    auto extended = std::make_shared<std::vector<uint32_t>>();
+    if (list) {
+        extended->reserve(list->size() + rows.size());
+        extended->assign(list->begin(), list->end());
+    }
+    extended->insert(extended->end(), rows.begin(), rows.end());
+    list = std::move(extended);
+}
+
+void DataViewModel::remapRemoved(const std::vector<uint32_t> &rows)
+{
+    keepRows = true;
+    if (restricted) {
+        beginRemap();
+        visibleRows = std::make_shared<std::vector<uint32_t>>(rowsAfterRemoval(*visibleRows, rows));
+        std::vector<int32_t>().swap(proxyRowOf);
+    }
+}
+
+void DataViewModel::remapInserted(const std::vector<uint32_t> &positions)
+{
+    keepRows = true;
+    if (restricted) {
+        beginRemap();
+        visibleRows = std::make_shared<std::vector<uint32_t>>(rowsAfterInsertion(*visibleRows, positions));
+        std::vector<int32_t>().swap(proxyRowOf);
+    }
+}
+
+void DataViewModel::beginRemap()
+{
+    // Déjà commencée par la source (remise à zéro) ou une plage précédente
+    if (resetting)
+        return;
+    resetting = true;
+    beginResetModel();
+}
+
+void DataViewModel::endRemap()
+{
+    keepRows = false;
+    if (!resetting)
+        return;
+    resetting = false;
+    endResetModel();
+}
+
+void DataViewModel::sourceAboutToInsertRows(const QModelIndex &parent, int first, int last)
+{
+    if (!restricted)
+        beginInsertRows(parent, first, last);
+    else if (first < sourceModel()->rowCount())
+        beginRemap();   // insertion au milieu: les numéros de la liste vont changer
+    // Ajout en fin de vue restreinte: les lignes n'apparaissent qu'après évaluation
+}
+
+void DataViewModel::sourceRowsInserted()
+{
+    // Vue restreinte: la remise à zéro se termine par endRemap()
+    if (!restricted)
+        endInsertRows();
+}
+
+void DataViewModel::sourceAboutToRemoveRows(const QModelIndex &parent, int first, int last)
+{
+    if (!restricted)
+        beginRemoveRows(parent, first, last);
+    else
+        beginRemap();
+}
+
+void DataViewModel::sourceRowsRemoved()
+{
+    if (!restricted)
+        endRemoveRows();
+}
+
+void DataViewModel::sourceAboutToReset()
+{
+    resetting = true;
+    beginResetModel();
+}
+
+void DataViewModel::sourceReset()
+{
+    resetting = false;
+    if (keepRows) {
+        // Suppression ou insertion en trop de plages: la liste a été renumérotée
+        keepRows = false;
+        endResetModel();
+        return;
+    }
+    // Les numéros de lignes ne désignent plus les mêmes données
+    visibleRows.reset();
+    std::vector<int32_t>().swap(proxyRowOf);
+    restricted = false;
+    ascending = true;
+    endResetModel();
+}
+
+void DataViewModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                      const QList<int> &roles)
+{
+    if (!restricted) {
+        emit dataChanged(index(topLeft.row(), topLeft.column()),
+                         index(bottomRight.row(), bottomRight.column()), roles);
+        return;
+    }
+    if (!visibleRows->empty()) {
+        emit dataChanged(index(0, topLeft.column()),
+                         index(int(visibleRows->size()) - 1, bottomRight.column()), roles);
+    }
+}
+
+void DataViewModel::sourceAboutToInsertColumns(const QModelIndex &, int first, int last)
+{
+    beginInsertColumns(QModelIndex(), first, last);
+}
+
+void DataViewModel::sourceAboutToRemoveColumns(const QModelIndex &, int first, int last)
+{
+    beginRemoveColumns(QModelIndex(), first, last);
+}
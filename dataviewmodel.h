@@ -0,0 +1,87 @@
+// dataviewmodel.h
+#ifndef DATAVIEWMODEL_H
+#define DATAVIEWMODEL_H
+
+#include <QAbstractProxyModel>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Vue sur le modèle de données: sans filtre, les lignes de la source dans
+// leur ordre; sinon, une liste de numéros de lignes de la source calculée
+// ailleurs (filtre, tri...) et partagée: changer de liste ne copie rien.
+class DataViewModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit DataViewModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *model) override;
+
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    // Le tri est calculé ailleurs (DataView): la demande est transmise
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    using RowList = std::shared_ptr<const std::vector<uint32_t>>;
+
+    bool isRestricted() const { return restricted; }
+    // Lignes affichées quand la vue est restreinte
+    const RowList &rows() const { return visibleRows; }
+
+    // Retour à toutes les lignes de la source
+    void showAllRows();
+    // Lignes de la source à afficher, dans l'ordre d'affichage; ascending
+    // indique qu'elles sont triées par numéro (recherche inverse directe)
+    void setRows(RowList rows, bool ascending);
+    // Ajoute des lignes en fin de vue restreinte (données arrivées depuis)
+    void appendRows(const std::vector<uint32_t> &rows);
+
+    // Renumérote la vue restreinte pendant une suppression ou une insertion
+    // au milieu de la source (à appeler avant ses signaux de plages). La vue
+    // restreinte reste en remise à zéro, quel que soit le nombre de plages,
+    // jusqu'à endRemap() (après le dernier signal de la source).
+    void remapRemoved(const std::vector<uint32_t> &rows);
+    void remapInserted(const std::vector<uint32_t> &positions);
+    void endRemap();
+
+    // Ajoute rows à list, sur place si list n'est pas partagée
+    static void appendTo(RowList &list, const std::vector<uint32_t> &rows);
+
+signals:
+    void sortRequested(int column, Qt::SortOrder order);
+
+private:
+    RowList visibleRows;
+    bool restricted = false;
+    bool ascending = true;
+    // Remise à zéro en cours (source remise à zéro ou renumérotée)
+    bool resetting = false;
+    // La remise à zéro de la source garde la liste renumérotée
+    bool keepRows = false;
+
+    // Correspondance inverse, construite à la demande si l'ordre n'est pas croissant
+    mutable std::vector<int32_t> proxyRowOf;
+
+    void beginRemap();
+
+    void sourceAboutToInsertRows(const QModelIndex &parent, int first, int last);
+    void sourceRowsInserted();
+    void sourceAboutToRemoveRows(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved();
+    void sourceAboutToReset();
+    void sourceReset();
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                           const QList<int> &roles);
+    // Colonnes calculées ajoutées ou retirées: mêmes lignes
+    void sourceAboutToInsertColumns(const QModelIndex &parent, int first, int last);
+    void sourceAboutToRemoveColumns(const QModelIndex &parent, int first, int last);
+};
+
+#endif // DATAVIEWMODEL_H
@@ -0,0 +1,170 @@
+// dateindex.cpp
+#include "dateindex.h"
+#include "parallel.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Une zone ne chevauche jamais deux blocs: ses dates sont contiguës
+static_assert(BlockVector<int32_t>::BlockSize % DateIndex::ZoneRows == 0,
+              "une zone doit tenir dans un bloc");
+
+// Zones traitées par une même tâche
+constexpr size_t ZonesPerSlice = 16;
+
+const int32_t *zoneDates(const BlockVector<int32_t> &dates, size_t first)
+{
+    return dates.blockData(first >> BlockVector<int32_t>::BlockShift) + (first & BlockVector<int32_t>::BlockMask);
+}
+
+} // namespace
+
+void DateIndex::rebuild(const BlockVector<int32_t> &dates)
+{
+    computeZones(dates, 0);
+}
+
+void DateIndex::computeZones(const BlockVector<int32_t> &dates, size_t firstZone)
+{
+    const size_t rows = dates.size();
+    zones.resize((rows + ZoneRows - 1) >> ZoneShift);
+    if (firstZone >= zones.size())
+        return;
+    parallelFor(zones.size() - firstZone, ZonesPerSlice, [&](size_t first, size_t last) {
+        for (size_t zone = firstZone + first; zone < firstZone + last; ++zone) {
+            const size_t begin = zone << ZoneShift;
+            const int32_t *values = zoneDates(dates, begin);
+            const auto [low, high] = std::minmax_element(values, values + std::min(ZoneRows, rows - begin));
+            zones[zone] = {*low, *high};
+        }
+    });
+}
+
+void DateIndex::removeRows(const BlockVector<int32_t> &dates, const std::vector<uint32_t> &rows)
+{
+    if (!rows.empty())
+        computeZones(dates, rows.front() >> ZoneShift);
+}
+
+void DateIndex::insertRows(const BlockVector<int32_t> &dates, const std::vector<uint32_t> &rows)
+{
+    if (!rows.empty())
+        computeZones(dates, rows.front() >> ZoneShift);
+}
+
+void DateIndex::appendRows(const BlockVector<int32_t> &dates, size_t first, size_t last)
+{
+    for (size_t row = first; row < last; ++row) {
+        const int32_t date = dates[row];
+        const size_t zone = row >> ZoneShift;
+        if (zone >= zones.size()) {
+            zones.push_back({date, date});
+        } else {
+            zones[zone].min = std::min(zones[zone].min, date);
+            zones[zone].max = std::max(zones[zone].max, date);
+        }
+    }
+}
+
+void DateIndex::updateRow(uint32_t row, int32_t date)
+{
+    const size_t zone = row >> ZoneShift;
+    if (zone >= zones.size())
+        return;
+    zones[zone].min = std::min(zones[zone].min, date);
+    zones[zone].max = std::max(zones[zone].max, date);
+}
+
+void DateIndex::clear()
+{
+    std::vector<Zone>().swap(zones);
+}
+
+DateIndex::Overlap DateIndex::overlap(size_t zone, const DateRange &range) const
+{
+    const Zone &bounds = zones[zone];
+    if (bounds.max < range.from || bounds.min > range.to)
+        return Overlap::None;
+    if (bounds.min >= range.from && bounds.max <= range.to)
+        return Overlap::Full;
+    return Overlap::Partial;
+}
+
+std::vector<uint32_t> DateIndex::select(const BlockVector<int32_t> &dates, const DateRange &range) const
+{
+    PROFILE_SCOPE_AS(scope, "Période: zones");
+    std::vector<uint32_t> rows;
+    if (!range.isValid())
+        return rows;
+
+    // Zones à retenir: la liste est courte, le parcours des bornes ne coûte
+    // qu'une comparaison par zone
+    std::vector<uint32_t> selected;
+    for (size_t zone = 0; zone < zones.size(); ++zone) {
+        if (overlap(zone, range) != Overlap::None)
+            selected.push_back(uint32_t(zone));
+    }
+
+    // Chaque tranche de zones produit ses lignes, raccordées dans l'ordre
+    const size_t total = dates.size();
+    const size_t sliceCount = (selected.size() + ZonesPerSlice - 1) / ZonesPerSlice;
+    std::vector<std::vector<uint32_t>> parts(sliceCount);
+    parallelFor(sliceCount, 1, [&](size_t first, size_t last) {
+        for (size_t slice = first; slice < last; ++slice) {
+            std::vector<uint32_t> &part = parts[slice];
+            const size_t end = std::min((slice + 1) * ZonesPerSlice, selected.size());
+            for (size_t i = slice * ZonesPerSlice; i < end; ++i) {
+                const size_t zone = selected[i];
+                const size_t begin = zone << ZoneShift;
+                const size_t length = std::min(ZoneRows, total - begin);
+                if (overlap(zone, range) == Overlap::Full) {
+                    const size_t offset = part.size();
+                    part.resize(offset + length);
+                    std::iota(part.begin() + offset, part.end(), uint32_t(begin));
+                    continue;
+                }
+                const int32_t *values = zoneDates(dates, begin);
+                for (size_t j = 0; j < length; ++j) {
+                    if (range.contains(values[j]))
+                        part.push_back(uint32_t(begin + j));
+                }
+            }
+        }
+    });
+
+    size_t count = 0;
+    for (const auto &part : parts)
+        count += part.size();
+    rows.reserve(count);
+    for (const auto &part : parts)
+        rows.insert(rows.end(), part.begin(), part.end());
+    scope.addItems(count);
+    return rows;
+}
+
+void DateIndex::restrict(const BlockVector<int32_t> &dates, const uint32_t *rows, size_t count,
+                         const DateRange &range, std::vector<uint32_t> &out) const
+{
+    if (!range.isValid())
+        return;
+    size_t i = 0;
+    while (i < count) {
+        const size_t zone = rows[i] >> ZoneShift;
+        // Fin des lignes de cette zone
+        const uint32_t next = uint32_t((zone + 1) << ZoneShift);
+        const size_t end = size_t(std::lower_bound(rows + i, rows + count, next) - rows);
+        const Overlap kind = zone < zones.size() ? overlap(zone, range) : Overlap::Partial;
+        if (kind == Overlap::Full) {
+            out.insert(out.end(), rows + i, rows + end);
+        } else if (kind == Overlap::Partial) {
+            for (size_t j = i; j < end; ++j) {
+                if (range.contains(dates[rows[j]]))
+                    out.push_back(rows[j]);
+            }
+        }
+        i = end;
+    }
+}
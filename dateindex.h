@@ -0,0 +1,75 @@
+// dateindex.h
+#ifndef DATEINDEX_H
+#define DATEINDEX_H
+
+#include "blockvector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Période [from, to] en jours depuis le 1970-01-01, bornes comprises.
+// Par défaut vide: pas de filtre sur la date.
+struct DateRange
+{
+    int32_t from = 0;
+    int32_t to = -1;
+
+    bool isValid() const { return from <= to; }
+    bool contains(int32_t date) const { return date >= from && date <= to; }
+
+    bool operator==(const DateRange &other) const { return from == other.from && to == other.to; }
+    bool operator!=(const DateRange &other) const { return !(*this == other); }
+};
+
+// Carte de zones de la colonne Date: plus petite et plus grande date de
+// chaque zone de ZoneRows lignes consécutives. Une requête sur une période
+// écarte ou retient les zones entières d'après ces bornes et ne lit les
+// dates que des zones à cheval sur une limite: sur des données rangées à peu
+// près par date, seules une ou deux zones sont parcourues. Les bornes restent
+// sûres quand une date change (la zone est élargie), elles ne sont
+// resserrées qu'à la reconstruction.
+class DateIndex
+{
+public:
+    static constexpr size_t ZoneShift = 12;
+    static constexpr size_t ZoneRows = size_t(1) << ZoneShift;
+
+    // Reconstruction complète, en parallèle par zones
+    void rebuild(const BlockVector<int32_t> &dates);
+    // Lignes [first, last) ajoutées en fin de tableau
+    void appendRows(const BlockVector<int32_t> &dates, size_t first, size_t last);
+    // Lignes supprimées ou insérées au milieu du tableau (triées; positions
+    // finales pour l'insertion): seules les zones à partir de la première
+    // ligne concernée sont recalculées, dates déjà à jour
+    void removeRows(const BlockVector<int32_t> &dates, const std::vector<uint32_t> &rows);
+    void insertRows(const BlockVector<int32_t> &dates, const std::vector<uint32_t> &rows);
+    void updateRow(uint32_t row, int32_t date);
+    void clear();
+
+    // Lignes dont la date est dans la période, dans l'ordre croissant
+    std::vector<uint32_t> select(const BlockVector<int32_t> &dates, const DateRange &range) const;
+    // Ajoute à out les lignes de rows (triées) dont la date est dans la période
+    void restrict(const BlockVector<int32_t> &dates, const uint32_t *rows, size_t count,
+                  const DateRange &range, std::vector<uint32_t> &out) const;
+
+    size_t zoneCount() const { return zones.size(); }
+    size_t memoryUsage() const { return zones.capacity() * sizeof(Zone); }
+
+private:
+    struct Zone
+    {
+        int32_t min;
+        int32_t max;
+    };
+
+    enum class Overlap { None, Partial, Full };
+
+    std::vector<Zone> zones;
+
+    Overlap overlap(size_t zone, const DateRange &range) const;
+    // Bornes des zones à partir de firstZone, d'après les dates
+    void computeZones(const BlockVector<int32_t> &dates, size_t firstZone);
+};
+
+#endif // DATEINDEX_H
@@ -0,0 +1,579 @@
+// datfile.cpp
+#include "datfile.h"
+#include "parallel.h"
+#include "profiler.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char Magic[8] = {'I', 'Q', 'T', 'D', 'A', 'T', 'A', '\0'};
+constexpr quint32 FormatVersion = 1;
+constexpr qint64 Alignment = 64;
+// Blocs compressés ensemble sur tous les cœurs avant d'être écrits dans l'ordre
+constexpr size_t CompressWindow = 16;
+
+enum ColumnKind : quint32 {
+    IdColumn,
+    NomColumn,
+    TypeColumn,
+    DateColumn,
+    StatutColumn,
+    ValeurColumn,
+    NomDictionary,
+    TypeDictionary,
+    StatutDictionary,
+    KindCount
+};
+
+struct FileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 columnCount;
+    quint64 rowCount;
+    quint32 blockRows;
+    quint32 flags;
+    quint64 directoryOffset;
+    quint64 directorySize;
+    char reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64, "en-tête .dat de 64 octets");
+
+struct ColumnEntry
+{
+    quint32 kind;
+    quint32 blockCount;
+};
+
+struct BlockEntry
+{
+    quint64 offset;
+    quint64 storedSize;
+    quint64 rawSize;
+    quint32 itemCount;
+    quint32 codec;
+};
+static_assert(sizeof(BlockEntry) == 32, "entrée de bloc de 32 octets");
+
+void setError(QString *errorMessage, const QString &message)
+{
+    if (errorMessage)
+        *errorMessage = message;
+}
+
+// Écriture séquentielle des blocs et construction du répertoire
+class BlockWriter
+{
+public:
+    BlockWriter(QSaveFile &file, DatFile::Compression compression,
+                const DatFile::Progress &progress, qint64 blockTotal)
+        : file(file), compression(compression), progress(progress), blockTotal(blockTotal) {}
+
+    bool isCancelled() const { return cancelled; }
+
+    void beginColumn(quint32 kind, size_t blockCount)
+    {
+        ColumnEntry entry{kind, quint32(blockCount)};
+        directory.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+
+    bool writeBlock(const char *data, qint64 size, size_t items, const QByteArray *packed = nullptr)
+    {
+        if (!storeBlock(data, size, items, packed))
+            return false;
+        if (progress && !progress(++blocksDone, blockTotal)) {
+            cancelled = true;
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool writeColumn(quint32 kind, const BlockVector<T> &column)
+    {
+        beginColumn(kind, column.blockCount());
+        if (compression != DatFile::Zlib) {
+            for (size_t b = 0; b < column.blockCount(); ++b) {
+                const size_t length = column.blockLength(b);
+                if (!writeBlock(reinterpret_cast<const char *>(column.blockData(b)),
+                                qint64(length * sizeof(T)), length))
+                    return false;
+            }
+            return true;
+        }
+
+        // La compression domine: elle se fait par fenêtres de blocs en
+        // parallèle, l'écriture reste séquentielle et dans l'ordre
+        std::vector<QByteArray> packed(CompressWindow);
+        for (size_t first = 0; first < column.blockCount(); first += CompressWindow) {
+            const size_t last = std::min(first + CompressWindow, column.blockCount());
+            parallelFor(last - first, 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const size_t b = first + i;
+                    packed[i] = qCompress(reinterpret_cast<const uchar *>(column.blockData(b)),
+                                          qsizetype(column.blockLength(b) * sizeof(T)), 1);
+                }
+            });
+            for (size_t b = first; b < last; ++b) {
+                const size_t length = column.blockLength(b);
+                if (!writeBlock(reinterpret_cast<const char *>(column.blockData(b)),
+                                qint64(length * sizeof(T)), length, &packed[b - first]))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool writeDictionary(quint32 kind, const StringColumn &values)
+    {
+        beginColumn(kind, values.segmentCount());
+        QByteArray raw;
+        for (size_t s = 0; s < values.segmentCount(); ++s) {
+            const size_t length = values.segmentLength(s);
+            const uint32_t *ends = values.segmentEnds(s);
+            const qsizetype endsSize = qsizetype(length * sizeof(uint32_t));
+            const qsizetype bytesSize = length ? qsizetype(ends[length - 1]) : 0;
+            raw.resize(endsSize + bytesSize);
+            std::memcpy(raw.data(), ends, size_t(endsSize));
+            std::memcpy(raw.data() + endsSize, values.segmentBytes(s), size_t(bytesSize));
+            if (!writeBlock(raw.constData(), raw.size(), length))
+                return false;
+        }
+        return true;
+    }
+
+    const QByteArray &directoryData() const { return directory; }
+
+private:
+    QSaveFile &file;
+    DatFile::Compression compression;
+    const DatFile::Progress &progress;
+    qint64 blockTotal;
+    qint64 blocksDone = 0;
+    bool cancelled = false;
+    QByteArray directory;
+
+    // packed: bloc déjà compressé (zlib), sinon compressé ici au besoin
+    bool storeBlock(const char *data, qint64 size, size_t items, const QByteArray *packed)
+    {
+        static const char padding[Alignment] = {};
+        const qint64 misalignment = file.pos() % Alignment;
+        if (misalignment && file.write(padding, Alignment - misalignment) != Alignment - misalignment)
+            return false;
+
+        BlockEntry entry{quint64(file.pos()), quint64(size), quint64(size), quint32(items), DatFile::NoCompression};
+        if (compression == DatFile::Zlib && size > 0) {
+            const QByteArray compressed = packed ? *packed
+                                                 : qCompress(reinterpret_cast<const uchar *>(data), qsizetype(size), 1);
+            if (compressed.size() < size) {
+                entry.storedSize = quint64(compressed.size());
+                entry.codec = DatFile::Zlib;
+                if (file.write(compressed) != compressed.size())
+                    return false;
+                directory.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+                return true;
+            }
+        }
+        if (file.write(data, size) != size)
+            return false;
+        directory.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        return true;
+    }
+};
+
+// Lecture du répertoire et rattachement des blocs à la projection mémoire
+class BlockReader
+{
+public:
+    BlockReader(const char *base, qint64 size, std::shared_ptr<const void> backing)
+        : base(base), size(size), backing(std::move(backing)) {}
+
+    QString error;
+
+    // Renvoie les octets bruts d'un bloc, décompressés au besoin
+    const char *payload(const BlockEntry &entry, std::shared_ptr<const void> &owner)
+    {
+        if (entry.offset > quint64(size) || entry.storedSize > quint64(size) - entry.offset) {
+            error = "bloc hors du fichier";
+            return nullptr;
+        }
+        const char *stored = base + entry.offset;
+        if (entry.codec == DatFile::NoCompression) {
+            if (entry.storedSize != entry.rawSize) {
+                error = "taille de bloc incohérente";
+                return nullptr;
+            }
+            owner = backing;
+            return stored;
+        }
+        if (entry.codec == DatFile::Zlib) {
+            auto unpacked = std::make_shared<QByteArray>(
+                qUncompress(reinterpret_cast<const uchar *>(stored), qsizetype(entry.storedSize)));
+            if (quint64(unpacked->size()) != entry.rawSize) {
+                error = "bloc compressé invalide";
+                return nullptr;
+            }
+            owner = unpacked;
+            return unpacked->constData();
+        }
+        error = QString("codec inconnu (%1)").arg(entry.codec);
+        return nullptr;
+    }
+
+    template <typename T>
+    bool readColumn(const BlockEntry *entries, quint32 blockCount, BlockVector<T> &column)
+    {
+        for (quint32 b = 0; b < blockCount; ++b) {
+            const BlockEntry &entry = entries[b];
+            // BlockVector (et les lectures par bloc de la synthèse) supposent
+            // tous les blocs pleins sauf le dernier, qui n'est pas vide
+            if (entry.rawSize != quint64(entry.itemCount) * sizeof(T) || entry.itemCount > BlockVector<T>::BlockSize
+                || entry.itemCount == 0 || (b + 1 < blockCount && entry.itemCount != BlockVector<T>::BlockSize)) {
+                error = "bloc de colonne invalide";
+                return false;
+            }
+            std::shared_ptr<const void> owner;
+            const char *data = payload(entry, owner);
+            if (!data)
+                return false;
+            column.adoptBlock(reinterpret_cast<const T *>(data), entry.itemCount, std::move(owner));
+        }
+        return true;
+    }
+
+    bool readDictionary(const BlockEntry *entries, quint32 blockCount, StringColumn &values)
+    {
+        for (quint32 b = 0; b < blockCount; ++b) {
+            const BlockEntry &entry = entries[b];
+            const quint64 endsSize = quint64(entry.itemCount) * sizeof(uint32_t);
+            if (entry.rawSize < endsSize || entry.itemCount > StringColumn::SegmentSize || entry.itemCount == 0
+                || (b + 1 < blockCount && entry.itemCount != StringColumn::SegmentSize)) {
+                error = "segment de dictionnaire invalide";
+                return false;
+            }
+            std::shared_ptr<const void> owner;
+            const char *data = payload(entry, owner);
+            if (!data)
+                return false;
+            const uint32_t *ends = reinterpret_cast<const uint32_t *>(data);
+            // Contrôle par valeur distincte (pas par ligne): les fins doivent croître
+            uint32_t previous = 0;
+            for (quint32 i = 0; i < entry.itemCount; ++i) {
+                if (ends[i] < previous) {
+                    error = "segment de dictionnaire invalide";
+                    return false;
+                }
+                previous = ends[i];
+            }
+            if (endsSize + previous != entry.rawSize) {
+                error = "segment de dictionnaire invalide";
+                return false;
+            }
+            values.adoptSegment(ends, data + endsSize, entry.itemCount, std::move(owner));
+        }
+        return true;
+    }
+
+private:
+    const char *base;
+    qint64 size;
+    std::shared_ptr<const void> backing;
+};
+
+// Fichiers actuellement projetés (propriétaires des blocs chargés sans
+// copie). Seules leurs pages peuvent être rendues au système: un bloc
+// emprunté à une autre mémoire (bloc décompressé, lecture sans projection)
+// serait perdu.
+class MappedFiles
+{
+public:
+    static MappedFiles &instance()
+    {
+        static MappedFiles files;
+        return files;
+    }
+
+    void add(const void *owner)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        owners.insert(owner);
+    }
+
+    void remove(const void *owner)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        owners.erase(owner);
+    }
+
+    bool contains(const void *owner) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return owner && owners.count(owner) > 0;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_set<const void *> owners;
+};
+
+// Pages entièrement comprises dans [data, data + bytes)
+size_t releaseRange(const void *data, size_t bytes)
+{
+#ifdef Q_OS_UNIX
+    const uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (uintptr_t(data) + page - 1) & ~(page - 1);
+    const uintptr_t end = (uintptr_t(data) + bytes) & ~(page - 1);
+    if (end > begin)
+        madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
+#else
+    Q_UNUSED(data);
+#endif
+    return bytes;
+}
+
+template <typename T>
+size_t releaseColumn(const MappedFiles &files, const BlockVector<T> &column)
+{
+    size_t bytes = 0;
+    for (size_t b = 0; b < column.blockCount(); ++b) {
+        if (files.contains(column.blockOwner(b)))
+            bytes += releaseRange(column.blockData(b), column.blockLength(b) * sizeof(T));
+    }
+    return bytes;
+}
+
+size_t releaseDictionary(const MappedFiles &files, const StringColumn &values)
+{
+    size_t bytes = 0;
+    for (size_t s = 0; s < values.segmentCount(); ++s) {
+        const size_t length = values.segmentLength(s);
+        if (length == 0 || !files.contains(values.segmentOwner(s)))
+            continue;
+        // Fins de chaîne puis octets, contigus dans le fichier
+        const uint32_t *ends = values.segmentEnds(s);
+        bytes += releaseRange(ends, length * sizeof(uint32_t) + ends[length - 1]);
+    }
+    return bytes;
+}
+
+// Vérifie que tous les codes d'une colonne désignent une entrée du dictionnaire
+bool codesValid(const BlockVector<uint32_t> &codes, size_t dictionarySize)
+{
+    for (size_t b = 0; b < codes.blockCount(); ++b) {
+        const uint32_t *data = codes.blockData(b);
+        const size_t length = codes.blockLength(b);
+        uint32_t maximum = 0;
+        for (size_t i = 0; i < length; ++i)
+            maximum = data[i] > maximum ? data[i] : maximum;
+        if (length && maximum >= dictionarySize)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool DatFile::isDatFile(const QByteArray &head)
+{
+    return head.size() >= qsizetype(sizeof(Magic))
+        && std::memcmp(head.constData(), Magic, sizeof(Magic)) == 0;
+}
+
+bool DatFile::save(const ColumnTable &table, const QString &fileName,
+                   Compression compression, QString *errorMessage, const Progress &progress)
+{
+    PROFILE_SCOPE_AS(scope, "Sauvegarde .dat");
+    scope.addItems(table.rowCount());
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    setError(errorMessage, "Format .dat non pris en charge sur cette architecture");
+    return false;
+#endif
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = FormatVersion;
+    header.columnCount = KindCount;
+    header.rowCount = table.rowCount();
+    header.blockRows = quint32(BlockVector<int64_t>::BlockSize);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    const qint64 blockTotal = qint64(table.ids.blockCount() + table.noms.blockCount() + table.types.blockCount()
+                                     + table.dates.blockCount() + table.statuts.blockCount()
+                                     + table.valeurs.blockCount() + table.nomValues.segmentCount()
+                                     + table.typeValues.segmentCount() + table.statutValues.segmentCount());
+    BlockWriter writer(file, compression, progress, blockTotal);
+    bool ok = writer.writeColumn(IdColumn, table.ids)
+        && writer.writeColumn(NomColumn, table.noms)
+        && writer.writeColumn(TypeColumn, table.types)
+        && writer.writeColumn(DateColumn, table.dates)
+        && writer.writeColumn(StatutColumn, table.statuts)
+        && writer.writeColumn(ValeurColumn, table.valeurs)
+        && writer.writeDictionary(NomDictionary, table.nomValues)
+        && writer.writeDictionary(TypeDictionary, table.typeValues)
+        && writer.writeDictionary(StatutDictionary, table.statutValues);
+
+    if (ok) {
+        header.directoryOffset = quint64(file.pos());
+        header.directorySize = quint64(writer.directoryData().size());
+        ok = file.write(writer.directoryData()) == writer.directoryData().size()
+            && file.seek(0)
+            && file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == qint64(sizeof(header));
+    }
+    if (!ok || !file.commit()) {
+        setError(errorMessage, writer.isCancelled() ? QString("Sauvegarde annulée") : file.errorString());
+        file.cancelWriting();
+        return false;
+    }
+    return true;
+}
+
+bool DatFile::load(const QString &fileName, ColumnTable &table, QString *errorMessage, bool verifyCodes)
+{
+    PROFILE_SCOPE_AS(scope, "Chargement .dat");
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    setError(errorMessage, "Format .dat non pris en charge sur cette architecture");
+    return false;
+#endif
+    // Le QFile garde la projection en vie: il est détruit avec le dernier bloc
+    std::shared_ptr<QFile> file(new QFile(fileName), [](QFile *mapped) {
+        MappedFiles::instance().remove(mapped);
+        delete mapped;
+    });
+    if (!file->open(QIODevice::ReadOnly)) {
+        setError(errorMessage, file->errorString());
+        return false;
+    }
+    const qint64 size = file->size();
+    if (size < qint64(sizeof(FileHeader))) {
+        setError(errorMessage, "Fichier .dat tronqué");
+        return false;
+    }
+
+    std::shared_ptr<const void> backing = file;
+    const char *base = reinterpret_cast<const char *>(file->map(0, size));
+    if (!base) {
+        // Projection impossible: lecture complète en mémoire
+        auto contents = std::make_shared<QByteArray>(file->readAll());
+        base = contents->constData();
+        backing = contents;
+    } else {
+        MappedFiles::instance().add(file.get());
+    }
+
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+        setError(errorMessage, "Ce fichier n'est pas au format .dat");
+        return false;
+    }
+    if (header.version != FormatVersion) {
+        setError(errorMessage, QString("Version de format .dat non prise en charge (%1)").arg(header.version));
+        return false;
+    }
+    if (header.blockRows != BlockVector<int64_t>::BlockSize || header.columnCount != KindCount
+        || header.directoryOffset > quint64(size) || header.directorySize > quint64(size) - header.directoryOffset) {
+        setError(errorMessage, "En-tête .dat invalide");
+        return false;
+    }
+
+    ColumnTable loaded;
+    BlockReader reader(base, size, backing);
+    const char *cursor = base + header.directoryOffset;
+    const char *directoryEnd = cursor + header.directorySize;
+    // Chaque sorte de colonne une fois et une seule: une colonne lue deux
+    // fois mettrait bout à bout deux suites de blocs
+    std::array<bool, KindCount> seen{};
+    for (quint32 c = 0; c < header.columnCount; ++c) {
+        ColumnEntry column;
+        if (directoryEnd - cursor < qint64(sizeof(column))) {
+            setError(errorMessage, "Répertoire .dat tronqué");
+            return false;
+        }
+        std::memcpy(&column, cursor, sizeof(column));
+        cursor += sizeof(column);
+        if (column.kind < KindCount && seen[column.kind]) {
+            setError(errorMessage, QString("Fichier .dat corrompu: colonne en double (%1)").arg(column.kind));
+            return false;
+        }
+        if (column.kind < KindCount)
+            seen[column.kind] = true;
+        if (quint64(directoryEnd - cursor) < quint64(column.blockCount) * sizeof(BlockEntry)) {
+            setError(errorMessage, "Répertoire .dat tronqué");
+            return false;
+        }
+        std::vector<BlockEntry> entries(column.blockCount);
+        std::memcpy(entries.data(), cursor, entries.size() * sizeof(BlockEntry));
+        cursor += entries.size() * sizeof(BlockEntry);
+
+        bool ok = false;
+        switch (column.kind) {
+        case IdColumn: ok = reader.readColumn(entries.data(), column.blockCount, loaded.ids); break;
+        case NomColumn: ok = reader.readColumn(entries.data(), column.blockCount, loaded.noms); break;
+        case TypeColumn: ok = reader.readColumn(entries.data(), column.blockCount, loaded.types); break;
+        case DateColumn: ok = reader.readColumn(entries.data(), column.blockCount, loaded.dates); break;
+        case StatutColumn: ok = reader.readColumn(entries.data(), column.blockCount, loaded.statuts); break;
+        case ValeurColumn: ok = reader.readColumn(entries.data(), column.blockCount, loaded.valeurs); break;
+        case NomDictionary: ok = reader.readDictionary(entries.data(), column.blockCount, loaded.nomValues); break;
+        case TypeDictionary: ok = reader.readDictionary(entries.data(), column.blockCount, loaded.typeValues); break;
+        case StatutDictionary: ok = reader.readDictionary(entries.data(), column.blockCount, loaded.statutValues); break;
+        default: reader.error = QString("colonne inconnue (%1)").arg(column.kind); break;
+        }
+        if (!ok) {
+            setError(errorMessage, "Fichier .dat corrompu: " + reader.error);
+            return false;
+        }
+    }
+
+    // columnCount vaut KindCount et aucune sorte n'est en double ou inconnue:
+    // contrôle gardé pour le jour où des colonnes deviendraient facultatives
+    if (std::find(seen.begin(), seen.end(), false) != seen.end()) {
+        setError(errorMessage, "Fichier .dat corrompu: colonne manquante");
+        return false;
+    }
+
+    const size_t rows = size_t(header.rowCount);
+    scope.addItems(rows);
+    if (loaded.ids.size() != rows || loaded.noms.size() != rows || loaded.types.size() != rows
+        || loaded.dates.size() != rows || loaded.statuts.size() != rows || loaded.valeurs.size() != rows
+        || (verifyCodes && (!codesValid(loaded.noms, loaded.nomValues.size())
+                            || !codesValid(loaded.types, loaded.typeValues.size())
+                            || !codesValid(loaded.statuts, loaded.statutValues.size())))) {
+        setError(errorMessage, "Fichier .dat corrompu: colonnes incohérentes");
+        return false;
+    }
+
+    table = std::move(loaded);
+    return true;
+}
+
+size_t DatFile::releasePages(const ColumnTable &table)
+{
+    PROFILE_SCOPE_AS(scope, "Pages .dat rendues");
+    const MappedFiles &files = MappedFiles::instance();
+    const size_t bytes = releaseColumn(files, table.ids) + releaseColumn(files, table.noms)
+        + releaseColumn(files, table.types) + releaseColumn(files, table.dates)
+        + releaseColumn(files, table.statuts) + releaseColumn(files, table.valeurs)
+        + releaseDictionary(files, table.nomValues) + releaseDictionary(files, table.typeValues)
+        + releaseDictionary(files, table.statutValues);
+    scope.addItems(bytes);
+    return bytes;
+}
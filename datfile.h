@@ -0,0 +1,51 @@
+// datfile.h
+#ifndef DATFILE_H
+#define DATFILE_H
+
+#include "columnstore.h"
+
+#include <QString>
+
+#include <functional>
+
+// Format binaire colonnaire .dat (petit-boutiste, version 1):
+//
+//   en-tête (64 octets)   magic "IQTDATA\0", version, nombre de colonnes,
+//                         nombre de lignes, lignes par bloc, position du répertoire
+//   blocs de données      alignés sur 64 octets, un bloc = BlockSize lignes
+//                         d'une colonne (ou un segment de dictionnaire)
+//   répertoire            pour chaque colonne: type, nombre de blocs, puis
+//                         par bloc: position, taille stockée, taille brute,
+//                         nombre d'éléments et codec (0 = brut, 1 = zlib)
+//
+// Les dictionnaires de Nom/Type/Statut sont des colonnes à part entière,
+// stockées par segments: fins de chaîne (uint32) puis octets UTF-8.
+// Un fichier non compressé est chargé sans copie: les blocs pointent
+// directement dans la projection mémoire du fichier.
+class DatFile
+{
+public:
+    enum Compression { NoCompression = 0, Zlib = 1 };
+
+    // Appelé après chaque bloc écrit (blocs écrits, total); false annule la sauvegarde
+    using Progress = std::function<bool(qint64 done, qint64 total)>;
+
+    static bool isDatFile(const QByteArray &head);
+
+    static bool save(const ColumnTable &table, const QString &fileName,
+                     Compression compression, QString *errorMessage = nullptr,
+                     const Progress &progress = Progress());
+    // verifyCodes faux: fichier écrit par l'application elle-même (copie
+    // d'un document déchargé); les colonnes de codes ne sont pas relues et
+    // leurs pages ne sont lues qu'au premier accès
+    static bool load(const QString &fileName, ColumnTable &table,
+                     QString *errorMessage = nullptr, bool verifyCodes = true);
+
+    // Rend au système les pages des blocs et segments du tableau projetés
+    // depuis un fichier .dat: elles seront relues depuis le fichier au
+    // prochain accès. Les blocs alloués ne sont pas touchés. Renvoie le
+    // nombre d'octets projetés concernés.
+    static size_t releasePages(const ColumnTable &table);
+};
+
+#endif // DATFILE_H
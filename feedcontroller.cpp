@@ -0,0 +1,288 @@
+// feedcontroller.cpp
+#include "feedcontroller.h"
+#include "datatablemodel.h"
+#include "feedsource.h"
+#include "profiler.h"
+
+#include <QTimer>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Copie la ligne index de from à la fin de to (toutes les colonnes sauf rows)
+void appendValues(const ColumnRows &from, size_t index, ColumnRows &to)
+{
+    to.ids.push_back(from.ids[index]);
+    to.noms.push_back(from.noms[index]);
+    to.types.push_back(from.types[index]);
+    to.dates.push_back(from.dates[index]);
+    to.statuts.push_back(from.statuts[index]);
+    to.valeurs.push_back(from.valeurs[index]);
+}
+
+// Remplace la ligne slot de to par la ligne index de from
+void assignValues(const ColumnRows &from, size_t index, ColumnRows &to, size_t slot)
+{
+    to.ids[slot] = from.ids[index];
+    to.noms[slot] = from.noms[index];
+    to.types[slot] = from.types[index];
+    to.dates[slot] = from.dates[index];
+    to.statuts[slot] = from.statuts[index];
+    to.valeurs[slot] = from.valeurs[index];
+}
+
+} // namespace
+
+FeedController::FeedController(QObject *parent)
+    : QObject(parent)
+    , queue(std::make_shared<FeedQueue>(QueueCapacityRows))
+    , frameTimer(new QTimer(this))
+    , statsTimer(new QTimer(this))
+{
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    frameTimer->setInterval(FrameIntervalMs);
+    connect(frameTimer, &QTimer::timeout, this, &FeedController::applyPending);
+    statsTimer->setInterval(StatsIntervalMs);
+    connect(statsTimer, &QTimer::timeout, this, &FeedController::publishStats);
+}
+
+FeedController::~FeedController()
+{
+    stop();
+}
+
+QString FeedController::serverName() const
+{
+    return receiver ? receiver->serverName() : QString();
+}
+
+void FeedController::start(const QString &serverName, DataTableModel *target)
+{
+    stop();
+    model = target;
+    // Autre document possible: index des Id reconstruit à la première image
+    indexedVersion = UINT64_MAX;
+    receiver = new FeedReceiver(serverName, queue, this);
+    connect(receiver, &FeedReceiver::connectionsChanged, this, [this](int count) {
+        current.connections = count;
+        publishStats();
+    });
+    connect(receiver, &FeedReceiver::failed, this, [this](const QString &message) {
+        stop();
+        emit failed(message);
+    });
+    receiver->start();
+
+    current = FeedStats();
+    current.running = true;
+    appliedSinceStats = 0;
+    applyMaxSinceStats = 0.0;
+    indexedVersion = UINT64_MAX;
+    statsClock.start();
+    frameTimer->start();
+    statsTimer->start();
+    emit statsChanged(current);
+}
+
+void FeedController::stop()
+{
+    stopGenerator();
+    if (!receiver)
+        return;
+    receiver->disconnect(this);
+    receiver->quit();
+    receiver->wait();
+    delete receiver;
+    receiver = nullptr;
+
+    // Ce qui était déjà reçu est appliqué
+    applyPending();
+    frameTimer->stop();
+    statsTimer->stop();
+    serials.clear();
+    model = nullptr;
+    current.running = false;
+    current.connections = 0;
+    current.rowsPerSecond = 0.0;
+    emit statsChanged(current);
+}
+
+void FeedController::startGenerator(int rowsPerSecond)
+{
+    if (!receiver || generator)
+        return;
+    // Les Id créés suivent ceux du tableau
+    const ColumnTable &table = model->store().table();
+    int64_t maxId = 0;
+    for (size_t block = 0; block < table.ids.blockCount(); ++block) {
+        const int64_t *ids = table.ids.blockData(block);
+        const size_t length = table.ids.blockLength(block);
+        if (length)
+            maxId = std::max(maxId, *std::max_element(ids, ids + length));
+    }
+    generator = new FeedGenerator(receiver->serverName(), rowsPerSecond, maxId + 1, this);
+    connect(generator, &FeedGenerator::failed, this, [this](const QString &message) {
+        stopGenerator();
+        emit failed(message);
+    });
+    generator->start();
+    current.generating = true;
+    emit statsChanged(current);
+}
+
+void FeedController::stopGenerator()
+{
+    if (!generator)
+        return;
+    generator->disconnect(this);
+    generator->requestInterruption();
+    generator->wait();
+    delete generator;
+    generator = nullptr;
+    current.generating = false;
+    emit statsChanged(current);
+}
+
+void FeedController::setRetention(size_t rows)
+{
+    retentionRows = rows;
+    if (receiver)
+        trim();
+}
+
+void FeedController::rebuildIndex()
+{
+    const ColumnTable &table = model->store().table();
+    serials.clear();
+    serials.reserve(table.rowCount());
+    trimmedBase = 0;
+    // En cas de doublon, la dernière ligne de l'Id est celle que l'on modifie
+    for (size_t row = 0; row < table.rowCount(); ++row)
+        serials[table.ids[row]] = row;
+    indexedVersion = model->store().version();
+}
+
+void FeedController::applyPending()
+{
+    std::vector<FeedBatch> batches = queue->takeAll();
+    if (batches.empty())
+        return;
+    PROFILE_SCOPE_AS(scope, "Flux: application");
+    QElapsedTimer timer;
+    timer.start();
+
+    if (model->store().version() != indexedVersion)
+        rebuildIndex();
+
+    const uint64_t rowCount = model->store().rowCount();
+    ColumnRows appended;
+    ColumnRows updates;
+    // Ligne modifiée -> place dans updates: la dernière valeur l'emporte
+    std::unordered_map<uint32_t, size_t> updateSlots;
+    size_t applied = 0;
+
+    for (const FeedBatch &batch : batches) {
+        const ColumnRows values = model->encodeRows(batch.rows.table());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const FeedOp op = batch.ops[i];
+            const int64_t id = values.ids[i];
+            auto known = op == FeedOp::Append ? serials.end() : serials.find(id);
+
+            if (known == serials.end()) {
+                if (op == FeedOp::Update) {
+                    ++current.ignoredRows;
+                    continue;
+                }
+                serials[id] = trimmedBase + rowCount + appended.ids.size();
+                appendValues(values, i, appended);
+            } else {
+                const uint64_t row = known->second - trimmedBase;
+                if (row >= rowCount) {
+                    // Ajoutée dans cette même image: modifiée avant l'insertion
+                    assignValues(values, i, appended, size_t(row - rowCount));
+                } else {
+                    auto [slot, inserted] = updateSlots.emplace(uint32_t(row), updates.rows.size());
+                    if (inserted) {
+                        updates.rows.push_back(uint32_t(row));
+                        appendValues(values, i, updates);
+                    } else {
+                        assignValues(values, i, updates, slot->second);
+                    }
+                }
+            }
+            ++applied;
+        }
+    }
+
+    if (!updates.rows.empty()) {
+        // Positions croissantes pour la modification groupée
+        std::vector<size_t> order(updates.rows.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::sort(order.begin(), order.end(), [&updates](size_t a, size_t b) {
+            return updates.rows[a] < updates.rows[b];
+        });
+        ColumnRows sorted;
+        sorted.rows.reserve(order.size());
+        for (size_t index : order) {
+            sorted.rows.push_back(updates.rows[index]);
+            appendValues(updates, index, sorted);
+        }
+        model->updateRows(sorted);
+        current.updatedRows += sorted.size();
+    }
+    if (!appended.ids.empty()) {
+        model->appendRows(appended);
+        current.appendedRows += appended.ids.size();
+    }
+    trim();
+    indexedVersion = model->store().version();
+
+    scope.addItems(applied);
+    appliedSinceStats += applied;
+    applyMaxSinceStats = std::max(applyMaxSinceStats, timer.nsecsElapsed() / 1e6);
+}
+
+void FeedController::trim()
+{
+    const size_t rows = model->store().rowCount();
+    // Par paquets (un huitième de la fenêtre): chaque retrait recopie les colonnes
+    if (retentionRows == 0 || rows <= retentionRows + retentionRows / 8)
+        return;
+    if (model->store().version() != indexedVersion)
+        rebuildIndex();
+
+    const size_t count = rows - retentionRows;
+    std::vector<uint32_t> front(count);
+    std::iota(front.begin(), front.end(), uint32_t(0));
+    const ColumnRows removed = model->eraseRows(front);
+    for (int64_t id : removed.ids) {
+        auto it = serials.find(id);
+        if (it != serials.end() && it->second < trimmedBase + count)
+            serials.erase(it);
+    }
+    trimmedBase += count;
+    // Le producteur crée un nom par Id: sans compactage, les noms des lignes
+    // retirées resteraient dans le dictionnaire. Borne sûre sans parcours:
+    // au moins size - rowCount valeurs sont inutilisées.
+    const ColumnStore &store = model->store();
+    if (store.table().nomValues.size() > NomCompactionFactor * store.rowCount())
+        model->compactNoms();
+    indexedVersion = model->store().version();
+    current.trimmedRows += count;
+    emit rowsTrimmed(count);
+}
+
+void FeedController::publishStats()
+{
+    const qint64 elapsed = statsClock.restart();
+    current.rowsPerSecond = elapsed > 0 ? appliedSinceStats * 1000.0 / double(elapsed) : 0.0;
+    current.applyMaxMs = applyMaxSinceStats;
+    current.pendingRows = queue->pendingRows();
+    if (receiver)
+        current.errors = receiver->errorCount();
+    appliedSinceStats = 0;
+    applyMaxSinceStats = 0.0;
+    emit statsChanged(current);
+}
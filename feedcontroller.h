@@ -0,0 +1,113 @@
+// feedcontroller.h
+#ifndef FEEDCONTROLLER_H
+#define FEEDCONTROLLER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+class DataTableModel;
+class FeedGenerator;
+class FeedQueue;
+class FeedReceiver;
+class QTimer;
+
+// État du flux pour l'affichage
+struct FeedStats
+{
+    bool running = false;
+    bool generating = false;
+    int connections = 0;
+    double rowsPerSecond = 0.0;    // lignes appliquées par seconde
+    quint64 appendedRows = 0;
+    quint64 updatedRows = 0;
+    quint64 ignoredRows = 0;       // modifications d'un Id inconnu
+    quint64 trimmedRows = 0;       // retirées par la fenêtre de rétention
+    quint64 errors = 0;            // lignes invalides
+    size_t pendingRows = 0;        // en file, pas encore appliquées
+    double applyMaxMs = 0.0;       // plus longue application d'une image
+};
+
+// Mode flux de données: les lignes reçues (FeedReceiver) s'accumulent dans
+// une file bornée et sont appliquées au modèle une fois par image. Toutes
+// les opérations d'une image sont regroupées: un seul ajout de lignes, une
+// seule modification groupée (la dernière valeur d'une ligne l'emporte),
+// donc quelques signaux du modèle au lieu d'un par ligne. Au-delà de la
+// fenêtre de rétention, les lignes les plus anciennes sont retirées par
+// paquets pour que le tableau ne grossisse pas sans fin; le dictionnaire
+// Nom est compacté quand la plupart de ses valeurs n'ont plus de ligne.
+class FeedController : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FrameIntervalMs = 16;
+    static constexpr int StatsIntervalMs = 500;
+    static constexpr size_t QueueCapacityRows = size_t(1) << 20;
+    static constexpr size_t DefaultRetentionRows = 1000000;
+    // Dictionnaire Nom compacté au-delà de ce nombre de valeurs par ligne
+    // gardée: plus de la moitié ne sert alors plus à rien
+    static constexpr size_t NomCompactionFactor = 2;
+    static constexpr int DefaultGeneratorRate = 100000;
+
+    explicit FeedController(QObject *parent = nullptr);
+    ~FeedController() override;
+
+    // Écoute sur le socket local serverName (tube nommé sous Windows); les
+    // lignes reçues vont dans target jusqu'à stop()
+    void start(const QString &serverName, DataTableModel *target);
+    void stop();
+    bool isRunning() const { return receiver != nullptr; }
+    QString serverName() const;
+    // Modèle alimenté, nul à l'arrêt
+    DataTableModel *target() const { return model; }
+
+    // Producteur de test connecté au récepteur courant
+    void startGenerator(int rowsPerSecond = DefaultGeneratorRate);
+    void stopGenerator();
+    bool isGenerating() const { return generator != nullptr; }
+
+    // Nombre de lignes gardées, 0: sans limite
+    void setRetention(size_t rows);
+    size_t retention() const { return retentionRows; }
+
+    const FeedStats &stats() const { return current; }
+
+signals:
+    void statsChanged(const FeedStats &stats);
+    void failed(const QString &message);
+    // Des lignes ont été retirées du début du tableau (numéros décalés)
+    void rowsTrimmed(size_t count);
+
+private:
+    DataTableModel *model = nullptr;
+    std::shared_ptr<FeedQueue> queue;
+    FeedReceiver *receiver = nullptr;
+    FeedGenerator *generator = nullptr;
+    QTimer *frameTimer;
+    QTimer *statsTimer;
+    size_t retentionRows = DefaultRetentionRows;
+
+    // Id -> numéro absolu de la ligne (position + lignes retirées avant elle).
+    // Valable tant que le modèle n'a été modifié que par le flux; reconstruit
+    // sinon (chargement, édition, annulation).
+    std::unordered_map<int64_t, uint64_t> serials;
+    uint64_t trimmedBase = 0;
+    uint64_t indexedVersion = UINT64_MAX;
+
+    FeedStats current;
+    QElapsedTimer statsClock;
+    quint64 appliedSinceStats = 0;
+    double applyMaxSinceStats = 0.0;
+
+    void applyPending();
+    void rebuildIndex();
+    void trim();
+    void publishStats();
+};
+
+#endif // FEEDCONTROLLER_H
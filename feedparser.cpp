@@ -0,0 +1,147 @@
+// feedparser.cpp
+#include "feedparser.h"
+#include "csvparser.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+constexpr size_t FieldCount = ColumnTable::ColumnCount;
+
+bool parseOp(std::string_view field, FeedOp &op)
+{
+    if (field.size() != 1)
+        return false;
+    switch (field[0]) {
+    case 'S': case 's': op = FeedOp::Upsert; return true;
+    case 'A': case 'a': op = FeedOp::Append; return true;
+    case 'U': case 'u': op = FeedOp::Update; return true;
+    default: return false;
+    }
+}
+
+} // namespace
+
+void FeedParser::feed(const char *data, size_t size, FeedBatch &out)
+{
+    const char *p = data;
+    const char *end = data + size;
+
+    // Fin de la ligne commencée au morceau précédent
+    if (!partial.empty() || discarding) {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        const char *stop = newline ? newline : end;
+        if (!discarding) {
+            if (partial.size() + size_t(stop - p) > MaxLineBytes) {
+                partial.clear();
+                discarding = true;
+                ++errors;
+            } else {
+                partial.append(p, size_t(stop - p));
+            }
+        }
+        if (!newline)
+            return;
+        if (!discarding)
+            parseLine(partial, out);
+        partial.clear();
+        discarding = false;
+        p = newline + 1;
+    }
+
+    while (p < end) {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        if (!newline) {
+            if (size_t(end - p) > MaxLineBytes) {
+                discarding = true;
+                ++errors;
+            } else {
+                partial.assign(p, size_t(end - p));
+            }
+            return;
+        }
+        parseLine(std::string_view(p, size_t(newline - p)), out);
+        p = newline + 1;
+    }
+}
+
+void FeedParser::parseLine(std::string_view line, FeedBatch &out)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    if (line.empty())
+        return;
+
+    std::string_view fields[FieldCount + 1];
+    size_t count = 0;
+    size_t start = 0;
+    while (count <= FieldCount) {
+        const size_t delimiter = line.find(';', start);
+        fields[count++] = line.substr(start, delimiter == std::string_view::npos ? std::string_view::npos
+                                                                                 : delimiter - start);
+        if (delimiter == std::string_view::npos)
+            break;
+        start = delimiter + 1;
+        // Champs en trop
+        if (count > FieldCount) {
+            ++errors;
+            return;
+        }
+    }
+
+    FeedOp op = FeedOp::Upsert;
+    const std::string_view *values = fields;
+    if (count == FieldCount + 1) {
+        if (!parseOp(fields[0], op)) {
+            ++errors;
+            return;
+        }
+        ++values;
+    } else if (count != FieldCount) {
+        ++errors;
+        return;
+    }
+
+    RowValues row;
+    const std::string_view id = values[ColumnTable::Id];
+    const auto result = std::from_chars(id.data(), id.data() + id.size(), row.id);
+    if (id.empty() || result.ec != std::errc() || result.ptr != id.data() + id.size()
+        || !parseDateField(values[ColumnTable::Date], row.date)
+        || !parseDoubleField(values[ColumnTable::Valeur], row.valeur)) {
+        ++errors;
+        return;
+    }
+    row.nom = values[ColumnTable::Nom];
+    row.type = values[ColumnTable::Type];
+    row.statut = values[ColumnTable::Statut];
+    out.rows.appendRow(row);
+    out.ops.push_back(op);
+    ++rows;
+}
+
+void FeedQueue::push(FeedBatch &&batch)
+{
+    const size_t count = batch.size();
+    if (count == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(std::move(batch));
+    }
+    pending.fetch_add(count, std::memory_order_relaxed);
+}
+
+std::vector<FeedBatch> FeedQueue::takeAll()
+{
+    std::vector<FeedBatch> taken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        taken.swap(batches);
+    }
+    size_t count = 0;
+    for (const FeedBatch &batch : taken)
+        count += batch.size();
+    pending.fetch_sub(count, std::memory_order_relaxed);
+    return taken;
+}
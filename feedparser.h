@@ -0,0 +1,82 @@
+// feedparser.h
+#ifndef FEEDPARSER_H
+#define FEEDPARSER_H
+
+#include "columnstore.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Opération d'une ligne du flux de données
+enum class FeedOp : uint8_t
+{
+    Upsert,   // modifie la ligne de même Id, l'ajoute si elle n'existe pas
+    Append,   // ajoute toujours
+    Update,   // modifie la ligne de même Id, ignorée si elle n'existe pas
+};
+
+// Lignes reçues du flux, dans leurs propres dictionnaires (codées dans ceux
+// du modèle par le thread graphique), avec l'opération de chacune
+struct FeedBatch
+{
+    ColumnStore rows;
+    std::vector<FeedOp> ops;
+
+    size_t size() const { return ops.size(); }
+};
+
+// Analyse du flux texte, une ligne par opération:
+//     [op;]Id;Nom;Type;Date;Statut;Valeur
+// op vaut S (upsert, par défaut), A (ajout) ou U (modification). Les
+// lignes arrivent par morceaux quelconques: la fin de ligne incomplète est
+// gardée jusqu'au morceau suivant. Pas de guillemets: le producteur écrit
+// des champs sans ';' ni saut de ligne.
+class FeedParser
+{
+public:
+    // Au-delà, une ligne est jugée invalide et abandonnée
+    static constexpr size_t MaxLineBytes = 65536;
+
+    void feed(const char *data, size_t size, FeedBatch &out);
+
+    size_t rowsParsed() const { return rows; }
+    size_t errorCount() const { return errors; }
+
+private:
+    std::string partial;
+    bool discarding = false;   // reste d'une ligne trop longue
+    size_t rows = 0;
+    size_t errors = 0;
+
+    void parseLine(std::string_view line, FeedBatch &out);
+};
+
+// File bornée entre le thread de réception et le thread graphique. Quand
+// elle est pleine, le récepteur cesse de lire: le tampon du système se
+// remplit et l'émetteur est freiné (contre-pression) au lieu de laisser
+// grossir la mémoire.
+class FeedQueue
+{
+public:
+    explicit FeedQueue(size_t capacityRows) : capacity(capacityRows) {}
+
+    bool isFull() const { return pending.load(std::memory_order_relaxed) >= capacity; }
+    size_t pendingRows() const { return pending.load(std::memory_order_relaxed); }
+
+    void push(FeedBatch &&batch);
+    // Tous les lots en attente, dans l'ordre d'arrivée
+    std::vector<FeedBatch> takeAll();
+
+private:
+    const size_t capacity;
+    std::atomic<size_t> pending{0};
+    std::mutex mutex;
+    std::vector<FeedBatch> batches;
+};
+
+#endif // FEEDPARSER_H
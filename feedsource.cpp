@@ -0,0 +1,213 @@
+// feedsource.cpp
+#include "feedsource.h"
+
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+const char *const Words[] = {
+    "Alpha", "Bravo", "Charlie", "Delta", "Écho", "Fox", "Golf", "Hôtel",
+    "India", "Juliette", "Kilo", "Lima", "Mike", "Novembre", "Oscar", "Papa",
+};
+constexpr size_t WordCount = sizeof(Words) / sizeof(Words[0]);
+const char *const Types[] = {"Commande", "Facture", "Livraison", "Retour", "Avoir", "Devis"};
+constexpr size_t TypeCount = sizeof(Types) / sizeof(Types[0]);
+const char *const Statuts[] = {"Actif", "Inactif", "En attente", "Archivé"};
+constexpr size_t StatutCount = sizeof(Statuts) / sizeof(Statuts[0]);
+
+uint64_t splitMix(uint64_t &state)
+{
+    uint64_t value = (state += 0x9e3779b97f4a7c15ull);
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+} // namespace
+
+FeedReceiver::FeedReceiver(const QString &serverName, std::shared_ptr<FeedQueue> queue, QObject *parent)
+    : QThread(parent)
+    , name(serverName)
+    , queue(std::move(queue))
+{
+}
+
+void FeedReceiver::run()
+{
+    struct Connection
+    {
+        FeedParser parser;
+        size_t errorsSeen = 0;
+    };
+    // Déclarés avant le serveur: détruits après lui et ses sockets
+    std::unordered_map<QLocalSocket *, Connection> connections;
+    QByteArray chunk(ChunkBytes, Qt::Uninitialized);
+
+    // Lit tant que la file a de la place; le reste attend dans le socket
+    auto readSocket = [&](QLocalSocket *socket, Connection &connection) {
+        FeedBatch batch;
+        while (!queue->isFull() && batch.size() < MaxBatchRows) {
+            const qint64 length = socket->read(chunk.data(), chunk.size());
+            if (length <= 0)
+                break;
+            received.fetch_add(quint64(length), std::memory_order_relaxed);
+            connection.parser.feed(chunk.constData(), size_t(length), batch);
+        }
+        const size_t newErrors = connection.parser.errorCount() - connection.errorsSeen;
+        if (newErrors) {
+            errors.fetch_add(newErrors, std::memory_order_relaxed);
+            connection.errorsSeen = connection.parser.errorCount();
+        }
+        queue->push(std::move(batch));
+    };
+
+    QLocalServer server;
+    // Un serveur précédent mal fermé laisse son socket derrière lui
+    QLocalServer::removeServer(name);
+    if (!server.listen(name)) {
+        emit failed(server.errorString());
+        return;
+    }
+    emit listening(server.fullServerName());
+
+    connect(&server, &QLocalServer::newConnection, &server, [&]() {
+        while (QLocalSocket *socket = server.nextPendingConnection()) {
+            socket->setReadBufferSize(ReadBufferBytes);
+            connections.emplace(socket, Connection());
+            connect(socket, &QLocalSocket::readyRead, &server, [&, socket]() {
+                auto it = connections.find(socket);
+                if (it != connections.end())
+                    readSocket(socket, it->second);
+            });
+            connect(socket, &QLocalSocket::disconnected, &server, [&, socket]() {
+                auto it = connections.find(socket);
+                if (it == connections.end())
+                    return;
+                // Ce qui reste dans le tampon a été envoyé avant la déconnexion
+                readSocket(socket, it->second);
+                connections.erase(it);
+                socket->deleteLater();
+                emit connectionsChanged(int(connections.size()));
+            });
+            emit connectionsChanged(int(connections.size()));
+        }
+    });
+
+    // readyRead n'est plus émis pour des données déjà en tampon: on reprend
+    // la lecture dès que le thread graphique a vidé la file
+    QTimer poll;
+    poll.setInterval(PollIntervalMs);
+    connect(&poll, &QTimer::timeout, &server, [&]() {
+        for (auto &[socket, connection] : connections) {
+            if (queue->isFull())
+                break;
+            if (socket->bytesAvailable() > 0)
+                readSocket(socket, connection);
+        }
+    });
+    poll.start();
+
+    exec();
+
+    poll.stop();
+    for (auto &entry : connections) {
+        entry.first->disconnect(&server);
+        delete entry.first;
+    }
+    connections.clear();
+    server.close();
+}
+
+FeedGenerator::FeedGenerator(const QString &serverName, int rowsPerSecond, qint64 firstId, QObject *parent)
+    : QThread(parent)
+    , name(serverName)
+    , rate(std::max(rowsPerSecond, 1))
+    , firstId(firstId)
+{
+}
+
+void FeedGenerator::run()
+{
+    QLocalSocket socket;
+    socket.connectToServer(name);
+    if (!socket.waitForConnected(2000)) {
+        emit failed(socket.errorString());
+        return;
+    }
+
+    uint64_t state = uint64_t(firstId) * 0x2545f4914f6cdd1dull;
+    const int32_t firstDay = daysFromCivil(2015, 1, 1);
+    qint64 nextId = firstId;
+    quint64 due = 0;
+    quint64 written = 0;
+    std::string text;
+    char line[160];
+    char date[10];
+
+    QElapsedTimer clock;
+    clock.start();
+    while (!isInterruptionRequested() && socket.state() == QLocalSocket::ConnectedState) {
+        due = quint64(clock.elapsed()) * quint64(rate) / 1000;
+        // Retard de plus d'une seconde (récepteur saturé): on ne rattrape pas
+        if (due > written + quint64(rate))
+            written = due - quint64(rate);
+        if (written >= due) {
+            msleep(1);
+            continue;
+        }
+
+        const size_t count = std::min<quint64>(due - written, MaxLinesPerWrite);
+        text.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t draw = splitMix(state);
+            const unsigned choice = unsigned(draw % 100);
+            char op;
+            qint64 id;
+            if (choice < 80 && nextId > firstId) {
+                op = 'U';
+                id = firstId + qint64((draw >> 8) % uint64_t(nextId - firstId));
+            } else if (choice < 95 && nextId > firstId) {
+                // Upsert: un Id existant ou le suivant
+                op = 'S';
+                id = firstId + qint64((draw >> 8) % uint64_t(nextId - firstId + 1));
+                if (id == nextId)
+                    ++nextId;
+            } else {
+                op = 'A';
+                id = nextId++;
+            }
+            formatDate(firstDay + int32_t((draw >> 20) % 3650), date);
+            const uint64_t word = uint64_t(id) % (WordCount * WordCount);
+            const int length = std::snprintf(line, sizeof(line), "%c;%lld;%s %s %lld;%s;%.10s;%s;%.2f\n",
+                                             op, static_cast<long long>(id), Words[word % WordCount],
+                                             Words[word / WordCount], static_cast<long long>(id),
+                                             Types[(draw >> 32) % TypeCount], date,
+                                             Statuts[(draw >> 40) % StatutCount],
+                                             double((draw >> 44) % 10000000) / 100.0);
+            text.append(line, size_t(length));
+        }
+        socket.write(text.data(), qint64(text.size()));
+        written += count;
+        sent.fetch_add(count, std::memory_order_relaxed);
+
+        // Contre-pression: le récepteur ne lit plus, on attend qu'il reprenne
+        socket.flush();
+        while (socket.bytesToWrite() > MaxPendingBytes && !isInterruptionRequested()
+               && socket.state() == QLocalSocket::ConnectedState) {
+            socket.waitForBytesWritten(50);
+        }
+    }
+
+    if (socket.state() == QLocalSocket::ConnectedState) {
+        socket.waitForBytesWritten(1000);
+        socket.disconnectFromServer();
+    }
+}
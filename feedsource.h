@@ -0,0 +1,83 @@
+// feedsource.h
+#ifndef FEEDSOURCE_H
+#define FEEDSOURCE_H
+
+#include "feedparser.h"
+
+#include <QString>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+
+// Réception du flux de données sur un socket local (socket Unix, tube nommé
+// sous Windows). Le serveur vit dans son propre thread: la lecture et
+// l'analyse ne prennent rien au thread graphique, qui ne fait que vider la
+// file une fois par image. Plusieurs producteurs peuvent se connecter.
+class FeedReceiver : public QThread
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 ChunkBytes = 256 * 1024;
+    // Tampon de lecture de chaque socket: au-delà, les données restent dans
+    // le système et freinent l'émetteur
+    static constexpr qint64 ReadBufferBytes = 1024 * 1024;
+    // Lots transmis d'une traite, pour que la file reste réactive
+    static constexpr size_t MaxBatchRows = 65536;
+    // Reprise de la lecture quand la file s'est vidée
+    static constexpr int PollIntervalMs = 5;
+
+    FeedReceiver(const QString &serverName, std::shared_ptr<FeedQueue> queue, QObject *parent = nullptr);
+
+    QString serverName() const { return name; }
+    quint64 bytesReceived() const { return received.load(std::memory_order_relaxed); }
+    quint64 errorCount() const { return errors.load(std::memory_order_relaxed); }
+
+signals:
+    void listening(const QString &fullServerName);
+    void connectionsChanged(int count);
+    void failed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    QString name;
+    std::shared_ptr<FeedQueue> queue;
+    std::atomic<quint64> received{0};
+    std::atomic<quint64> errors{0};
+};
+
+// Producteur de test: se connecte au récepteur comme un client externe et
+// envoie environ rowsPerSecond lignes par seconde. Surtout des
+// modifications (U) des Id déjà envoyés, quelques upserts (S) et ajouts (A).
+// Il attend quand le récepteur ne suit plus, au lieu d'accumuler.
+class FeedGenerator : public QThread
+{
+    Q_OBJECT
+
+public:
+    // Au-delà, le générateur attend que le récepteur ait lu
+    static constexpr qint64 MaxPendingBytes = 4 * 1024 * 1024;
+    static constexpr size_t MaxLinesPerWrite = 10000;
+
+    // Les Id créés commencent à firstId (au-dessus de ceux du tableau)
+    FeedGenerator(const QString &serverName, int rowsPerSecond, qint64 firstId, QObject *parent = nullptr);
+
+    quint64 rowsSent() const { return sent.load(std::memory_order_relaxed); }
+
+signals:
+    void failed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    QString name;
+    int rate;
+    qint64 firstId;
+    std::atomic<quint64> sent{0};
+};
+
+#endif // FEEDSOURCE_H
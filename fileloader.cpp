@@ -0,0 +1,90 @@
+// fileloader.cpp
+#include "fileloader.h"
+#include "csvparser.h"
+#include "datfile.h"
+#include "profiler.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+FileLoader::FileLoader(const QString &fileName, QObject *parent)
+    : QThread(parent)
+    , path(fileName)
+{
+    qRegisterMetaType<ColumnTablePtr>();
+}
+
+void FileLoader::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit loadFailed(file.errorString());
+        return;
+    }
+    const qint64 size = file.size();
+    if (size == 0) {
+        emit loadFinished(0, 0, timer.elapsed());
+        return;
+    }
+
+    if (DatFile::isDatFile(file.peek(8))) {
+        file.close();
+        loadDatFile(size, timer.elapsed());
+        return;
+    }
+
+    uchar *mapped = file.map(0, size);
+    if (!mapped) {
+        emit loadFailed("Projection mémoire impossible: " + file.errorString());
+        return;
+    }
+#ifdef Q_OS_UNIX
+    // Lecture séquentielle: le noyau peut lire en avance et libérer derrière
+    madvise(mapped, size_t(size), MADV_SEQUENTIAL);
+#endif
+
+    const char *begin = reinterpret_cast<const char *>(mapped);
+    const char *end = begin + size;
+    CsvParser parser(CsvParser::detectDelimiter(std::string_view(begin, size_t(qMin<qint64>(size, 4096)))));
+
+    const char *position = begin;
+    size_t batchRows = FirstBatchRows;
+    ColumnStore batch;
+    while (position < end && !isInterruptionRequested()) {
+        PROFILE_SCOPE_AS(scope, "Chargement: lot CSV");
+        position = parser.parse(position, end, batch, batchRows, true);
+        scope.addItems(batch.rowCount());
+        if (batch.rowCount() > 0) {
+            emit batchReady(batch.snapshot());
+            batch.clear();
+        }
+        emit progress(position - begin, size);
+        batchRows = BatchRows;
+    }
+
+    file.unmap(mapped);
+    if (!isInterruptionRequested())
+        emit loadFinished(qint64(parser.rowsParsed()), qint64(parser.errorCount()), timer.elapsed());
+}
+
+void FileLoader::loadDatFile(qint64 size, qint64 elapsedMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    auto table = std::make_shared<ColumnTable>();
+    QString error;
+    if (!DatFile::load(path, *table, &error)) {
+        emit loadFailed(error);
+        return;
+    }
+    emit tableReady(table);
+    emit progress(size, size);
+    emit loadFinished(qint64(table->rowCount()), 0, elapsedMs + timer.elapsed());
+}
@@ -0,0 +1,46 @@
+// fileloader.h
+#ifndef FILELOADER_H
+#define FILELOADER_H
+
+#include "columnstore.h"
+
+#include <QMetaType>
+#include <QString>
+#include <QThread>
+
+Q_DECLARE_METATYPE(ColumnTablePtr)
+
+// Chargement d'un fichier de données en arrière-plan. Un fichier texte est
+// projeté en mémoire puis analysé par lots; chaque lot est transmis au thread
+// graphique dès qu'il est prêt, le premier étant volontairement petit pour
+// afficher les premières lignes immédiatement. Un fichier .dat binaire est
+// repris tel quel en une seule table, sans analyse ligne par ligne.
+class FileLoader : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit FileLoader(const QString &fileName, QObject *parent = nullptr);
+
+    QString fileName() const { return path; }
+
+signals:
+    void batchReady(ColumnTablePtr batch);
+    void tableReady(ColumnTablePtr table);
+    void progress(qint64 bytesDone, qint64 bytesTotal);
+    void loadFinished(qint64 rows, qint64 errors, qint64 elapsedMs);
+    void loadFailed(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    QString path;
+
+    void loadDatFile(qint64 size, qint64 elapsedMs);
+
+    static constexpr size_t FirstBatchRows = 1000;
+    static constexpr size_t BatchRows = 65536;
+};
+
+#endif // FILELOADER_H
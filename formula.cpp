@@ -0,0 +1,714 @@
+// formula.cpp
+#include "formula.h"
+#include "csvparser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Valeur d'une sous-expression pendant la compilation. Les textes n'ont pas
+// de registre: ils ne servent qu'aux comparaisons avec une colonne codée.
+enum class Kind { Number, Date, Boolean, TextColumn, TextLiteral };
+
+struct Operand
+{
+    Kind kind = Kind::Number;
+    int reg = -1;
+    int column = -1;
+    std::string text;
+};
+
+bool isNumeric(const Operand &operand)
+{
+    return operand.kind == Kind::Number || operand.kind == Kind::Boolean;
+}
+
+bool isIdentifierByte(char c, bool first)
+{
+    const unsigned char byte = static_cast<unsigned char>(c);
+    return (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || byte == '_' || byte >= 0x80
+        || (!first && byte >= '0' && byte <= '9');
+}
+
+// Minuscules ASCII, « é » ramené à « e » (annee, année, début_mois...)
+std::string normalizeIdentifier(std::string_view identifier)
+{
+    std::string result;
+    result.reserve(identifier.size());
+    for (size_t i = 0; i < identifier.size(); ++i) {
+        const char c = identifier[i];
+        if (c == '\xC3' && i + 1 < identifier.size() && (identifier[i + 1] == '\xA9' || identifier[i + 1] == '\x89')) {
+            result += 'e';
+            ++i;
+        } else if (c >= 'A' && c <= 'Z') {
+            result += char(c - 'A' + 'a');
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+const StringColumn &dictionary(const ColumnTable &table, int column)
+{
+    return column == ColumnTable::Nom ? table.nomValues
+         : column == ColumnTable::Type ? table.typeValues : table.statutValues;
+}
+
+const BlockVector<uint32_t> &codes(const ColumnTable &table, int column)
+{
+    return column == ColumnTable::Nom ? table.noms
+         : column == ColumnTable::Type ? table.types : table.statuts;
+}
+
+template <typename F>
+void unary(double *out, const double *a, size_t n, F f)
+{
+    for (size_t k = 0; k < n; ++k)
+        out[k] = f(a[k]);
+}
+
+template <typename F>
+void binary(double *out, const double *a, const double *b, size_t n, F f)
+{
+    for (size_t k = 0; k < n; ++k)
+        out[k] = f(a[k], b[k]);
+}
+
+// Composantes de dates stockées en jours dans un registre
+template <typename F>
+void civil(double *out, const double *a, size_t n, F f)
+{
+    for (size_t k = 0; k < n; ++k) {
+        int year;
+        unsigned month, day;
+        civilFromDays(int32_t(a[k]), year, month, day);
+        out[k] = f(year, month, day);
+    }
+}
+
+} // namespace
+
+// Analyse descendante récursive; chaque sous-expression est émise dès
+// qu'elle est reconnue (le programme est dans l'ordre d'évaluation)
+class Formula::Parser
+{
+public:
+    Parser(Formula &formula, std::string_view text) : formula(formula), text(text) {}
+
+    bool parse(std::string *errorMessage)
+    {
+        Operand result;
+        bool ok = parseOr(result);
+        skipSpaces();
+        if (ok && position < text.size())
+            ok = fail("caractère inattendu");
+        if (ok && (result.kind == Kind::TextColumn || result.kind == Kind::TextLiteral))
+            ok = fail("une formule ne peut pas renvoyer du texte");
+        if (!ok) {
+            if (errorMessage)
+                *errorMessage = error + " (position " + std::to_string(errorPosition + 1) + ")";
+            return false;
+        }
+        formula.output = result.reg;
+        formula.type = result.kind == Kind::Date ? Type::Date
+                     : result.kind == Kind::Boolean ? Type::Boolean : Type::Number;
+        return true;
+    }
+
+private:
+    Formula &formula;
+    std::string_view text;
+    size_t position = 0;
+    std::string error;
+    size_t errorPosition = 0;
+
+    bool fail(const std::string &message)
+    {
+        if (error.empty()) {
+            error = message;
+            errorPosition = position;
+        }
+        return false;
+    }
+
+    int emit(Op op, int a = -1, int b = -1, int c = -1, double constant = 0.0)
+    {
+        Instruction instruction;
+        instruction.op = op;
+        instruction.a = a;
+        instruction.b = b;
+        instruction.c = c;
+        instruction.constant = constant;
+        formula.program.push_back(instruction);
+        return int(formula.program.size()) - 1;
+    }
+
+    Operand make(Kind kind, int reg)
+    {
+        Operand operand;
+        operand.kind = kind;
+        operand.reg = reg;
+        return operand;
+    }
+
+    void skipSpaces()
+    {
+        while (position < text.size() && (text[position] == ' ' || text[position] == '\t'))
+            ++position;
+    }
+
+    bool accept(std::string_view symbol)
+    {
+        skipSpaces();
+        if (text.substr(position, symbol.size()) != symbol)
+            return false;
+        position += symbol.size();
+        return true;
+    }
+
+    std::string_view peekIdentifier()
+    {
+        skipSpaces();
+        size_t end = position;
+        // « × » est un opérateur, pas une lettre
+        while (end < text.size() && isIdentifierByte(text[end], end == position)
+               && text.substr(end, 2) != "\xC3\x97")
+            ++end;
+        return text.substr(position, end - position);
+    }
+
+    bool acceptKeyword(std::string_view keyword)
+    {
+        const std::string_view identifier = peekIdentifier();
+        if (identifier.empty() || normalizeIdentifier(identifier) != keyword)
+            return false;
+        position += identifier.size();
+        return true;
+    }
+
+    // Nombre ou booléen: un registre. Les textes ne sont pas des valeurs.
+    bool requireNumeric(const Operand &operand, const char *context)
+    {
+        if (isNumeric(operand))
+            return true;
+        return fail(std::string(operand.kind == Kind::Date ? "date" : "texte") + " inattendu " + context);
+    }
+
+    // Un texte littéral tient lieu de date s'il en a la forme
+    bool requireDate(Operand &operand, const char *context)
+    {
+        if (operand.kind == Kind::TextLiteral) {
+            int32_t days = 0;
+            if (!parseDateField(operand.text, days))
+                return fail("date invalide: \"" + operand.text + "\"");
+            operand = make(Kind::Date, emit(Op::Constant, -1, -1, -1, double(days)));
+        }
+        if (operand.kind == Kind::Date)
+            return true;
+        return fail(std::string("date attendue ") + context);
+    }
+
+    bool parseOr(Operand &out)
+    {
+        if (!parseAnd(out))
+            return false;
+        while (acceptKeyword("ou")) {
+            Operand right;
+            if (!requireNumeric(out, "avant « ou »") || !parseAnd(right) || !requireNumeric(right, "après « ou »"))
+                return false;
+            out = make(Kind::Boolean, emit(Op::Or, out.reg, right.reg));
+        }
+        return true;
+    }
+
+    bool parseAnd(Operand &out)
+    {
+        if (!parseNot(out))
+            return false;
+        while (acceptKeyword("et")) {
+            Operand right;
+            if (!requireNumeric(out, "avant « et »") || !parseNot(right) || !requireNumeric(right, "après « et »"))
+                return false;
+            out = make(Kind::Boolean, emit(Op::And, out.reg, right.reg));
+        }
+        return true;
+    }
+
+    bool parseNot(Operand &out)
+    {
+        if (!acceptKeyword("non"))
+            return parseComparison(out);
+        if (!parseNot(out) || !requireNumeric(out, "après « non »"))
+            return false;
+        out = make(Kind::Boolean, emit(Op::Not, out.reg));
+        return true;
+    }
+
+    bool parseComparison(Operand &out)
+    {
+        if (!parseSum(out))
+            return false;
+        Op op;
+        if (accept("<="))
+            op = Op::LessEqual;
+        else if (accept("<>") || accept("!="))
+            op = Op::NotEqual;
+        else if (accept(">="))
+            op = Op::GreaterEqual;
+        else if (accept("<"))
+            op = Op::Less;
+        else if (accept(">"))
+            op = Op::Greater;
+        else if (accept("="))
+            op = Op::Equal;
+        else
+            return true;
+        Operand right;
+        if (!parseSum(right))
+            return false;
+        return compare(op, out, right, out);
+    }
+
+    bool compare(Op op, Operand left, Operand right, Operand &out)
+    {
+        // Colonne codée: le texte est résolu en code, comparé entier à entier
+        if (right.kind == Kind::TextColumn)
+            std::swap(left, right);
+        if (left.kind == Kind::TextColumn) {
+            if (right.kind != Kind::TextLiteral)
+                return fail("une colonne texte se compare à un texte entre guillemets");
+            if (op != Op::Equal && op != Op::NotEqual)
+                return fail("une colonne texte se compare avec = ou <>");
+            TextMatch match;
+            match.column = left.column;
+            match.value = right.text;
+            formula.matches.push_back(std::move(match));
+            int reg = emit(Op::MatchText, -1, -1, -1, double(formula.matches.size() - 1));
+            if (op == Op::NotEqual)
+                reg = emit(Op::Not, reg);
+            out = make(Kind::Boolean, reg);
+            return true;
+        }
+        if (left.kind == Kind::Date || right.kind == Kind::Date) {
+            if (!requireDate(left, "dans la comparaison") || !requireDate(right, "dans la comparaison"))
+                return false;
+        } else if (!requireNumeric(left, "dans la comparaison") || !requireNumeric(right, "dans la comparaison")) {
+            return false;
+        }
+        out = make(Kind::Boolean, emit(op, left.reg, right.reg));
+        return true;
+    }
+
+    bool parseSum(Operand &out)
+    {
+        if (!parseProduct(out))
+            return false;
+        for (;;) {
+            const bool add = accept("+");
+            if (!add && !accept("-"))
+                return true;
+            Operand right;
+            if (!parseProduct(right))
+                return false;
+            // Date ± jours, écart entre deux dates en jours
+            Kind kind = Kind::Number;
+            if (out.kind == Kind::Date && isNumeric(right))
+                kind = Kind::Date;
+            else if (add && isNumeric(out) && right.kind == Kind::Date)
+                kind = Kind::Date;
+            else if (!add && out.kind == Kind::Date && right.kind == Kind::Date)
+                kind = Kind::Number;
+            else if (!requireNumeric(out, add ? "avant +" : "avant -") || !requireNumeric(right, add ? "après +" : "après -"))
+                return false;
+            out = make(kind, emit(add ? Op::Add : Op::Subtract, out.reg, right.reg));
+        }
+    }
+
+    bool parseProduct(Operand &out)
+    {
+        if (!parseUnary(out))
+            return false;
+        for (;;) {
+            Op op;
+            if (accept("*") || accept("\xC3\x97"))
+                op = Op::Multiply;
+            else if (accept("/"))
+                op = Op::Divide;
+            else
+                return true;
+            Operand right;
+            if (!requireNumeric(out, "dans un produit") || !parseUnary(right) || !requireNumeric(right, "dans un produit"))
+                return false;
+            out = make(Kind::Number, emit(op, out.reg, right.reg));
+        }
+    }
+
+    bool parseUnary(Operand &out)
+    {
+        if (!accept("-"))
+            return parsePrimary(out);
+        if (!parseUnary(out) || !requireNumeric(out, "après -"))
+            return false;
+        out = make(Kind::Number, emit(Op::Negate, out.reg));
+        return true;
+    }
+
+    bool parsePrimary(Operand &out)
+    {
+        skipSpaces();
+        if (position >= text.size())
+            return fail("expression incomplète");
+        const char c = text[position];
+        if (accept("(")) {
+            if (!parseOr(out))
+                return false;
+            return accept(")") || fail("« ) » attendue");
+        }
+        if ((c >= '0' && c <= '9') || c == '.')
+            return parseNumber(out);
+        if (c == '"')
+            return parseText(out);
+        const std::string_view identifier = peekIdentifier();
+        if (identifier.empty())
+            return fail(std::string("caractère inattendu: ") + c);
+        const std::string name = normalizeIdentifier(identifier);
+        position += identifier.size();
+        if (accept("("))
+            return parseCall(name, out);
+        return column(name, out);
+    }
+
+    bool parseNumber(Operand &out)
+    {
+        size_t end = position;
+        while (end < text.size() && ((text[end] >= '0' && text[end] <= '9') || text[end] == '.'))
+            ++end;
+        if (end < text.size() && (text[end] == 'e' || text[end] == 'E')) {
+            size_t exponent = end + 1;
+            if (exponent < text.size() && (text[exponent] == '+' || text[exponent] == '-'))
+                ++exponent;
+            if (exponent < text.size() && text[exponent] >= '0' && text[exponent] <= '9') {
+                end = exponent;
+                while (end < text.size() && text[end] >= '0' && text[end] <= '9')
+                    ++end;
+            }
+        }
+        double value = 0.0;
+        if (!parseDoubleField(text.substr(position, end - position), value))
+            return fail("nombre invalide");
+        position = end;
+        out = make(Kind::Number, emit(Op::Constant, -1, -1, -1, value));
+        return true;
+    }
+
+    // "texte", guillemet doublé pour l'inclure
+    bool parseText(Operand &out)
+    {
+        out = Operand();
+        out.kind = Kind::TextLiteral;
+        for (size_t i = position + 1; i < text.size(); ++i) {
+            if (text[i] != '"') {
+                out.text += text[i];
+            } else if (i + 1 < text.size() && text[i + 1] == '"') {
+                out.text += '"';
+                ++i;
+            } else {
+                position = i + 1;
+                return true;
+            }
+        }
+        return fail("guillemet fermant manquant");
+    }
+
+    bool column(const std::string &name, Operand &out)
+    {
+        static const struct { const char *name; int column; } Columns[] = {
+            {"id", ColumnTable::Id}, {"nom", ColumnTable::Nom}, {"type", ColumnTable::Type},
+            {"date", ColumnTable::Date}, {"statut", ColumnTable::Statut}, {"valeur", ColumnTable::Valeur},
+        };
+        if (name == "vrai" || name == "faux") {
+            out = make(Kind::Boolean, emit(Op::Constant, -1, -1, -1, name == "vrai" ? 1.0 : 0.0));
+            return true;
+        }
+        for (const auto &entry : Columns) {
+            if (name != entry.name)
+                continue;
+            formula.columns |= 1u << entry.column;
+            switch (entry.column) {
+            case ColumnTable::Id:
+                out = make(Kind::Number, emit(Op::LoadId));
+                break;
+            case ColumnTable::Date:
+                out = make(Kind::Date, emit(Op::LoadDate));
+                break;
+            case ColumnTable::Valeur:
+                out = make(Kind::Number, emit(Op::LoadValeur));
+                break;
+            default:
+                out = Operand();
+                out.kind = Kind::TextColumn;
+                out.column = entry.column;
+                break;
+            }
+            return true;
+        }
+        return fail("colonne ou fonction inconnue: " + name);
+    }
+
+    bool parseCall(const std::string &name, Operand &out)
+    {
+        std::vector<Operand> args;
+        if (!accept(")")) {
+            do {
+                Operand arg;
+                if (!parseOr(arg))
+                    return false;
+                args.push_back(std::move(arg));
+            } while (accept(","));
+            if (!accept(")"))
+                return fail("« ) » attendue après les arguments de " + name);
+        }
+        auto arity = [&](size_t low, size_t high) {
+            return (args.size() >= low && args.size() <= high)
+                || fail(name + ": " + std::to_string(low)
+                        + (low == high ? "" : " à " + std::to_string(high)) + " arguments attendus");
+        };
+
+        if (name == "si") {
+            if (!arity(3, 3) || !requireNumeric(args[0], "comme condition de si"))
+                return false;
+            Kind kind;
+            if (args[1].kind == Kind::Date || args[2].kind == Kind::Date) {
+                if (!requireDate(args[1], "dans les deux branches de si") || !requireDate(args[2], "dans les deux branches de si"))
+                    return false;
+                kind = Kind::Date;
+            } else {
+                if (!requireNumeric(args[1], "dans si") || !requireNumeric(args[2], "dans si"))
+                    return false;
+                kind = args[1].kind == Kind::Boolean && args[2].kind == Kind::Boolean ? Kind::Boolean : Kind::Number;
+            }
+            out = make(kind, emit(Op::Select, args[0].reg, args[1].reg, args[2].reg));
+            return true;
+        }
+        if (name == "abs") {
+            if (!arity(1, 1) || !requireNumeric(args[0], "dans abs"))
+                return false;
+            out = make(Kind::Number, emit(Op::Abs, args[0].reg));
+            return true;
+        }
+        if (name == "arrondi") {
+            if (!arity(1, 2) || !requireNumeric(args[0], "dans arrondi"))
+                return false;
+            const int digits = args.size() > 1 ? args[1].reg : emit(Op::Constant);
+            if (args.size() > 1 && !requireNumeric(args[1], "dans arrondi"))
+                return false;
+            out = make(Kind::Number, emit(Op::Round, args[0].reg, digits));
+            return true;
+        }
+        if (name == "min" || name == "max") {
+            if (!arity(2, 2))
+                return false;
+            Kind kind = Kind::Number;
+            if (args[0].kind == Kind::Date || args[1].kind == Kind::Date) {
+                if (!requireDate(args[0], ("dans " + name).c_str()) || !requireDate(args[1], ("dans " + name).c_str()))
+                    return false;
+                kind = Kind::Date;
+            } else if (!requireNumeric(args[0], ("dans " + name).c_str()) || !requireNumeric(args[1], ("dans " + name).c_str())) {
+                return false;
+            }
+            out = make(kind, emit(name == "min" ? Op::Min : Op::Max, args[0].reg, args[1].reg));
+            return true;
+        }
+
+        static const struct { const char *name; Op op; Kind kind; } DateFunctions[] = {
+            {"annee", Op::Year, Kind::Number}, {"mois", Op::Month, Kind::Number},
+            {"jour", Op::Day, Kind::Number}, {"trimestre", Op::Quarter, Kind::Number},
+            {"debut_mois", Op::MonthStart, Kind::Date}, {"debut_annee", Op::YearStart, Kind::Date},
+        };
+        for (const auto &function : DateFunctions) {
+            if (name != function.name)
+                continue;
+            if (!arity(1, 1) || !requireDate(args[0], ("dans " + name).c_str()))
+                return false;
+            out = make(function.kind, emit(function.op, args[0].reg));
+            return true;
+        }
+        return fail("fonction inconnue: " + name);
+    }
+};
+
+bool Formula::compile(std::string_view text, std::string *errorMessage)
+{
+    *this = Formula();
+    source = std::string(text);
+    Parser parser(*this, source);
+    if (parser.parse(errorMessage))
+        return true;
+    *this = Formula();
+    return false;
+}
+
+void Formula::bind(const ColumnTable &table)
+{
+    for (TextMatch &match : matches) {
+        const StringColumn &values = dictionary(table, match.column);
+        if (values.size() < match.scanned) {
+            match.scanned = 0;
+            match.code = -1;
+        }
+        // Un code trouvé ne change plus tant que le dictionnaire est le même
+        if (match.code >= 0)
+            continue;
+        for (size_t code = match.scanned; code < values.size(); ++code) {
+            if (values[code] == match.value) {
+                match.code = int64_t(code);
+                break;
+            }
+        }
+        match.scanned = values.size();
+    }
+}
+
+void Formula::unbind()
+{
+    for (TextMatch &match : matches) {
+        match.scanned = 0;
+        match.code = -1;
+    }
+}
+
+void Formula::evaluate(const ColumnTable &table, size_t begin, size_t end, double *out) const
+{
+    constexpr size_t BlockShift = BlockVector<double>::BlockShift;
+    constexpr size_t BlockMask = BlockVector<double>::BlockMask;
+    // Registres d'une tranche, propres au thread
+    thread_local std::vector<double> registers;
+    if (registers.size() < program.size() * TileSize)
+        registers.resize(program.size() * TileSize);
+    double *const base = registers.data();
+    const size_t block = begin >> BlockShift;
+
+    for (size_t first = begin; first < end; first += TileSize) {
+        const size_t n = std::min(TileSize, end - first);
+        const size_t offset = first & BlockMask;
+        for (size_t i = 0; i < program.size(); ++i) {
+            const Instruction &instruction = program[i];
+            double *r = base + i * TileSize;
+            const double *a = instruction.a >= 0 ? base + size_t(instruction.a) * TileSize : nullptr;
+            const double *b = instruction.b >= 0 ? base + size_t(instruction.b) * TileSize : nullptr;
+            const double *c = instruction.c >= 0 ? base + size_t(instruction.c) * TileSize : nullptr;
+            switch (instruction.op) {
+            case Op::Constant:
+                std::fill(r, r + n, instruction.constant);
+                break;
+            case Op::LoadId: {
+                const int64_t *ids = table.ids.blockData(block) + offset;
+                for (size_t k = 0; k < n; ++k)
+                    r[k] = double(ids[k]);
+                break;
+            }
+            case Op::LoadDate: {
+                const int32_t *dates = table.dates.blockData(block) + offset;
+                for (size_t k = 0; k < n; ++k)
+                    r[k] = double(dates[k]);
+                break;
+            }
+            case Op::LoadValeur:
+                std::memcpy(r, table.valeurs.blockData(block) + offset, n * sizeof(double));
+                break;
+            case Op::MatchText: {
+                const TextMatch &match = matches[size_t(instruction.constant)];
+                const uint32_t *values = codes(table, match.column).blockData(block) + offset;
+                // Absent du dictionnaire: aucun code ne peut valoir UINT64_MAX
+                const uint64_t code = match.code >= 0 ? uint64_t(match.code) : UINT64_MAX;
+                for (size_t k = 0; k < n; ++k)
+                    r[k] = uint64_t(values[k]) == code ? 1.0 : 0.0;
+                break;
+            }
+            case Op::Negate:
+                unary(r, a, n, [](double x) { return -x; });
+                break;
+            case Op::Not:
+                unary(r, a, n, [](double x) { return x == 0.0 ? 1.0 : 0.0; });
+                break;
+            case Op::Add:
+                binary(r, a, b, n, [](double x, double y) { return x + y; });
+                break;
+            case Op::Subtract:
+                binary(r, a, b, n, [](double x, double y) { return x - y; });
+                break;
+            case Op::Multiply:
+                binary(r, a, b, n, [](double x, double y) { return x * y; });
+                break;
+            case Op::Divide:
+                binary(r, a, b, n, [](double x, double y) { return x / y; });
+                break;
+            case Op::Less:
+                binary(r, a, b, n, [](double x, double y) { return x < y ? 1.0 : 0.0; });
+                break;
+            case Op::LessEqual:
+                binary(r, a, b, n, [](double x, double y) { return x <= y ? 1.0 : 0.0; });
+                break;
+            case Op::Greater:
+                binary(r, a, b, n, [](double x, double y) { return x > y ? 1.0 : 0.0; });
+                break;
+            case Op::GreaterEqual:
+                binary(r, a, b, n, [](double x, double y) { return x >= y ? 1.0 : 0.0; });
+                break;
+            case Op::Equal:
+                binary(r, a, b, n, [](double x, double y) { return x == y ? 1.0 : 0.0; });
+                break;
+            case Op::NotEqual:
+                binary(r, a, b, n, [](double x, double y) { return x != y ? 1.0 : 0.0; });
+                break;
+            case Op::And:
+                binary(r, a, b, n, [](double x, double y) { return double((x != 0.0) & (y != 0.0)); });
+                break;
+            case Op::Or:
+                binary(r, a, b, n, [](double x, double y) { return double((x != 0.0) | (y != 0.0)); });
+                break;
+            case Op::Select:
+                for (size_t k = 0; k < n; ++k)
+                    r[k] = a[k] != 0.0 ? b[k] : c[k];
+                break;
+            case Op::Abs:
+                unary(r, a, n, [](double x) { return std::fabs(x); });
+                break;
+            case Op::Round:
+                binary(r, a, b, n, [](double x, double digits) {
+                    const double scale = std::pow(10.0, digits);
+                    return std::round(x * scale) / scale;
+                });
+                break;
+            case Op::Min:
+                binary(r, a, b, n, [](double x, double y) { return y < x ? y : x; });
+                break;
+            case Op::Max:
+                binary(r, a, b, n, [](double x, double y) { return x < y ? y : x; });
+                break;
+            case Op::Year:
+                civil(r, a, n, [](int year, unsigned, unsigned) { return double(year); });
+                break;
+            case Op::Month:
+                civil(r, a, n, [](int, unsigned month, unsigned) { return double(month); });
+                break;
+            case Op::Day:
+                civil(r, a, n, [](int, unsigned, unsigned day) { return double(day); });
+                break;
+            case Op::Quarter:
+                civil(r, a, n, [](int, unsigned month, unsigned) { return double((month - 1) / 3 + 1); });
+                break;
+            case Op::MonthStart:
+                civil(r, a, n, [](int year, unsigned month, unsigned) { return double(daysFromCivil(year, month, 1)); });
+                break;
+            case Op::YearStart:
+                civil(r, a, n, [](int year, unsigned, unsigned) { return double(daysFromCivil(year, 1, 1)); });
+                break;
+            }
+        }
+        std::memcpy(out + (first - begin), base + size_t(output) * TileSize, n * sizeof(double));
+    }
+}
@@ -0,0 +1,92 @@
+// formula.h
+#ifndef FORMULA_H
+#define FORMULA_H
+
+#include "columnstore.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Formule d'une colonne calculée, compilée en une suite d'opérations sur
+// des tranches de lignes. Chaque tranche (TileSize lignes) passe par toutes
+// les opérations avant la suivante: les valeurs intermédiaires restent en
+// cache et chaque opération est une boucle simple, vectorisée par le
+// compilateur.
+//
+// Langage:
+//   colonnes   Id, Date, Valeur; Nom, Type, Statut (comparés à un texte)
+//   littéraux  12.5, "Actif", "2024-01-31" (comparé à Date)
+//   opérateurs + - * (ou ×) /, = <> < <= > >=, et, ou, non, parenthèses
+//   fonctions  si(c, a, b), abs(x), arrondi(x[, n]), min(a, b), max(a, b),
+//              annee(d), mois(d), jour(d), trimestre(d), debut_mois(d),
+//              debut_annee(d)
+// Exemples: Valeur * 1.2, debut_mois(Date), Statut = "Actif" et Valeur > 100
+class Formula
+{
+public:
+    enum class Type { Number, Date, Boolean };
+
+    static constexpr size_t TileSize = 1024;
+
+    // false si le texte est invalide (errorMessage explique pourquoi)
+    bool compile(std::string_view text, std::string *errorMessage);
+
+    const std::string &text() const { return source; }
+    Type resultType() const { return type; }
+    // Colonnes lues, un bit par colonne de ColumnTable
+    unsigned dependencies() const { return columns; }
+    bool dependsOn(int column) const { return column >= 0 && (columns >> column) & 1u; }
+
+    // Résout les textes comparés dans les dictionnaires du tableau. Les
+    // dictionnaires ne font que grandir (sinon unbind()): seules les valeurs
+    // ajoutées depuis l'appel précédent sont parcourues. À appeler avant evaluate(), depuis
+    // un seul thread.
+    void bind(const ColumnTable &table);
+    // Autre tableau (dictionnaires remplacés): tout est à résoudre
+    void unbind();
+
+    // Valeurs des lignes [begin, end), prises dans un même bloc de
+    // BlockVector. Peut être appelé en parallèle sur des plages distinctes.
+    void evaluate(const ColumnTable &table, size_t begin, size_t end, double *out) const;
+
+private:
+    enum class Op {
+        Constant, LoadId, LoadDate, LoadValeur, MatchText,
+        Negate, Not, Add, Subtract, Multiply, Divide,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or,
+        Select, Abs, Round, Min, Max,
+        Year, Month, Day, Quarter, MonthStart, YearStart
+    };
+
+    // Le résultat de l'instruction i va dans le registre i
+    struct Instruction
+    {
+        Op op;
+        int a = -1;
+        int b = -1;
+        int c = -1;
+        double constant = 0.0;
+    };
+
+    // Texte comparé à une colonne codée par dictionnaire
+    struct TextMatch
+    {
+        int column;
+        std::string value;
+        size_t scanned = 0;   // valeurs du dictionnaire déjà parcourues
+        int64_t code = -1;    // -1: absent du dictionnaire
+    };
+
+    class Parser;
+
+    std::string source;
+    std::vector<Instruction> program;
+    std::vector<TextMatch> matches;
+    int output = -1;   // registre du résultat
+    Type type = Type::Number;
+    unsigned columns = 0;
+};
+
+#endif // FORMULA_H
@@ -0,0 +1,309 @@
+// hierarchymodel.cpp
+#include "hierarchymodel.h"
+#include "csvparser.h"
+
+#include <cmath>
+
+namespace {
+
+QString fromUtf8(std::string_view value)
+{
+    return QString::fromUtf8(value.data(), qsizetype(value.size()));
+}
+
+QString number(double value)
+{
+    return std::isnan(value) ? QString("---") : QString::number(value);
+}
+
+} // namespace
+
+HierarchyModel::HierarchyModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , headers({"Élément", "Type", "Valeur", "Nombre", "Min", "Max"})
+{
+}
+
+uint32_t HierarchyModel::nodeOf(const QModelIndex &index) const
+{
+    return index.isValid() ? uint32_t(index.internalId()) : NodeTable::NoNode;
+}
+
+const std::vector<uint32_t> *HierarchyModel::children(uint32_t node) const
+{
+    auto it = childLists.find(node);
+    return it != childLists.end() ? &it->second : nullptr;
+}
+
+std::vector<uint32_t> *HierarchyModel::children(uint32_t node)
+{
+    auto it = childLists.find(node);
+    return it != childLists.end() ? &it->second : nullptr;
+}
+
+QModelIndex HierarchyModel::indexOf(uint32_t node, int column) const
+{
+    if (node == NodeTable::NoNode || !children(table.parent(node)))
+        return QModelIndex();
+    return createIndex(int(rowInParent[node]), column, quintptr(node));
+}
+
+std::vector<uint32_t> HierarchyModel::collectChildren(uint32_t node)
+{
+    std::vector<uint32_t> list;
+    list.reserve(table.childCount(node));
+    for (uint32_t child = table.firstChild(node); child != NodeTable::NoNode; child = table.nextSibling(child)) {
+        rowInParent[child] = uint32_t(list.size());
+        list.push_back(child);
+    }
+    fetched += list.size();
+    return list;
+}
+
+QModelIndex HierarchyModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnCount || (parent.isValid() && parent.column() != 0))
+        return QModelIndex();
+    const std::vector<uint32_t> *list = children(nodeOf(parent));
+    if (!list || size_t(row) >= list->size())
+        return QModelIndex();
+    return createIndex(row, column, quintptr((*list)[size_t(row)]));
+}
+
+QModelIndex HierarchyModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+    const uint32_t node = table.parent(nodeOf(child));
+    if (node == NodeTable::NoNode)
+        return QModelIndex();
+    return createIndex(int(rowInParent[node]), 0, quintptr(node));
+}
+
+int HierarchyModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != 0)
+        return 0;
+    const std::vector<uint32_t> *list = children(nodeOf(parent));
+    return list ? int(list->size()) : 0;
+}
+
+int HierarchyModel::columnCount(const QModelIndex &) const
+{
+    return ColumnCount;
+}
+
+bool HierarchyModel::hasChildren(const QModelIndex &parent) const
+{
+    // Vrai avant dépliage: la vue affiche la flèche et demandera fetchMore
+    if (parent.isValid() && parent.column() != 0)
+        return false;
+    return table.childCount(nodeOf(parent)) > 0;
+}
+
+bool HierarchyModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != 0)
+        return false;
+    const uint32_t node = nodeOf(parent);
+    return table.childCount(node) > 0 && !children(node);
+}
+
+void HierarchyModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+    const uint32_t node = nodeOf(parent);
+    std::vector<uint32_t> list = collectChildren(node);
+    beginInsertRows(parent, 0, int(list.size()) - 1);
+    childLists.emplace(node, std::move(list));
+    endInsertRows();
+}
+
+QVariant HierarchyModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+    const uint32_t node = nodeOf(index);
+    const ValueStats &rollup = table.rollup(node);
+    const bool folder = table.childCount(node) > 0;
+    switch (index.column()) {
+    case Element:
+        return fromUtf8(table.name(node));
+    case Type:
+        return fromUtf8(table.kind(node));
+    case Valeur:
+        if (!folder)
+            return number(table.valeur(node));
+        return rollup.count > 0 ? QString::number(rollup.sum) : QString("---");
+    case Nombre:
+        return QString::number(rollup.count);
+    case Minimum:
+        return rollup.count > 0 ? QString::number(rollup.min) : QString("---");
+    case Maximum:
+        return rollup.count > 0 ? QString::number(rollup.max) : QString("---");
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags HierarchyModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags result = QAbstractItemModel::flags(index);
+    if (index.isValid() && index.column() == Valeur && table.childCount(nodeOf(index)) == 0)
+        result |= Qt::ItemIsEditable;
+    return result;
+}
+
+bool HierarchyModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || index.column() != Valeur)
+        return false;
+    const uint32_t node = nodeOf(index);
+    if (table.childCount(node) > 0)
+        return false;
+    const QByteArray text = value.toString().toUtf8();
+    double number = std::nan("");
+    if (!text.trimmed().isEmpty() && !parseDoubleField(std::string_view(text.constData(), size_t(text.size())), number))
+        return false;
+    table.setValeur(node, number);
+    pathChanged(node);
+    return true;
+}
+
+void HierarchyModel::pathChanged(uint32_t node)
+{
+    // Seuls les ascendants voient leur cumul changer: O(profondeur)
+    for (; node != NodeTable::NoNode; node = table.parent(node)) {
+        const QModelIndex first = indexOf(node, Valeur);
+        if (first.isValid())
+            emit dataChanged(first, indexOf(node, Maximum), {Qt::DisplayRole});
+    }
+}
+
+void HierarchyModel::forgetChildren(uint32_t node)
+{
+    auto it = childLists.find(node);
+    if (it == childLists.end())
+        return;
+    const std::vector<uint32_t> list = std::move(it->second);
+    childLists.erase(it);
+    fetched -= list.size();
+    for (uint32_t child : list)
+        forgetChildren(child);
+}
+
+void HierarchyModel::eraseRow(std::vector<uint32_t> &list, size_t row)
+{
+    list.erase(list.begin() + qsizetype(row));
+    for (size_t k = row; k < list.size(); ++k)
+        rowInParent[list[k]] = uint32_t(k);
+    --fetched;
+}
+
+QModelIndex HierarchyModel::insertNode(const QModelIndex &parent, const QString &name, const QString &kind,
+                                       double valeur)
+{
+    const QModelIndex parentIndex = parent.isValid() ? parent.siblingAtColumn(0) : QModelIndex();
+    const uint32_t parentNode = nodeOf(parentIndex);
+    // Premier enfant d'un nœud affiché: sa liste (vide) devient présentée
+    if (!children(parentNode) && table.childCount(parentNode) == 0
+        && (parentNode == NodeTable::NoNode || indexOf(parentNode).isValid())) {
+        childLists.emplace(parentNode, std::vector<uint32_t>());
+    }
+
+    const QByteArray nameText = name.toUtf8();
+    const QByteArray kindText = kind.toUtf8();
+    std::vector<uint32_t> *list = children(parentNode);
+    const int row = list ? int(list->size()) : -1;
+    if (list)
+        beginInsertRows(parentIndex, row, row);
+    const uint32_t node = table.addNode(parentNode, std::string_view(nameText.constData(), size_t(nameText.size())),
+                                        std::string_view(kindText.constData(), size_t(kindText.size())), valeur);
+    rowInParent.resize(table.size(), 0);
+    if (list) {
+        rowInParent[node] = uint32_t(row);
+        list->push_back(node);
+        ++fetched;
+        endInsertRows();
+    }
+    pathChanged(parentNode);
+    return list ? index(row, 0, parentIndex) : QModelIndex();
+}
+
+void HierarchyModel::removeNode(const QModelIndex &index)
+{
+    if (!index.isValid())
+        return;
+    const uint32_t node = nodeOf(index);
+    const uint32_t parentNode = table.parent(node);
+    const int row = int(rowInParent[node]);
+    beginRemoveRows(index.parent(), row, row);
+    forgetChildren(node);
+    eraseRow(*children(parentNode), size_t(row));
+    table.removeNode(node);
+    endRemoveRows();
+    pathChanged(parentNode);
+}
+
+bool HierarchyModel::moveNode(const QModelIndex &index, const QModelIndex &newParent)
+{
+    if (!index.isValid())
+        return false;
+    const QModelIndex sourceParent = index.parent();
+    const QModelIndex targetParent = newParent.isValid() ? newParent.siblingAtColumn(0) : QModelIndex();
+    const uint32_t node = nodeOf(index);
+    const uint32_t oldParent = table.parent(node);
+    const uint32_t parentNode = nodeOf(targetParent);
+    if (table.contains(node, parentNode))
+        return false;
+    const int row = int(rowInParent[node]);
+
+    if (!children(parentNode) && table.childCount(parentNode) == 0)
+        childLists.emplace(parentNode, std::vector<uint32_t>());
+    std::vector<uint32_t> *target = children(parentNode);
+    if (target) {
+        // Déjà dernier de ses frères: rien ne bouge
+        if (oldParent == parentNode && size_t(row) + 1 == target->size())
+            return true;
+        if (!beginMoveRows(sourceParent, row, row, targetParent, int(target->size())))
+            return false;
+        eraseRow(*children(oldParent), size_t(row));
+        table.moveNode(node, parentNode);
+        rowInParent[node] = uint32_t(target->size());
+        target->push_back(node);
+        ++fetched;
+        endMoveRows();
+    } else {
+        // Destination repliée: le nœud quitte la vue jusqu'à son dépliage
+        beginRemoveRows(sourceParent, row, row);
+        forgetChildren(node);
+        eraseRow(*children(oldParent), size_t(row));
+        table.moveNode(node, parentNode);
+        endRemoveRows();
+    }
+    pathChanged(oldParent);
+    pathChanged(parentNode);
+    return true;
+}
+
+QVariant HierarchyModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QVariant();
+    return headers.value(section);
+}
+
+void HierarchyModel::setNodes(NodeTable nodes)
+{
+    beginResetModel();
+    table = std::move(nodes);
+    if (!table.hasRollups())
+        table.computeRollups();
+    childLists.clear();
+    rowInParent.assign(table.size(), 0);
+    fetched = 0;
+    // Le premier niveau est présenté d'emblée
+    childLists.emplace(NodeTable::NoNode, collectChildren(NodeTable::NoNode));
+    endResetModel();
+}
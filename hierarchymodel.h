@@ -0,0 +1,83 @@
+// hierarchymodel.h
+#ifndef HIERARCHYMODEL_H
+#define HIERARCHYMODEL_H
+
+#include "nodetable.h"
+
+#include <QAbstractItemModel>
+#include <QStringList>
+
+#include <unordered_map>
+#include <vector>
+
+// Modèle d'arbre au-dessus d'une NodeTable. Les enfants d'un nœud ne sont
+// présentés à la vue qu'à son premier dépliage (canFetchMore/fetchMore):
+// le coût d'ouverture dépend de ce qui est affiché, pas de la taille de
+// l'arbre. L'index porte le numéro du nœud, rien n'est alloué par nœud
+// tant qu'il n'est pas visible.
+//
+// Les dossiers affichent le cumul de leurs descendants (Valeur: somme,
+// puis nombre et extrêmes); une modification ne rafraîchit que les lignes
+// du chemin vers la racine.
+class HierarchyModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { Element, Type, Valeur, Nombre, Minimum, Maximum, ColumnCount };
+
+    explicit HierarchyModel(QObject *parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    // Seule la Valeur d'une feuille se modifie (celle d'un dossier est un cumul)
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    const NodeTable &nodes() const { return table; }
+    // Remplace l'arbre et calcule les cumuls; seuls les nœuds de premier
+    // niveau sont présentés
+    void setNodes(NodeTable nodes);
+
+    // Ajoute un nœud en dernier enfant de parent; renvoie son index s'il est affiché
+    QModelIndex insertNode(const QModelIndex &parent, const QString &name, const QString &kind, double valeur);
+    void removeNode(const QModelIndex &index);
+    // Déplace le nœud sous newParent (en dernier); refusé vers son propre sous-arbre
+    bool moveNode(const QModelIndex &index, const QModelIndex &newParent);
+
+    // Nœud d'un index, NodeTable::NoNode pour la racine invisible
+    uint32_t nodeOf(const QModelIndex &index) const;
+    // Nœuds présentés à la vue jusqu'ici
+    size_t fetchedCount() const { return fetched; }
+
+private:
+    NodeTable table;
+    QStringList headers;
+    // Enfants présentés, par parent déplié (NoNode: premier niveau)
+    std::unordered_map<uint32_t, std::vector<uint32_t>> childLists;
+    // Rang de chaque nœud parmi ses frères, rempli quand son parent est déplié
+    std::vector<uint32_t> rowInParent;
+    size_t fetched = 0;
+
+    const std::vector<uint32_t> *children(uint32_t node) const;
+    std::vector<uint32_t> *children(uint32_t node);
+    std::vector<uint32_t> collectChildren(uint32_t node);
+    // Index d'un nœud affiché (parent déplié), invalide sinon
+    QModelIndex indexOf(uint32_t node, int column = 0) const;
+    // Oublie les listes d'enfants d'un sous-arbre qui quitte la vue
+    void forgetChildren(uint32_t node);
+    // Ligne retirée d'une liste d'enfants: les suivantes remontent
+    void eraseRow(std::vector<uint32_t> &list, size_t row);
+    // Cumuls changés de node jusqu'à la racine
+    void pathChanged(uint32_t node);
+};
+
+#endif // HIERARCHYMODEL_H
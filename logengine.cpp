@@ -0,0 +1,143 @@
+// logengine.cpp
+#include "logengine.h"
+#include "logwriter.h"
+
+#include <algorithm>
+#include <chrono>
+
+const char *logLevelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Info:
+        return "INFO";
+    case LogLevel::Attention:
+        return "ATTENTION";
+    case LogLevel::Erreur:
+        return "ERREUR";
+    }
+    return "";
+}
+
+LogQueue::LogQueue(size_t capacity)
+    : cells(new Cell[capacity])
+    , mask(capacity - 1)
+{
+    for (size_t i = 0; i < capacity; ++i)
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool LogQueue::push(LogRecord &&record)
+{
+    // Une cellule est libre pour la position pos quand sa séquence vaut pos
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = std::move(record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogQueue::pop(LogRecord &record)
+{
+    // Consommateur unique: pas de concurrence sur dequeuePos
+    const size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell *cell = &cells[pos & mask];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (intptr_t(sequence) - intptr_t(pos + 1) < 0)
+        return false;
+    record = std::move(cell->record);
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool LogQueue::isEmpty() const
+{
+    const size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    return intptr_t(cells[pos & mask].sequence.load(std::memory_order_acquire)) - intptr_t(pos + 1) < 0;
+}
+
+LogBuffer::LogBuffer(size_t capacity)
+    : records(capacity)
+{
+}
+
+void LogBuffer::append(LogRecord &&record)
+{
+    if (size() == records.size())
+        dropFront(1);
+    levels[size_t(record.level)].push_back(end);
+    records[size_t(end % records.size())] = std::move(record);
+    ++end;
+}
+
+void LogBuffer::dropFront(size_t count)
+{
+    first += std::min<uint64_t>(count, end - first);
+    for (std::deque<uint64_t> &index : levels) {
+        while (!index.empty() && index.front() < first)
+            index.pop_front();
+    }
+}
+
+void LogBuffer::clear()
+{
+    first = end;
+    for (std::deque<uint64_t> &index : levels)
+        index.clear();
+}
+
+LogEngine &LogEngine::instance()
+{
+    static LogEngine engine;
+    return engine;
+}
+
+LogEngine::LogEngine()
+    : queue(QueueCapacity)
+{
+}
+
+LogEngine::~LogEngine() = default;
+
+std::unique_ptr<LogSink> LogEngine::setSink(std::unique_ptr<LogSink> sink)
+{
+    std::swap(currentSink, sink);
+    return sink;
+}
+
+void LogEngine::post(LogLevel level, std::string message)
+{
+    LogRecord record;
+    record.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.level = level;
+    record.message = std::move(message);
+    if (!queue.push(std::move(record)))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t LogEngine::drain(std::vector<LogRecord> &out, size_t max)
+{
+    size_t count = 0;
+    LogRecord record;
+    while (count < max && queue.pop(record)) {
+        if (currentSink)
+            currentSink->offer(record);
+        out.push_back(std::move(record));
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,126 @@
+// logengine.h
+#ifndef LOGENGINE_H
+#define LOGENGINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+class LogSink;
+
+enum class LogLevel : uint8_t { Info, Attention, Erreur };
+
+constexpr size_t LogLevelCount = 3;
+
+// "INFO", "ATTENTION", "ERREUR"
+const char *logLevelName(LogLevel level);
+
+// Un événement du journal, structuré dès sa création: le niveau n'est
+// jamais relu dans le texte
+struct LogRecord
+{
+    int64_t timestamp = 0;   // millisecondes depuis le 1970-01-01 (UTC)
+    LogLevel level = LogLevel::Info;
+    std::string message;
+};
+
+// File sans verrou à capacité fixe, plusieurs producteurs et un seul
+// consommateur (cellules numérotées à la Vyukov). Un producteur ne
+// bloque jamais: si la file est pleine, push() échoue.
+class LogQueue
+{
+public:
+    // capacity: puissance de 2
+    explicit LogQueue(size_t capacity);
+
+    LogQueue(const LogQueue &) = delete;
+    LogQueue &operator=(const LogQueue &) = delete;
+
+    bool push(LogRecord &&record);
+    bool pop(LogRecord &record);
+    // Côté consommateur: rien à lire pour l'instant
+    bool isEmpty() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{0};
+        LogRecord record;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+};
+
+// Derniers enregistrements du journal dans un anneau de capacité fixe.
+// Chaque enregistrement reçoit un numéro de séquence croissant; les index
+// par niveau gardent les numéros encore présents, ce qui permet de filtrer
+// sans parcourir l'anneau.
+class LogBuffer
+{
+public:
+    explicit LogBuffer(size_t capacity);
+
+    size_t capacity() const { return records.size(); }
+    size_t size() const { return size_t(end - first); }
+    uint64_t firstSequence() const { return first; }
+    uint64_t endSequence() const { return end; }
+
+    const LogRecord &at(uint64_t sequence) const { return records[size_t(sequence % records.size())]; }
+    const std::deque<uint64_t> &levelIndex(LogLevel level) const { return levels[size_t(level)]; }
+
+    // Ajoute en fin; le plus ancien est écrasé quand l'anneau est plein
+    void append(LogRecord &&record);
+    // Oublie les count plus anciens
+    void dropFront(size_t count);
+    void clear();
+
+private:
+    std::vector<LogRecord> records;
+    uint64_t first = 0;
+    uint64_t end = 0;
+    std::deque<uint64_t> levels[LogLevelCount];
+};
+
+// Point d'entrée du journal, utilisable depuis n'importe quel thread:
+// post() horodate et dépose l'enregistrement dans la file; le thread
+// graphique la vide par lots (LogModel). Quand la file est pleine,
+// l'enregistrement est abandonné et compté.
+//
+// drain() transmet aussi chaque enregistrement au puits continu s'il y en
+// a un: les producteurs ne paient qu'un seul dépôt, quel que soit le nombre
+// de destinations.
+class LogEngine
+{
+public:
+    static LogEngine &instance();
+
+    static constexpr size_t QueueCapacity = 65536;
+
+    void post(LogLevel level, std::string message);
+    // Retire au plus max enregistrements de la file
+    size_t drain(std::vector<LogRecord> &out, size_t max);
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Remplace le puits continu (nul: aucun) et renvoie l'ancien, à détruire
+    // par l'appelant. Comme drain(), réservé au thread consommateur.
+    std::unique_ptr<LogSink> setSink(std::unique_ptr<LogSink> sink);
+    LogSink *sink() const { return currentSink.get(); }
+
+private:
+    LogEngine();
+    ~LogEngine();
+
+    LogQueue queue;
+    std::unique_ptr<LogSink> currentSink;
+    std::atomic<uint64_t> dropped{0};
+};
+
+#endif // LOGENGINE_H
@@ -0,0 +1,145 @@
+// logmodel.cpp
+#include "logmodel.h"
+#include "profiler.h"
+
+#include <QColor>
+#include <QDateTime>
+#include <QTimer>
+
+#include <algorithm>
+
+LogModel::LogModel(size_t capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , buffer(capacity)
+    , frameTimer(new QTimer(this))
+    , maxPerFrame(std::min(capacity, MaxPerFrame))
+{
+    pending.reserve(maxPerFrame + 1);
+    frameTimer->setInterval(FrameIntervalMs);
+    connect(frameTimer, &QTimer::timeout, this, &LogModel::drain);
+    frameTimer->start();
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    if (filter < 0)
+        return int(buffer.size());
+    return int(buffer.levelIndex(LogLevel(filter)).size());
+}
+
+uint64_t LogModel::sequenceAt(int row) const
+{
+    if (filter < 0)
+        return buffer.firstSequence() + uint64_t(row);
+    return buffer.levelIndex(LogLevel(filter))[size_t(row)];
+}
+
+int LogModel::rowsBefore(uint64_t sequence) const
+{
+    if (filter < 0)
+        return int(std::min(sequence, buffer.endSequence()) - buffer.firstSequence());
+    const std::deque<uint64_t> &index = buffer.levelIndex(LogLevel(filter));
+    return int(std::lower_bound(index.begin(), index.end(), sequence) - index.begin());
+}
+
+QString LogModel::format(const LogRecord &record)
+{
+    return QString("%1 [%2] %3")
+        .arg(QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("hh:mm:ss.zzz"),
+             QString::fromLatin1(logLevelName(record.level)),
+             QString::fromUtf8(record.message.data(), qsizetype(record.message.size())));
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+    const LogRecord &record = buffer.at(sequenceAt(index.row()));
+    switch (role) {
+    case Qt::DisplayRole:
+        return format(record);
+    case Qt::ForegroundRole:
+        if (record.level == LogLevel::Erreur)
+            return QColor(220, 50, 50);
+        if (record.level == LogLevel::Attention)
+            return QColor(200, 130, 0);
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::setLevelFilter(int level)
+{
+    if (level == filter)
+        return;
+    beginResetModel();
+    filter = level;
+    endResetModel();
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    buffer.clear();
+    endResetModel();
+}
+
+std::vector<LogRecord> LogModel::snapshot() const
+{
+    const int rows = rowCount();
+    std::vector<LogRecord> records;
+    records.reserve(size_t(rows));
+    for (int row = 0; row < rows; ++row)
+        records.push_back(buffer.at(sequenceAt(row)));
+    return records;
+}
+
+void LogModel::drain()
+{
+    PROFILE_SCOPE_AS(scope, "Journal: ingestion");
+    pending.clear();
+    LogEngine &engine = LogEngine::instance();
+    engine.drain(pending, maxPerFrame);
+
+    // Enregistrements perdus (file pleine) signalés une fois, dans le journal
+    const uint64_t dropped = engine.droppedCount();
+    if (dropped != reportedDropped) {
+        LogRecord record;
+        record.timestamp = QDateTime::currentMSecsSinceEpoch();
+        record.level = LogLevel::Attention;
+        record.message = QString("%1 messages perdus (file du journal pleine)")
+                             .arg(dropped - reportedDropped).toStdString();
+        pending.push_back(std::move(record));
+        reportedDropped = dropped;
+    }
+    if (pending.empty())
+        return;
+    scope.addItems(pending.size());
+
+    // Les plus anciens cèdent leur place avant l'ajout: une suppression en tête
+    const size_t incoming = std::min(pending.size(), buffer.capacity());
+    const size_t skipped = pending.size() - incoming;
+    const size_t overflow = buffer.size() + incoming > buffer.capacity()
+                          ? buffer.size() + incoming - buffer.capacity() : 0;
+    if (overflow > 0) {
+        const int removed = rowsBefore(buffer.firstSequence() + overflow);
+        if (removed > 0)
+            beginRemoveRows(QModelIndex(), 0, removed - 1);
+        buffer.dropFront(overflow);
+        if (removed > 0)
+            endRemoveRows();
+    }
+
+    const int added = int(std::count_if(pending.begin() + qsizetype(skipped), pending.end(),
+                                        [this](const LogRecord &record) { return accepts(record.level); }));
+    const int first = rowCount();
+    if (added > 0)
+        beginInsertRows(QModelIndex(), first, first + added - 1);
+    for (size_t i = skipped; i < pending.size(); ++i)
+        buffer.append(std::move(pending[i]));
+    if (added > 0)
+        endInsertRows();
+}
@@ -0,0 +1,61 @@
+// logmodel.h
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include "logengine.h"
+
+#include <QAbstractListModel>
+
+#include <vector>
+
+class QTimer;
+
+// Journal affiché par une vue de liste (une ligne par enregistrement, seules
+// les lignes visibles sont dessinées). La file du LogEngine est vidée une
+// fois par image: les arrivées d'une image forment une seule insertion, les
+// plus anciens évincés de l'anneau une seule suppression en tête.
+//
+// Le filtre de niveau s'appuie sur les index par niveau du LogBuffer: la
+// ligne k est directement le k-ième enregistrement du niveau choisi.
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr size_t DefaultCapacity = 100000;
+    static constexpr int FrameIntervalMs = 16;
+    // Au plus par image, pour garder la main au thread graphique
+    static constexpr size_t MaxPerFrame = 20000;
+
+    explicit LogModel(size_t capacity = DefaultCapacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    const LogBuffer &records() const { return buffer; }
+    // -1: tous les niveaux, sinon un LogLevel
+    int levelFilter() const { return filter; }
+    void setLevelFilter(int level);
+    void clear();
+    // Copie des enregistrements affichés (niveau filtré), du plus ancien au plus récent
+    std::vector<LogRecord> snapshot() const;
+
+    // Texte d'une ligne: "hh:mm:ss.zzz [NIVEAU] message"
+    static QString format(const LogRecord &record);
+
+private:
+    LogBuffer buffer;
+    QTimer *frameTimer;
+    int filter = -1;
+    size_t maxPerFrame;
+    std::vector<LogRecord> pending;
+    uint64_t reportedDropped = 0;
+
+    bool accepts(LogLevel level) const { return filter < 0 || int(level) == filter; }
+    uint64_t sequenceAt(int row) const;
+    // Lignes affichées dont la séquence précède sequence
+    int rowsBefore(uint64_t sequence) const;
+    void drain();
+};
+
+#endif // LOGMODEL_H
@@ -0,0 +1,299 @@
+// logwriter.cpp
+#include "logwriter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+#include <array>
+#include <chrono>
+
+namespace {
+
+const std::array<quint32, 256> &crcTable()
+{
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> values{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0);
+            values[i] = crc;
+        }
+        return values;
+    }();
+    return table;
+}
+
+quint32 crc32(const char *data, size_t size)
+{
+    const std::array<quint32, 256> &table = crcTable();
+    quint32 crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ uchar(data[i])) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void appendLittleEndian(QByteArray &out, quint32 value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+        out.append(char((value >> shift) & 0xFF));
+}
+
+// Un membre gzip (RFC 1952) autour du flux deflate produit par qCompress:
+// celui-ci renvoie la taille (4 octets) puis un flux zlib, dont on garde
+// le contenu sans l'en-tête (2 octets) ni la somme Adler-32 (4 octets)
+QByteArray gzipMember(const char *data, size_t size)
+{
+    const QByteArray packed = qCompress(reinterpret_cast<const uchar *>(data), qsizetype(size), 1);
+    static const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'};
+    QByteArray member;
+    member.reserve(packed.size() + 12);
+    member.append(header, sizeof(header));
+    member.append(packed.constData() + 6, packed.size() - 10);
+    appendLittleEndian(member, crc32(data, size));
+    appendLittleEndian(member, quint32(size));
+    return member;
+}
+
+} // namespace
+
+LogFileWriter::LogFileWriter(const QString &fileName, const LogFileOptions &options)
+    : fileName(fileName)
+    , options(options)
+{
+    buffer.reserve(options.bufferBytes + 4096);
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    close();
+}
+
+bool LogFileWriter::open(QString *errorMessage)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = file.errorString();
+        if (errorMessage)
+            *errorMessage = error;
+        return false;
+    }
+    fileBytes = 0;
+    return true;
+}
+
+bool LogFileWriter::write(const LogRecord &record)
+{
+    if (!file.isOpen()) {
+        ++discarded;
+        return false;
+    }
+    const int64_t second = record.timestamp >= 0 ? record.timestamp / 1000 : (record.timestamp - 999) / 1000;
+    if (second != formattedSecond) {
+        formattedSecond = second;
+        secondText = QDateTime::fromSecsSinceEpoch(second).toString("yyyy-MM-dd hh:mm:ss").toStdString();
+    }
+    const int millis = int(record.timestamp - second * 1000);
+    buffer += secondText;
+    buffer += '.';
+    buffer += char('0' + millis / 100);
+    buffer += char('0' + millis / 10 % 10);
+    buffer += char('0' + millis % 10);
+    buffer += " [";
+    buffer += logLevelName(record.level);
+    buffer += "] ";
+    buffer += record.message;
+    buffer += '\n';
+    ++bufferedRecords;
+    return buffer.size() < options.bufferBytes || flush();
+}
+
+bool LogFileWriter::flush()
+{
+    if (buffer.empty())
+        return true;
+    if (!file.isOpen()) {
+        discarded += bufferedRecords;
+        bufferedRecords = 0;
+        buffer.clear();
+        return false;
+    }
+    qint64 size;
+    if (options.compression == LogFileOptions::Gzip) {
+        const QByteArray member = gzipMember(buffer.data(), buffer.size());
+        size = file.write(member);
+        if (size != member.size())
+            size = -1;
+    } else {
+        size = file.write(buffer.data(), qint64(buffer.size()));
+        if (size != qint64(buffer.size()))
+            size = -1;
+    }
+    buffer.clear();
+    if (size < 0) {
+        discarded += bufferedRecords;
+        bufferedRecords = 0;
+        error = file.errorString();
+        return false;
+    }
+    bufferedRecords = 0;
+    fileBytes += size;
+    totalBytes += size;
+    if (options.maxFileBytes > 0 && fileBytes >= options.maxFileBytes)
+        return rotate();
+    return true;
+}
+
+uint64_t LogFileWriter::takeDiscarded()
+{
+    const uint64_t count = discarded;
+    discarded = 0;
+    return count;
+}
+
+void LogFileWriter::close()
+{
+    if (!file.isOpen())
+        return;
+    flush();
+    file.close();
+}
+
+QString LogFileWriter::rotatedName(int index) const
+{
+    // journal.log.gz -> journal.1.log.gz
+    const QFileInfo info(fileName);
+    QString name = info.baseName() + '.' + QString::number(index);
+    if (!info.completeSuffix().isEmpty())
+        name += '.' + info.completeSuffix();
+    return info.dir().filePath(name);
+}
+
+bool LogFileWriter::rotate()
+{
+    file.close();
+    bool rotated;
+    if (options.maxFiles <= 1) {
+        rotated = QFile::remove(fileName);
+    } else {
+        const QString oldest = rotatedName(options.maxFiles - 1);
+        rotated = !QFile::exists(oldest) || QFile::remove(oldest);
+        for (int index = options.maxFiles - 2; rotated && index >= 1; --index) {
+            const QString from = rotatedName(index);
+            rotated = !QFile::exists(from) || QFile::rename(from, rotatedName(index + 1));
+        }
+        rotated = rotated && QFile::rename(fileName, rotatedName(1));
+    }
+    if (rotated)
+        return open();
+
+    // Le fichier actif est gardé: la rotation sera retentée au vidage suivant
+    error = "rotation impossible de " + fileName;
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        error = file.errorString();
+    return false;
+}
+
+LogSink::LogSink(const QString &fileName, const LogFileOptions &options)
+    : name(fileName)
+    , queue(QueueCapacity)
+    , writer(fileName, options)
+{
+}
+
+LogSink::~LogSink()
+{
+    stop();
+}
+
+void LogSink::stop()
+{
+    stopping.store(true, std::memory_order_relaxed);
+    wake();
+    if (thread.joinable())
+        thread.join();
+}
+
+bool LogSink::start(QString *errorMessage)
+{
+    if (!writer.open(errorMessage))
+        return false;
+    thread = std::thread([this]() { run(); });
+    return true;
+}
+
+void LogSink::offer(const LogRecord &record)
+{
+    LogRecord copy = record;
+    if (!queue.push(std::move(copy))) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wake();
+}
+
+void LogSink::wake()
+{
+    // Avec la barrière de run(): soit le thread voit l'enregistrement (ou
+    // l'arrêt) avant de dormir, soit on le voit endormi et on le réveille
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping.load(std::memory_order_relaxed))
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    wakeup.notify_one();
+}
+
+void LogSink::run()
+{
+    using Clock = std::chrono::steady_clock;
+    LogRecord record;
+    Clock::time_point lastWrite = Clock::now();
+    for (;;) {
+        // Lu avant de vider la file: après l'arrêt, plus rien n'y arrive
+        const bool last = stopping.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (queue.pop(record)) {
+            if (!writer.write(record))
+                failed.store(true, std::memory_order_relaxed);
+            ++count;
+        }
+        written.fetch_add(count, std::memory_order_relaxed);
+        settleDiscarded();
+        if (last)
+            break;
+        if (count > 0)
+            lastWrite = Clock::now();
+        const auto idleFlush = lastWrite + std::chrono::milliseconds(IdleFlushMs);
+        if (count == 0 && writer.hasPendingData() && Clock::now() >= idleFlush) {
+            if (!writer.flush())
+                failed.store(true, std::memory_order_relaxed);
+            settleDiscarded();
+        }
+
+        // Attente d'un enregistrement, de l'arrêt ou du vidage différé
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue.isEmpty() && !stopping.load(std::memory_order_relaxed)) {
+            if (writer.hasPendingData())
+                wakeup.wait_until(lock, idleFlush);
+            else
+                wakeup.wait(lock);
+        }
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+    writer.close();
+    settleDiscarded();
+}
+
+void LogSink::settleDiscarded()
+{
+    // Déjà comptés comme écrits au moment où ils ont été pris dans la file
+    const uint64_t lost = writer.takeDiscarded();
+    if (lost == 0)
+        return;
+    failed.store(true, std::memory_order_relaxed);
+    written.fetch_sub(lost, std::memory_order_relaxed);
+    dropped.fetch_add(lost, std::memory_order_relaxed);
+}
@@ -0,0 +1,128 @@
+// logwriter.h
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include "logengine.h"
+
+#include <QFile>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct LogFileOptions
+{
+    enum Compression { NoCompression, Gzip };
+
+    Compression compression = NoCompression;
+    // Taille déclenchant la rotation (0: jamais) et fichiers gardés, l'actif compris
+    qint64 maxFileBytes = 0;
+    int maxFiles = 5;
+    size_t bufferBytes = 1 << 20;
+};
+
+// Écriture séquentielle de lignes "aaaa-mm-jj hh:mm:ss.zzz [NIVEAU] message".
+// Les lignes s'accumulent dans un tampon de bufferBytes vidé en une seule
+// écriture; en Gzip, chaque vidage devient un membre gzip complet (un
+// fichier gzip peut en enchaîner plusieurs), compressé à la volée.
+//
+// Rotation: quand le fichier actif dépasse maxFileBytes, journal.log
+// devient journal.1.log, journal.1.log devient journal.2.log... au-delà
+// de maxFiles, le plus ancien est supprimé. Si un renommage échoue,
+// l'écriture continue dans le fichier actif et la rotation est retentée
+// au vidage suivant.
+class LogFileWriter
+{
+public:
+    LogFileWriter(const QString &fileName, const LogFileOptions &options);
+    ~LogFileWriter();
+
+    LogFileWriter(const LogFileWriter &) = delete;
+    LogFileWriter &operator=(const LogFileWriter &) = delete;
+
+    bool open(QString *errorMessage = nullptr);
+    bool write(const LogRecord &record);
+    bool flush();
+    void close();
+
+    bool hasPendingData() const { return !buffer.empty(); }
+    // Enregistrements perdus (fichier fermé ou écriture en échec) depuis
+    // l'appel précédent: le tampon est vidé plutôt que de grandir
+    uint64_t takeDiscarded();
+    QString errorString() const { return error; }
+    // Octets écrits sur disque (après compression), tous fichiers confondus
+    qint64 bytesWritten() const { return totalBytes; }
+
+private:
+    QFile file;
+    QString fileName;
+    LogFileOptions options;
+    std::string buffer;
+    size_t bufferedRecords = 0;
+    uint64_t discarded = 0;
+    qint64 fileBytes = 0;
+    qint64 totalBytes = 0;
+    QString error;
+    // Horodatage à la seconde déjà mis en forme
+    int64_t formattedSecond = -1;
+    std::string secondText;
+
+    QString rotatedName(int index) const;
+    bool rotate();
+};
+
+// Copie continue du journal dans un fichier, écrite par un thread dédié.
+// Le LogEngine lui transmet chaque enregistrement qu'il distribue; offer()
+// ne fait que le déposer dans une file sans verrou: personne n'attend le
+// disque. Si l'écriture prend du retard et que la file est pleine,
+// l'enregistrement est abandonné et compté. File vide, le thread dort sur
+// une variable condition; offer() ne prend le verrou pour le réveiller que
+// s'il dort.
+class LogSink
+{
+public:
+    static constexpr size_t QueueCapacity = 65536;
+    // Sans nouvel enregistrement, le tampon est vidé au plus tard après ce délai
+    static constexpr int IdleFlushMs = 500;
+
+    LogSink(const QString &fileName, const LogFileOptions &options);
+    // Écrit ce qui reste dans la file puis ferme le fichier
+    ~LogSink();
+
+    LogSink(const LogSink &) = delete;
+    LogSink &operator=(const LogSink &) = delete;
+
+    bool start(QString *errorMessage = nullptr);
+    // Écrit ce qui reste dans la file, ferme le fichier et arrête le thread.
+    // Bloquant (vidage, compression): à appeler hors du thread graphique
+    void stop();
+    void offer(const LogRecord &record);
+
+    const QString &fileName() const { return name; }
+    uint64_t writtenCount() const { return written.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    bool hasFailed() const { return failed.load(std::memory_order_relaxed); }
+
+private:
+    QString name;
+    LogQueue queue;
+    LogFileWriter writer;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+
+    void run();
+    void wake();
+    // Enregistrements perdus par l'écrivain: comptés comme abandonnés
+    void settleDiscarded();
+};
+
+#endif // LOGWRITER_H
@@ -6,7 +6,8 @@
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QTabWidget>
-#include <QTableWidget>
+#include <QTableView>
+#include <QHeaderView>
 #include <QTreeWidget>
 #include <QListWidget>
 #include <QPushButton>
@@ -30,7 +31,46 @@
 #include <QColorDialog>
 #include <QFontDialog>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QSystemTrayIcon>
+#include <QShortcut>
+#include <QUndoStack>
+#include <QUndoGroup>
+#include <QTabBar>
+#include <QInputDialog>
+#include <QClipboard>
+
+#include "datadocument.h"
+#include "datatablemodel.h"
+#include "fileloader.h"
+#include "datfile.h"
+#include "searchcontroller.h"
+#include "dataview.h"
+#include "datacommands.h"
+#include "csvparser.h"
+#include "summarycontroller.h"
+#include "hierarchymodel.h"
+#include "logmodel.h"
+#include "logwriter.h"
+#include "taskscheduler.h"
+#include "perfmonitor.h"
+#include "sessionstate.h"
+#include "theme.h"
+#include "feedcontroller.h"
+#include "viewexport.h"
+#include "memorybudget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+// Chronomètre lancé à l'entrée de main(): délai jusqu'au premier affichage
+static QElapsedTimer &startupClock()
+{
+    static QElapsedTimer clock;
+    return clock;
+}
 
 class AdvancedMainWindow : public QMainWindow
 {
@@ -39,88 +79,735 @@ class AdvancedMainWindow : public QMainWindow
 private:
     // Widgets principaux
     QTabWidget *centralTabs;
-    QTableWidget *dataTable;
-    QTreeWidget *hierarchyTree;
-    QTextEdit *logOutput;
+    QTableView *dataTable;
+    QTreeView *hierarchyTree = nullptr;
+    HierarchyModel *hierarchyModel = nullptr;
+    QTextEdit *nodeDetails = nullptr;
+    QPersistentModelIndex cutNode;
+    QListView *logView = nullptr;
+    LogModel *logModel;
+    QCheckBox *continuousLogCheck = nullptr;
+    bool logFollowsTail = true;
+    
+    // Documents ouverts, un onglet chacun au-dessus du tableau. dataModel,
+    // dataView, undoStack, searchController et summaryController désignent
+    // les parties du document actif.
+    QTabBar *documentBar;
+    std::vector<DataDocument *> documents;
+    DataDocument *document = nullptr;
+    DataTableModel *dataModel = nullptr;
+    DataView *dataView = nullptr;
+    QUndoStack *undoStack = nullptr;
+    QUndoGroup *undoGroup;
+    int untitledCount = 0;
+    bool restoringHeader = false;
+    // Période du filtre, commune à tous les documents
+    DateRange period;
+    // Mémoire des documents inactifs rendue au-delà du budget
+    MemoryBudget *memoryBudget;
+    QLabel *memoryLabel;
     
     // Contrôles
     QLineEdit *searchBox;
+    QLabel *matchLabel;
     QComboBox *categoryCombo;
-    QProgressBar *progressBar;
-    QSlider *volumeSlider;
+    QProgressBar *progressBar = nullptr;
+    QSlider *volumeSlider = nullptr;
     QLabel *statusLabel;
+    QLineEdit *quickSearch;
+    
+    // Synthèse de la colonne Valeur sur les lignes affichées
+    SummaryController *summaryController = nullptr;
+    QVector<QLabel *> summaryFields;
+    QComboBox *groupByCombo;
+    QTreeWidget *groupTree;
+    QLabel *summaryTimeLabel;
     
     // Actions et menus
-    QAction *newAction, *openAction, *saveAction, *exitAction;
+    QAction *newAction, *openAction, *saveAction, *exportAction, *closeAction, *exitAction;
     QAction *aboutAction, *settingsAction;
+    QAction *addComputedAction, *removeComputedAction;
     QToolBar *mainToolBar;
-    QTimer *updateTimer;
+    
+    // Opérations longues: exécution, avancement et panneau des tâches
+    TaskScheduler *taskScheduler;
+    QProgressBar *permProgressBar;
+    QTreeWidget *taskTree = nullptr;
+    
+    // Onglets construits à leur première activation (vide: déjà construit)
+    std::vector<std::function<void(QWidget *)>> tabBuilders;
+    // Fenêtre, session et style du lancement précédent
+    SessionState session;
+    bool firstPaintDone = false;
+    // Couleurs et police de l'application (palette, sans feuille de style)
+    ThemeManager *theme;
+    
+    // Panneau de performances (mesures actives seulement quand il est visible)
+    PerfMonitor *perfMonitor;
+    QDockWidget *perfDock;
+    QLabel *perfSummaryLabel;
+    QTreeWidget *perfTree;
+    QCheckBox *traceCheck;
+    
+    // Flux de données en direct (socket local)
+    FeedController *feedController;
+    QPointer<DataDocument> feedDocument;
+    QAction *feedListenAction;
+    QAction *feedGeneratorAction;
+    QLabel *feedLabel;
+    
+    // Recherche parallèle
+    SearchController *searchController = nullptr;
+    QTimer *searchDelay;
+    int currentMatch = -1;
+    
+    // Au-delà, Type n'est pas une catégorie mais une valeur libre
+    static constexpr size_t MaxCategoryChoices = 100;
+    // Groupes affichés dans la synthèse (les plus nombreux)
+    static constexpr size_t MaxSummaryGroups = 100;
+    // Rotation du journal continu
+    static constexpr qint64 MaxLogFileBytes = 64 << 20;
+    static constexpr int MaxLogFiles = 5;
+    // Socket local du flux (tube nommé sous Windows)
+    static constexpr const char *FeedServerName = "interfaceqt-flux";
 
 public:
     AdvancedMainWindow(QWidget *parent = nullptr) : QMainWindow(parent)
     {
+        session.load(SessionState::defaultFileName());
+        theme = new ThemeManager(this);
+        
         setupUI();
         setupMenus();
         setupToolBar();
         setupStatusBar();
         setupConnections();
-        setupTimer();
+        activateDocument(documents.front());
         
-        setWindowTitle("Gestionnaire de Données Avancé");
-        setWindowIcon(QIcon(":/icons/app.png"));
         resize(1200, 800);
+        restoreSession();
+    }
+    
+    ~AdvancedMainWindow()
+    {
+        // Le récepteur du flux tourne dans sa boucle d'événements: arrêt explicite
+        feedController->stop();
+        // Les chargements encore actifs doivent se terminer avant destruction
+        // (les tâches de la réserve sont attendues par le planificateur)
+        for (QThread *thread : findChildren<QThread *>()) {
+            thread->requestInterruption();
+            thread->wait();
+        }
+        // Le puits continu écrit ce qui lui reste puis ferme son fichier
+        LogEngine::instance().setSink(nullptr);
+    }
+
+protected:
+    void closeEvent(QCloseEvent *event) override
+    {
+        saveSession();
+        QMainWindow::closeEvent(event);
+    }
+    
+    // Le traitement de la première demande de rafraîchissement dessine toute
+    // la fenêtre: c'est la fin du démarrage vue par l'utilisateur
+    bool event(QEvent *event) override
+    {
+        const bool handled = QMainWindow::event(event);
+        if (!firstPaintDone && event->type() == QEvent::UpdateRequest) {
+            firstPaintDone = true;
+            logMessage(LogLevel::Info, QString("Premier affichage %1 ms après le lancement")
+                                           .arg(startupClock().elapsed()));
+        }
+        return handled;
     }
 
 private slots:
     void onNewFile()
     {
-        QMessageBox::information(this, "Nouveau", "Création d'un nouveau fichier...");
-        progressBar->setValue(0);
-        updateTimer->start(100);
+        activateDocument(addDocument(QString("Sans titre %1").arg(++untitledCount)));
+        logMessage(LogLevel::Info, "Nouveau document");
     }
     
     void onOpenFile()
     {
         QString fileName = QFileDialog::getOpenFileName(this,
-            "Ouvrir un fichier", "", "Tous les fichiers (*.*)");
+            "Ouvrir un fichier", session.lastDirectory,
+            "Fichiers de données (*.csv *.dat *.txt);;Tous les fichiers (*.*)");
         if (!fileName.isEmpty()) {
-            logOutput->append("Fichier ouvert: " + fileName);
+            session.lastDirectory = QFileInfo(fileName).absolutePath();
+            logMessage(LogLevel::Info, "Fichier ouvert: " + fileName);
+            startLoading(fileName);
+        }
+    }
+    
+    void onBatchLoaded(DataDocument *doc, ColumnTablePtr batch)
+    {
+        doc->model()->appendTable(*batch);
+        if (doc->load.firstBatchPending) {
+            doc->load.firstBatchPending = false;
+            if (doc == document)
+                dataTable->resizeColumnsToContents();
+            logMessage(LogLevel::Info, QString("Premières lignes affichées en %1 ms").arg(doc->load.timer.elapsed()));
+        }
+    }
+    
+    void onTableLoaded(DataDocument *doc, ColumnTablePtr table)
+    {
+        doc->model()->setTable(*table);
+        doc->load.firstBatchPending = false;
+        if (doc == document)
+            dataTable->resizeColumnsToContents();
+    }
+    
+    void onLoadProgress(DataDocument *doc, qint64 bytesDone, qint64 bytesTotal)
+    {
+        if (!doc->load.task)
+            return;
+        doc->load.task->setTotal(bytesTotal);
+        doc->load.task->setDone(bytesDone);
+    }
+    
+    void onLoadFinished(DataDocument *doc, qint64 rows, qint64 errors, qint64 elapsedMs)
+    {
+        doc->load.loader = nullptr;
+        finishLoadTask(doc);
+        doc->search()->rebuildIndex(doc->model()->store().snapshot());
+        setControlsProgress(100);
+        logMessage(LogLevel::Info, QString("Chargement terminé (%1): %2 lignes en %3 ms")
+                                       .arg(doc->title()).arg(rows).arg(elapsedMs));
+        if (errors > 0)
+            logMessage(LogLevel::Attention, QString("%1 lignes ignorées (format invalide)").arg(errors));
+        if (doc == document) {
+            updateCategoryChoices();
+            statusLabel->setText(QString("%1 lignes").arg(dataModel->rowCount()));
         }
+        // Un document de plus en mémoire: les autres peuvent devoir céder la place
+        memoryBudget->check();
+    }
+    
+    void onLoadFailed(DataDocument *doc, const QString &message)
+    {
+        doc->load.loader = nullptr;
+        finishLoadTask(doc);
+        setControlsProgress(0);
+        logMessage(LogLevel::Erreur, "Chargement impossible: " + message);
+        QMessageBox::warning(this, "Erreur", "Impossible de charger le fichier:\n" + message);
     }
     
     void onSaveFile()
     {
+        const QString compressedFilter = "Fichiers de données compressés (*.dat)";
+        QString selectedFilter;
         QString fileName = QFileDialog::getSaveFileName(this,
-            "Sauvegarder", "", "Fichiers de données (*.dat)");
+            "Sauvegarder", session.lastDirectory, "Fichiers de données (*.dat);;" + compressedFilter, &selectedFilter);
         if (!fileName.isEmpty()) {
-            logOutput->append("Fichier sauvegardé: " + fileName);
+            session.lastDirectory = QFileInfo(fileName).absolutePath();
+            // Écriture en arrière-plan depuis un instantané des colonnes
+            const DatFile::Compression compression =
+                selectedFilter == compressedFilter ? DatFile::Zlib : DatFile::NoCompression;
+            ColumnTablePtr snapshot = dataModel->store().snapshot();
+            auto error = std::make_shared<QString>();
+            auto ok = std::make_shared<bool>(false);
+            QElapsedTimer timer;
+            timer.start();
+            
+            taskScheduler->run("Sauvegarde " + QFileInfo(fileName).fileName(), "blocs", TaskPriority::Bulk,
+                [snapshot, fileName, compression, error, ok](TaskContext &task) {
+                    *ok = DatFile::save(*snapshot, fileName, compression, error.get(),
+                                        [&task](qint64 done, qint64 total) {
+                                            task.setTotal(total);
+                                            task.setDone(done);
+                                            return !task.isCancelled();
+                                        });
+                },
+                [this, fileName, error, ok, timer](bool cancelled) {
+                    if (*ok) {
+                        setControlsProgress(100);
+                        logMessage(LogLevel::Info, QString("Fichier sauvegardé: %1 (%2 ms)").arg(fileName).arg(timer.elapsed()));
+                    } else if (cancelled) {
+                        logMessage(LogLevel::Attention, "Sauvegarde annulée: " + fileName);
+                    } else {
+                        logMessage(LogLevel::Erreur, "Sauvegarde impossible: " + *error);
+                        QMessageBox::warning(this, "Erreur", "Impossible de sauvegarder le fichier:\n" + *error);
+                    }
+                });
         }
     }
     
-    void onSearch()
+    // Lignes affichées (filtre, catégorie, période et tri), pas tout le tableau
+    void onExportView()
     {
-        QString searchText = searchBox->text();
-        if (!searchText.isEmpty()) {
-            logOutput->append("Recherche: " + searchText);
-            // Simulation de recherche dans le tableau
-            for (int i = 0; i < dataTable->rowCount(); ++i) {
-                for (int j = 0; j < dataTable->columnCount(); ++j) {
-                    QTableWidgetItem *item = dataTable->item(i, j);
-                    if (item && item->text().contains(searchText, Qt::CaseInsensitive)) {
-                        dataTable->selectRow(i);
-                        logOutput->append("Trouvé dans ligne " + QString::number(i + 1));
+        const QString csvFilter = "Fichiers CSV (*.csv)";
+        const QString compressedFilter = "Fichiers de données compressés (*.dat)";
+        QString selectedFilter;
+        const QString fileName = QFileDialog::getSaveFileName(this, "Exporter la vue", session.lastDirectory,
+            csvFilter + ";;Fichiers de données (*.dat);;" + compressedFilter, &selectedFilter);
+        if (fileName.isEmpty())
+            return;
+        session.lastDirectory = QFileInfo(fileName).absolutePath();
+        
+        const DataViewModel *proxy = dataView->model();
+        DataViewModel::RowList rows;
+        if (proxy->isRestricted())
+            rows = proxy->rows() ? proxy->rows() : std::make_shared<const std::vector<uint32_t>>();
+        ColumnTablePtr snapshot = dataModel->store().snapshot();
+        const bool csv = selectedFilter == csvFilter || fileName.endsWith(".csv", Qt::CaseInsensitive);
+        const DatFile::Compression compression =
+            selectedFilter == compressedFilter ? DatFile::Zlib : DatFile::NoCompression;
+        const qint64 rowCount = rows ? qint64(rows->size()) : qint64(snapshot->rowCount());
+        auto error = std::make_shared<QString>();
+        auto ok = std::make_shared<bool>(false);
+        QElapsedTimer timer;
+        timer.start();
+        
+        taskScheduler->run("Export " + QFileInfo(fileName).fileName(), csv ? "lignes" : "blocs", TaskPriority::Bulk,
+            [snapshot, rows, fileName, csv, compression, error, ok](TaskContext &task) {
+                auto progress = [&task](qint64 done, qint64 total) {
+                    task.setTotal(total);
+                    task.setDone(done);
+                    return !task.isCancelled();
+                };
+                if (csv)
+                    *ok = ViewExport::writeCsv(*snapshot, rows.get(), fileName, ';', error.get(), progress);
+                else
+                    *ok = ViewExport::writeDat(*snapshot, rows.get(), fileName, compression, error.get(), progress);
+            },
+            [this, fileName, rowCount, error, ok, timer](bool cancelled) {
+                if (*ok) {
+                    logMessage(LogLevel::Info, QString("Vue exportée: %1 (%2 lignes, %3 ms)")
+                                                   .arg(fileName).arg(rowCount).arg(timer.elapsed()));
+                } else if (cancelled) {
+                    logMessage(LogLevel::Attention, "Export annulé: " + fileName);
+                } else {
+                    logMessage(LogLevel::Erreur, "Export impossible: " + *error);
+                    QMessageBox::warning(this, "Erreur", "Impossible d'exporter la vue:\n" + *error);
+                }
+            });
+    }
+    
+    void onSaveLog()
+    {
+        const QString compressedFilter = "Journal compressé (*.log.gz)";
+        QString selectedFilter;
+        const QString fileName = QFileDialog::getSaveFileName(this,
+            "Sauvegarder Log", "", "Journal (*.log);;" + compressedFilter, &selectedFilter);
+        if (fileName.isEmpty())
+            return;
+        
+        // Copie des lignes affichées, écrite en arrière-plan
+        auto records = std::make_shared<std::vector<LogRecord>>(logModel->snapshot());
+        LogFileOptions options;
+        options.compression = selectedFilter == compressedFilter ? LogFileOptions::Gzip : LogFileOptions::NoCompression;
+        auto error = std::make_shared<QString>();
+        auto ok = std::make_shared<bool>(false);
+        QElapsedTimer timer;
+        timer.start();
+        
+        taskScheduler->run("Export du journal", "lignes", TaskPriority::Bulk,
+            [records, fileName, options, error, ok](TaskContext &task) {
+                LogFileWriter writer(fileName, options);
+                if (!writer.open(error.get()))
+                    return;
+                task.setTotal(qint64(records->size()));
+                for (size_t i = 0; i < records->size(); ++i) {
+                    if (!writer.write((*records)[i])) {
+                        *error = writer.errorString();
                         return;
                     }
+                    if ((i + 1) % 4096 == 0) {
+                        task.setDone(qint64(i + 1));
+                        if (task.isCancelled())
+                            return;
+                    }
+                }
+                *ok = writer.flush();
+                if (!*ok)
+                    *error = writer.errorString();
+            },
+            [this, fileName, records, error, ok, timer](bool cancelled) {
+                if (*ok) {
+                    logMessage(LogLevel::Info, QString("Journal exporté: %1 (%2 lignes en %3 ms)")
+                                                   .arg(fileName).arg(records->size()).arg(timer.elapsed()));
+                } else if (cancelled) {
+                    QFile::remove(fileName);
+                    logMessage(LogLevel::Attention, "Export du journal annulé: " + fileName);
+                } else {
+                    logMessage(LogLevel::Erreur, "Export du journal impossible: " + *error);
+                    QMessageBox::warning(this, "Erreur", "Impossible d'exporter le journal:\n" + *error);
                 }
+            });
+    }
+    
+    void onContinuousLogToggled(bool enabled)
+    {
+        LogEngine &engine = LogEngine::instance();
+        if (!enabled) {
+            std::shared_ptr<LogSink> sink = engine.setSink(nullptr);
+            if (!sink)
+                return;
+            // Vidage de la file, compression et fermeture hors du thread graphique
+            taskScheduler->run("Arrêt du journal continu", "", TaskPriority::Bulk,
+                [sink](TaskContext &) { sink->stop(); },
+                [sink](bool) {
+                    const bool failed = sink->hasFailed();
+                    logMessage(failed ? LogLevel::Erreur : LogLevel::Info,
+                               QString("Écriture continue du journal arrêtée: %1 (%2 lignes écrites, %3 abandonnées%4)")
+                                   .arg(sink->fileName()).arg(sink->writtenCount()).arg(sink->droppedCount())
+                                   .arg(failed ? ", erreurs d'écriture" : ""));
+                });
+            return;
+        }
+        
+        const QString compressedFilter = "Journal compressé (*.log.gz)";
+        QString selectedFilter;
+        const QString fileName = QFileDialog::getSaveFileName(this,
+            "Écriture continue du journal", "", "Journal (*.log);;" + compressedFilter, &selectedFilter);
+        if (fileName.isEmpty()) {
+            continuousLogCheck->setChecked(false);
+            return;
+        }
+        LogFileOptions options;
+        options.compression = selectedFilter == compressedFilter ? LogFileOptions::Gzip : LogFileOptions::NoCompression;
+        options.maxFileBytes = MaxLogFileBytes;
+        options.maxFiles = MaxLogFiles;
+        auto sink = std::make_unique<LogSink>(fileName, options);
+        QString error;
+        if (!sink->start(&error)) {
+            continuousLogCheck->setChecked(false);
+            logMessage(LogLevel::Erreur, "Écriture continue du journal impossible: " + error);
+            return;
+        }
+        engine.setSink(std::move(sink));
+        logMessage(LogLevel::Info, "Écriture continue du journal: " + fileName);
+    }
+    
+    void onSearch()
+    {
+        QString searchText = searchBox->text();
+        searchDelay->stop();
+        dataModel->clearHighlights();
+        currentMatch = -1;
+        if (searchText.isEmpty()) {
+            searchController->cancel();
+            matchLabel->clear();
+            return;
+        }
+        matchLabel->setText("Recherche...");
+        searchController->search(searchText, dataModel->store().snapshot(), dataModel->store().version());
+    }
+    
+    void onMatchesAdded(DataDocument *doc, int first, int count)
+    {
+        const std::vector<uint32_t> &matches = doc->search()->matches();
+        doc->model()->addHighlights(matches.data() + first, size_t(count));
+        if (doc != document)
+            return;
+        if (currentMatch < 0)
+            showMatch(0);
+        else
+            updateMatchLabel();
+    }
+    
+    void onSearchFinished(DataDocument *doc, qint64 matchCount, qint64 elapsedMs)
+    {
+        if (doc != document) {
+            logMessage(LogLevel::Info, QString("Recherche: %1 (%2 résultats en %3 ms)")
+                                           .arg(doc->ui.searchText).arg(matchCount).arg(elapsedMs));
+            return;
+        }
+        logMessage(LogLevel::Info, QString("Recherche: %1 (%2 résultats en %3 ms)")
+                                       .arg(searchBox->text()).arg(matchCount).arg(elapsedMs));
+        if (matchCount == 0)
+            matchLabel->setText("Aucun résultat");
+        else
+            updateMatchLabel();
+    }
+    
+    void onNextMatch()
+    {
+        const int count = int(searchController->matches().size());
+        if (count > 0)
+            showMatch((currentMatch + 1) % count);
+    }
+    
+    void onPreviousMatch()
+    {
+        const int count = int(searchController->matches().size());
+        if (count > 0)
+            showMatch((currentMatch - 1 + count) % count);
+    }
+    
+    void onViewUpdated(qint64 visibleRows, qint64 elapsedMs)
+    {
+        if (dataView->textFilter().isEmpty() && dataView->category().isEmpty() && !dataView->dateRange().isValid()) {
+            statusLabel->setText(QString("%1 lignes").arg(dataModel->rowCount()));
+            return;
+        }
+        // Durée négative: vue reprise telle quelle à l'activation du document
+        if (elapsedMs < 0) {
+            statusLabel->setText(QString("%1 / %2 lignes").arg(visibleRows).arg(dataModel->rowCount()));
+            return;
+        }
+        statusLabel->setText(QString("%1 / %2 lignes (filtre: %3 ms)")
+                                 .arg(visibleRows).arg(dataModel->rowCount()).arg(elapsedMs));
+    }
+    
+    void onSummaryChanged(qint64 elapsedMs)
+    {
+        if (!summaryController->summary())
+            return;
+        showSummary();
+        summaryTimeLabel->setText(QString("Calcul: %1 ms%2")
+                                      .arg(elapsedMs).arg(SummaryEngine::usesAvx2() ? " (AVX2)" : ""));
+    }
+    
+    void onMemoryUsage(qint64 residentBytes, qint64 limitBytes)
+    {
+        memoryLabel->setText(limitBytes > 0
+            ? QString("Mémoire: %1 / %2 Mo").arg(residentBytes >> 20).arg(limitBytes >> 20)
+            : QString("Mémoire: %1 Mo").arg(residentBytes >> 20));
+        memoryLabel->setToolTip(QString("%1 documents ouverts").arg(documents.size()));
+    }
+    
+    // Synthèse du document actif telle que calculée (tirets: pas encore de calcul)
+    void showSummary()
+    {
+        const ValueSummary *summary = summaryController->summary();
+        if (!summary) {
+            for (QLabel *field : summaryFields)
+                field->setText("-");
+            groupTree->clear();
+            return;
+        }
+        const ValueStats &stats = summary->stats;
+        auto number = [](double value) { return QString::number(value, 'f', 2); };
+        const bool any = stats.count > 0;
+        summaryFields[0]->setText(QString::number(stats.count));
+        summaryFields[1]->setText(number(stats.sum));
+        summaryFields[2]->setText(any ? number(stats.mean()) : "-");
+        summaryFields[3]->setText(any ? number(stats.min) : "-");
+        summaryFields[4]->setText(any ? number(stats.max) : "-");
+        for (size_t i = 0; i < SummaryEngine::PercentileCount; ++i) {
+            QLabel *field = summaryFields[int(5 + i)];
+            if (!any)
+                field->setText("-");
+            else if (summary->percentiles.size() == SummaryEngine::PercentileCount)
+                field->setText(number(summary->percentiles[i]));
+            else
+                field->setText("...");
+        }
+        fillGroupTree(*summary);
+    }
+    
+    void onAddRow()
+    {
+        const ColumnTable &table = dataModel->store().table();
+        const size_t count = table.rowCount();
+        const QString type = categoryCombo->currentIndex() > 0 ? categoryCombo->currentText()
+                           : count > 0 ? dataModel->displayText(int(count) - 1, ColumnTable::Type)
+                                       : QString("Type A");
+        const QStringList texts = {
+            QString::number(count > 0 ? table.ids[count - 1] + 1 : 1),
+            "Nouvel élément",
+            type,
+            QDate::currentDate().toString(Qt::ISODate),
+            "Actif",
+            "0"
+        };
+        ColumnRows values;
+        for (int column = 0; column < ColumnTable::ColumnCount; ++column)
+            dataModel->encodeValue(column, texts[column], values);
+        values.rows.push_back(uint32_t(count));
+        undoStack->push(new InsertRowsCommand(dataModel, std::move(values)));
+        
+        // Saisie directe du nom si la ligne est visible (filtre)
+        const QModelIndex viewIndex = dataView->model()->mapFromSource(dataModel->index(int(count), ColumnTable::Nom));
+        if (viewIndex.isValid()) {
+            dataTable->setCurrentIndex(viewIndex);
+            dataTable->scrollTo(viewIndex);
+            dataTable->edit(viewIndex);
+        }
+    }
+    
+    void onEditRows()
+    {
+        const std::vector<uint32_t> rows = selectedSourceRows();
+        const QModelIndex current = dataTable->currentIndex();
+        if (rows.empty() || !current.isValid()) {
+            statusLabel->setText("Aucune ligne sélectionnée");
+            return;
+        }
+        if (rows.size() == 1) {
+            dataTable->edit(current);
+            return;
+        }
+        
+        if (dataModel->isComputedColumn(current.column())) {
+            statusLabel->setText("Colonne calculée: non modifiable");
+            return;
+        }
+        // Même valeur de la colonne courante pour toutes les lignes sélectionnées
+        const int column = current.column();
+        bool ok = false;
+        const QString text = QInputDialog::getText(this, "Modifier",
+            QString("Nouvelle valeur de « %1 » pour %2 lignes:")
+                .arg(dataModel->headerData(column, Qt::Horizontal).toString()).arg(rows.size()),
+            QLineEdit::Normal, current.data().toString(), &ok);
+        if (!ok)
+            return;
+        ColumnRows values;
+        if (!dataModel->encodeValue(column, text, values)) {
+            QMessageBox::warning(this, "Modifier", "Valeur invalide pour cette colonne: " + text);
+            return;
+        }
+        auto repeat = [&rows](auto &column) {
+            if (!column.empty())
+                column.assign(rows.size(), column.front());
+        };
+        repeat(values.ids);
+        repeat(values.noms);
+        repeat(values.types);
+        repeat(values.dates);
+        repeat(values.statuts);
+        repeat(values.valeurs);
+        values.rows = rows;
+        undoStack->push(new EditValuesCommand(dataModel, std::move(values), column));
+    }
+    
+    void onAddComputedColumn()
+    {
+        bool ok = false;
+        QString name = QInputDialog::getText(this, "Colonne calculée", "Nom de la colonne:", QLineEdit::Normal,
+            QString("Calcul %1").arg(dataModel->computedColumns().size() + 1), &ok).trimmed();
+        if (!ok || name.isEmpty())
+            return;
+        QString formula;
+        for (;;) {
+            formula = QInputDialog::getText(this, "Colonne calculée",
+                "Formule (colonnes Id, Nom, Type, Date, Statut, Valeur;\n"
+                "+ - * / = <> < <= > >= et ou non;\n"
+                "si, abs, arrondi, min, max, annee, mois, jour, trimestre, debut_mois, debut_annee),\n"
+                "par exemple: Valeur * 1.2, debut_mois(Date), Statut = \"Actif\"",
+                QLineEdit::Normal, formula, &ok);
+            if (!ok || formula.trimmed().isEmpty())
+                return;
+            // Vérifiée dès la saisie: une formule invalide est proposée à nouveau
+            QString error;
+            if (dataModel->addComputedColumn(name, formula, &error))
+                break;
+            QMessageBox::warning(this, "Colonne calculée", "Formule invalide: " + error);
+        }
+        dataTable->resizeColumnToContents(dataModel->columnCount() - 1);
+        logMessage(LogLevel::Info, QString("Colonne calculée « %1 » = %2").arg(name, formula.trimmed()));
+    }
+    
+    void onRemoveComputedColumn()
+    {
+        const int column = dataTable->currentIndex().column();
+        if (!dataModel->isComputedColumn(column)) {
+            statusLabel->setText("Sélectionner une cellule d'une colonne calculée");
+            return;
+        }
+        const QString name = dataModel->headerData(column, Qt::Horizontal).toString();
+        dataModel->removeComputedColumn(column);
+        logMessage(LogLevel::Info, QString("Colonne calculée « %1 » retirée").arg(name));
+    }
+    
+    void onDeleteRows()
+    {
+        std::vector<uint32_t> rows = selectedSourceRows();
+        if (rows.empty()) {
+            statusLabel->setText("Aucune ligne sélectionnée");
+            return;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        const size_t count = rows.size();
+        undoStack->push(new RemoveRowsCommand(dataModel, std::move(rows)));
+        logMessage(LogLevel::Info, QString("%1 lignes supprimées en %2 ms").arg(count).arg(timer.elapsed()));
+    }
+    
+    void onPasteRows()
+    {
+        const QByteArray text = QGuiApplication::clipboard()->text().toUtf8();
+        if (text.isEmpty())
+            return;
+        const qsizetype newline = text.indexOf('\n');
+        const std::string_view firstLine(text.constData(), size_t(newline < 0 ? text.size() : newline));
+        CsvParser parser(CsvParser::detectDelimiter(firstLine));
+        ColumnStore parsed;
+        parser.parse(text.constData(), text.constData() + text.size(), parsed, SIZE_MAX, true);
+        if (parsed.rowCount() == 0) {
+            statusLabel->setText("Presse-papiers: aucune ligne reconnue");
+            return;
+        }
+        
+        // Ajout en fin de tableau, en une seule commande
+        ColumnRows values = dataModel->encodeRows(parsed.table());
+        const uint32_t first = uint32_t(dataModel->store().rowCount());
+        values.rows.resize(values.ids.size());
+        std::iota(values.rows.begin(), values.rows.end(), first);
+        undoStack->push(new InsertRowsCommand(dataModel, std::move(values)));
+        logMessage(LogLevel::Info, QString("%1 lignes collées (%2 ignorées)").arg(parsed.rowCount()).arg(parser.errorCount()));
+    }
+    
+    void onRowsRestructured()
+    {
+        // Les correspondances trouvées désignent les anciens numéros de lignes
+        searchController->cancel();
+        currentMatch = -1;
+        matchLabel->clear();
+        if (!searchBox->text().isEmpty())
+            searchDelay->start();
+    }
+    
+    void onSortRequested(int column, Qt::SortOrder order)
+    {
+        // Trier une colonne calculée demanderait de la calculer entièrement:
+        // l'indicateur revient sur le tri en cours
+        if (dataModel->isComputedColumn(column)) {
+            const SortKeys current = dataView->sortKeys();
+            restoringHeader = true;
+            dataTable->horizontalHeader()->setSortIndicator(
+                current.empty() ? -1 : current.front().column,
+                !current.empty() && current.front().descending ? Qt::DescendingOrder : Qt::AscendingOrder);
+            restoringHeader = false;
+            statusLabel->setText("Tri impossible sur une colonne calculée");
+            return;
+        }
+        SortKeys keys;
+        if (column >= 0) {
+            const SortKey clicked{column, order == Qt::DescendingOrder};
+            if (QGuiApplication::keyboardModifiers() & Qt::ShiftModifier) {
+                keys = dataView->sortKeys();
+                auto existing = std::find_if(keys.begin(), keys.end(), [column](const SortKey &key) {
+                    return key.column == column;
+                });
+                if (existing != keys.end())
+                    *existing = clicked;
+                else
+                    keys.push_back(clicked);
+            } else {
+                keys.push_back(clicked);
             }
         }
+        dataView->setSort(keys);
+        
+        QStringList description;
+        for (const SortKey &key : keys) {
+            description << dataModel->headerData(key.column, Qt::Horizontal).toString()
+                               + (key.descending ? " ↓" : " ↑");
+        }
+        logMessage(LogLevel::Info, "Tri: " + (description.isEmpty() ? QString("aucun") : description.join(", ")));
     }
     
     void onCategoryChanged()
     {
         QString category = categoryCombo->currentText();
-        logOutput->append("Catégorie changée: " + category);
-        statusLabel->setText("Catégorie: " + category);
+        logMessage(LogLevel::Info, "Catégorie changée: " + category);
+        // Première entrée: toutes les catégories
+        dataView->setCategory(categoryCombo->currentIndex() > 0 ? category : QString());
     }
     
     void onVolumeChanged(int value)
@@ -128,16 +815,169 @@ private slots:
         statusLabel->setText(QString("Volume: %1%").arg(value));
     }
     
-    void updateProgress()
+    // Avancement agrégé des tâches, relevé à cadence fixe par le planificateur
+    void onTaskProgress(int percent)
     {
-        int value = progressBar->value();
-        if (value < 100) {
-            progressBar->setValue(value + 2);
-        } else {
-            updateTimer->stop();
-            progressBar->setValue(0);
-            QMessageBox::information(this, "Terminé", "Opération terminée avec succès!");
+        const bool busy = taskScheduler->isBusy();
+        permProgressBar->setVisible(busy);
+        if (busy) {
+            // Aucun total connu: barre d'activité
+            permProgressBar->setRange(0, percent < 0 ? 0 : 100);
+            if (percent >= 0) {
+                permProgressBar->setValue(percent);
+                setControlsProgress(percent);
+            }
+        }
+        refreshTaskPanel();
+    }
+    
+    void refreshTaskPanel()
+    {
+        if (!taskTree)
+            return;
+        const QTreeWidgetItem *current = taskTree->currentItem();
+        const quint64 currentId = current ? current->data(0, Qt::UserRole).toULongLong() : 0;
+        taskTree->clear();
+        for (const TaskScheduler::Task &task : taskScheduler->tasks()) {
+            const qint64 done = task.context->done();
+            const qint64 total = task.context->total();
+            const double seconds = std::max<qint64>(task.timer.elapsed(), 1) / 1000.0;
+            QString rate;
+            if (task.unit == "octets")
+                rate = QString("%1 Mo/s").arg(done / seconds / (1 << 20), 0, 'f', 1);
+            else
+                rate = QString("%1 %2/s").arg(qint64(done / seconds)).arg(task.unit);
+            
+            QTreeWidgetItem *item = new QTreeWidgetItem(taskTree);
+            item->setText(0, task.name);
+            item->setText(1, task.priority == TaskPriority::Interactive ? "Interactive" : "Fond");
+            item->setText(2, total > 0 ? QString("%1%").arg(std::min(done, total) * 100 / total) : QString("---"));
+            item->setText(3, done > 0 ? rate : QString("---"));
+            item->setText(4, QString("%1 s").arg(seconds, 0, 'f', 1));
+            item->setData(0, Qt::UserRole, task.id);
+            if (task.context->isCancelled())
+                item->setText(2, "Annulation...");
+            if (task.id == currentId)
+                taskTree->setCurrentItem(item);
+        }
+    }
+    
+    void onPerfUpdated(const PerfSnapshot &snapshot)
+    {
+        QString memory = "---";
+        if (snapshot.residentBytes >= 0)
+            memory = QString("%1 Mo").arg(double(snapshot.residentBytes) / (1 << 20), 0, 'f', 1);
+        perfSummaryLabel->setText(
+            QString("Images: %1/s, moyenne %2 ms, max %3 ms\n"
+                    "Latence de la boucle: moyenne %4 ms, max %5 ms\n"
+                    "Mémoire résidente: %6\n"
+                    "Trace: %7 événements")
+                .arg(snapshot.framesPerSecond, 0, 'f', 0)
+                .arg(snapshot.frameAverageMs, 0, 'f', 2)
+                .arg(snapshot.frameMaxMs, 0, 'f', 2)
+                .arg(snapshot.latencyAverageMs, 0, 'f', 2)
+                .arg(snapshot.latencyMaxMs, 0, 'f', 2)
+                .arg(memory)
+                .arg(qulonglong(snapshot.traceEvents)));
+        
+        perfTree->clear();
+        for (const PerfSnapshot::Point &point : snapshot.points) {
+            QTreeWidgetItem *item = new QTreeWidgetItem(perfTree);
+            item->setText(0, point.name);
+            item->setText(1, QString::number(point.callsPerSecond, 'f', 0));
+            item->setText(2, QString::number(point.averageUs, 'f', 1));
+            item->setText(3, QString::number(point.maxUs, 'f', 1));
+            item->setText(4, QString("%1%").arg(point.busyPercent, 0, 'f', 1));
+            if (point.itemsPerSecond > 0)
+                item->setText(5, QString::number(qint64(point.itemsPerSecond)));
+        }
+    }
+    
+    void onExportTrace()
+    {
+        const QString fileName = QFileDialog::getSaveFileName(this,
+            "Exporter la trace", "", "Trace Chrome (*.json)");
+        if (fileName.isEmpty())
+            return;
+        
+        // Mise en forme et écriture en arrière-plan: la trace peut compter
+        // des millions d'événements
+        auto error = std::make_shared<QString>();
+        auto ok = std::make_shared<bool>(false);
+        taskScheduler->run("Export de la trace", "", TaskPriority::Bulk,
+            [fileName, error, ok](TaskContext &) {
+                *ok = PerfMonitor::exportTrace(fileName, error.get());
+            },
+            [this, fileName, error, ok](bool) {
+                if (*ok)
+                    logMessage(LogLevel::Info, "Trace exportée: " + fileName);
+                else
+                    logMessage(LogLevel::Erreur, "Échec de l'export de la trace: " + *error);
+            });
+    }
+    
+    void onFeedToggled(bool enabled)
+    {
+        if (enabled == feedController->isRunning())
+            return;
+        if (!enabled) {
+            feedController->stop();
+            logMessage(LogLevel::Info, "Flux de données arrêté");
+            return;
+        }
+        // Les modifications du flux ne passent pas par l'historique
+        undoStack->clear();
+        feedDocument = document;
+        feedController->start(FeedServerName, dataModel);
+        logMessage(LogLevel::Info, QString("Flux de données: écoute sur « %1 » vers « %2 »")
+                                       .arg(FeedServerName, document->title()));
+    }
+    
+    void onFeedGeneratorToggled(bool enabled)
+    {
+        if (enabled)
+            feedController->startGenerator();
+        else
+            feedController->stopGenerator();
+    }
+    
+    void onFeedRetention()
+    {
+        bool ok = false;
+        const int rows = QInputDialog::getInt(this, "Rétention du flux",
+            "Lignes gardées (0: sans limite):", int(feedController->retention()),
+            0, 100000000, 100000, &ok);
+        if (ok)
+            feedController->setRetention(size_t(rows));
+    }
+    
+    void onFeedStats(const FeedStats &stats)
+    {
+        {
+            const QSignalBlocker listenBlocker(feedListenAction);
+            const QSignalBlocker generatorBlocker(feedGeneratorAction);
+            feedListenAction->setChecked(stats.running);
+            feedGeneratorAction->setChecked(stats.generating);
+            feedGeneratorAction->setEnabled(stats.running);
         }
+        feedLabel->setVisible(stats.running);
+        if (!stats.running)
+            return;
+        feedLabel->setText(QString("Flux: %1 lignes/s, %2 connexion(s), en attente %3")
+                               .arg(qint64(stats.rowsPerSecond))
+                               .arg(stats.connections)
+                               .arg(qulonglong(stats.pendingRows)));
+        feedLabel->setToolTip(QString("Ajoutées: %1\nModifiées: %2\nId inconnus: %3\n"
+                                      "Retirées (rétention): %4\nLignes invalides: %5\n"
+                                      "Application la plus longue: %6 ms")
+                                  .arg(qulonglong(stats.appendedRows))
+                                  .arg(qulonglong(stats.updatedRows))
+                                  .arg(qulonglong(stats.ignoredRows))
+                                  .arg(qulonglong(stats.trimmedRows))
+                                  .arg(qulonglong(stats.errors))
+                                  .arg(stats.applyMaxMs, 0, 'f', 2));
+        // Nouvelles valeurs de Type arrivées par le flux
+        updateCategoryChoices();
     }
     
     void onAbout()
@@ -158,27 +998,60 @@ private slots:
         
         QVBoxLayout *layout = new QVBoxLayout;
         
-        // Choix de couleur
+        // Choix de couleur (rôle Window de la palette)
         QPushButton *colorButton = new QPushButton("Choisir couleur de fond");
         connect(colorButton, &QPushButton::clicked, [this]() {
-            QColor color = QColorDialog::getColor(Qt::white, this, "Couleur de fond");
-            if (color.isValid()) {
-                setStyleSheet(QString("QMainWindow { background-color: %1; }").arg(color.name()));
-            }
+            const QColor initial = theme->settings().background.isValid() ? theme->settings().background
+                                                                           : palette().color(QPalette::Window);
+            QColor color = QColorDialog::getColor(initial, this, "Couleur de fond");
+            if (color.isValid())
+                theme->setBackground(color);
         });
+        QPushButton *defaultColorButton = new QPushButton("Fond par défaut");
+        connect(defaultColorButton, &QPushButton::clicked, [this]() { theme->setBackground(QColor()); });
         
-        // Choix de police
+        // Choix de police, avec aperçu pendant la sélection
         QPushButton *fontButton = new QPushButton("Choisir police");
-        connect(fontButton, &QPushButton::clicked, [this]() {
-            bool ok;
-            QFont font = QFontDialog::getFont(&ok, this->font(), this, "Police");
-            if (ok) {
-                setFont(font);
-            }
+        connect(fontButton, &QPushButton::clicked, [this, &settingsDialog]() {
+            const ThemeSettings previous = theme->settings();
+            QFontDialog fontDialog(QApplication::font(), &settingsDialog);
+            fontDialog.setWindowTitle("Police");
+            connect(&fontDialog, &QFontDialog::currentFontChanged, theme, &ThemeManager::setFont);
+            if (fontDialog.exec() == QDialog::Accepted)
+                theme->setFont(fontDialog.selectedFont());
+            else if (previous.customFont)
+                theme->setFont(previous.font);
+            else
+                theme->resetFont();
         });
         
-        layout->addWidget(colorButton);
+        // Palette sombre
+        QCheckBox *darkCheck = new QCheckBox("Thème sombre");
+        darkCheck->setChecked(theme->settings().dark);
+        connect(darkCheck, &QCheckBox::toggled, theme, &ThemeManager::setDark);
+        
+        QHBoxLayout *colorLayout = new QHBoxLayout;
+        colorLayout->addWidget(colorButton);
+        colorLayout->addWidget(defaultColorButton);
+        layout->addLayout(colorLayout);
         layout->addWidget(fontButton);
+        layout->addWidget(darkCheck);
+        
+        // Au-delà du budget, les documents inactifs sont déchargés
+        QSpinBox *budgetSpin = new QSpinBox;
+        budgetSpin->setRange(0, 1 << 20);
+        budgetSpin->setSingleStep(256);
+        budgetSpin->setSuffix(" Mo");
+        budgetSpin->setSpecialValueText("Sans limite");
+        budgetSpin->setValue(session.memoryBudgetMb);
+        connect(budgetSpin, &QSpinBox::valueChanged, this, [this](int megabytes) {
+            session.memoryBudgetMb = megabytes;
+            memoryBudget->setLimit(size_t(megabytes) << 20);
+        });
+        QHBoxLayout *budgetLayout = new QHBoxLayout;
+        budgetLayout->addWidget(new QLabel("Budget mémoire:"));
+        budgetLayout->addWidget(budgetSpin);
+        layout->addLayout(budgetLayout);
         
         QPushButton *closeButton = new QPushButton("Fermer");
         connect(closeButton, &QPushButton::clicked, &settingsDialog, &QDialog::accept);
@@ -189,23 +1062,458 @@ private slots:
     }
 
 private:
+    void showMatch(int position)
+    {
+        currentMatch = position;
+        const int row = int(searchController->matches()[size_t(position)]);
+        // La ligne peut être masquée par le filtre rapide
+        const QModelIndex viewIndex = dataView->model()->mapFromSource(dataModel->index(row, 0));
+        if (viewIndex.isValid()) {
+            dataTable->selectRow(viewIndex.row());
+            dataTable->scrollTo(viewIndex);
+        } else {
+            dataTable->clearSelection();
+        }
+        updateMatchLabel();
+    }
+    
+    void showNodeDetails()
+    {
+        const QModelIndex current = hierarchyTree->currentIndex();
+        if (!current.isValid()) {
+            nodeDetails->setPlainText("Sélectionnez un élément dans l'arbre pour voir ses détails...");
+            return;
+        }
+        const NodeTable &nodes = hierarchyModel->nodes();
+        const uint32_t node = hierarchyModel->nodeOf(current);
+        const ValueStats &rollup = nodes.rollup(node);
+        const std::string_view name = nodes.name(node);
+        const std::string_view kind = nodes.kind(node);
+        QString text = QString("Élément: %1\nType: %2\nEnfants: %3\n")
+                           .arg(QString::fromUtf8(name.data(), qsizetype(name.size())))
+                           .arg(QString::fromUtf8(kind.data(), qsizetype(kind.size())))
+                           .arg(nodes.childCount(node));
+        if (rollup.count > 0) {
+            text += QString("\nValeurs cumulées: %1\nSomme: %2\nMoyenne: %3\nMinimum: %4\nMaximum: %5")
+                        .arg(rollup.count).arg(rollup.sum).arg(rollup.mean()).arg(rollup.min).arg(rollup.max);
+        }
+        nodeDetails->setPlainText(text);
+    }
+    
+    void onAddNode()
+    {
+        // Sous le dossier sélectionné, ou à côté de l'élément sélectionné
+        QModelIndex parent = hierarchyTree->currentIndex().siblingAtColumn(0);
+        if (parent.isValid() && hierarchyModel->nodes().kind(hierarchyModel->nodeOf(parent)) != "Dossier")
+            parent = parent.parent();
+        if (parent.isValid())
+            hierarchyTree->expand(parent);
+        const QModelIndex added = hierarchyModel->insertNode(parent, "Nouvel élément", "Fichier", 0.0);
+        if (added.isValid()) {
+            const QModelIndex value = added.siblingAtColumn(HierarchyModel::Valeur);
+            hierarchyTree->setCurrentIndex(value);
+            hierarchyTree->edit(value);
+        }
+    }
+    
+    void onPasteNode()
+    {
+        if (!cutNode.isValid()) {
+            statusLabel->setText("Aucun élément coupé");
+            return;
+        }
+        const QModelIndex target = hierarchyTree->currentIndex().siblingAtColumn(0);
+        if (!hierarchyModel->moveNode(cutNode, target)) {
+            statusLabel->setText("Déplacement impossible dans son propre sous-arbre");
+            return;
+        }
+        cutNode = QPersistentModelIndex();
+        statusLabel->setText("Élément déplacé");
+    }
+    
+    // Totaux par Type ou Statut, les groupes les plus nombreux d'abord
+    void fillGroupTree(const ValueSummary &summary)
+    {
+        const bool byType = groupByCombo->currentIndex() == 0;
+        const GroupTotals &totals = byType ? summary.byType : summary.byStatut;
+        const ColumnTable &table = dataModel->store().table();
+        const StringColumn &names = byType ? table.typeValues : table.statutValues;
+        
+        std::vector<uint32_t> codes;
+        for (uint32_t code = 0; code < uint32_t(totals.size()); ++code) {
+            if (totals.counts[code] > 0)
+                codes.push_back(code);
+        }
+        const size_t shown = std::min(codes.size(), MaxSummaryGroups);
+        std::partial_sort(codes.begin(), codes.begin() + shown, codes.end(), [&totals](uint32_t a, uint32_t b) {
+            return totals.counts[a] > totals.counts[b];
+        });
+        
+        groupTree->clear();
+        for (size_t i = 0; i < shown; ++i) {
+            const uint32_t code = codes[i];
+            const std::string_view name = names[code];
+            QTreeWidgetItem *item = new QTreeWidgetItem(groupTree);
+            item->setText(0, QString::fromUtf8(name.data(), qsizetype(name.size())));
+            item->setText(1, QString::number(totals.counts[code]));
+            item->setText(2, QString::number(totals.sums[code], 'f', 2));
+            item->setText(3, QString::number(totals.sums[code] / double(totals.counts[code]), 'f', 2));
+            item->setTextAlignment(1, Qt::AlignRight);
+            item->setTextAlignment(2, Qt::AlignRight);
+            item->setTextAlignment(3, Qt::AlignRight);
+        }
+    }
+    
+    // Lignes de la source sélectionnées dans la vue, triées
+    std::vector<uint32_t> selectedSourceRows() const
+    {
+        std::vector<uint32_t> rows;
+        const DataViewModel *view = dataView->model();
+        for (const QItemSelectionRange &range : dataTable->selectionModel()->selection()) {
+            for (int row = range.top(); row <= range.bottom(); ++row)
+                rows.push_back(uint32_t(view->mapToSource(view->index(row, 0)).row()));
+        }
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        return rows;
+    }
+    
+    // Le journal est alimenté par la file du LogEngine (sûr depuis tout
+    // thread); l'affichage suit à l'image suivante
+    static void logMessage(LogLevel level, const QString &message)
+    {
+        LogEngine::instance().post(level, message.toStdString());
+    }
+    
+    // État du lancement précédent, appliqué une fois l'interface construite
+    void restoreSession()
+    {
+        if (!session.geometry.isEmpty())
+            restoreGeometry(session.geometry);
+        if (!session.windowState.isEmpty())
+            restoreState(session.windowState);
+        logModel->setLevelFilter(std::clamp(session.logLevel, -1, int(LogLevelCount) - 1));
+        theme->apply(session.theme);
+        // L'onglet actif au départ est construit tout de suite, les autres attendent
+        if (session.currentTab > 0 && session.currentTab < centralTabs->count())
+            centralTabs->setCurrentIndex(session.currentTab);
+    }
+    
+    void saveSession()
+    {
+        session.geometry = saveGeometry();
+        session.windowState = saveState();
+        session.currentTab = centralTabs->currentIndex();
+        session.logLevel = logModel->levelFilter();
+        session.theme = theme->settings();
+        QString error;
+        if (!session.save(SessionState::defaultFileName(), &error))
+            qWarning("Session non enregistrée: %s", qPrintable(error));
+    }
+    
+    // Barre de l'onglet Contrôles, s'il a été construit
+    void setControlsProgress(int percent)
+    {
+        if (progressBar)
+            progressBar->setValue(percent);
+    }
+    
+    void addDeferredTab(const QString &title, std::function<void(QWidget *)> build)
+    {
+        const int index = centralTabs->addTab(new QWidget, title);
+        if (tabBuilders.size() <= size_t(index))
+            tabBuilders.resize(size_t(index) + 1);
+        tabBuilders[size_t(index)] = std::move(build);
+    }
+    
+    // Construit le contenu d'un onglet différé à sa première activation
+    void buildTab(int index)
+    {
+        if (index < 0 || size_t(index) >= tabBuilders.size() || !tabBuilders[size_t(index)])
+            return;
+        std::function<void(QWidget *)> build = std::move(tabBuilders[size_t(index)]);
+        tabBuilders[size_t(index)] = nullptr;
+        build(centralTabs->widget(index));
+    }
+    
+    // Choix de catégorie: les valeurs de Type présentes dans le document
+    // actif. Le dictionnaire est partagé entre documents: seules comptent
+    // les valeurs qui ont encore des lignes ici. La catégorie de la vue est
+    // gardée si elle existe toujours, abandonnée sinon.
+    void updateCategoryChoices()
+    {
+        const QString selected = dataView->category();
+        const StringColumn &types = dataModel->store().table().typeValues;
+        const CategoryIndex &index = dataView->categoryIndex();
+        QStringList choices;
+        for (size_t code = 0; code < types.size(); ++code) {
+            if (index.bitmap(uint32_t(code)).isEmpty())
+                continue;
+            const std::string_view type = types[code];
+            choices << QString::fromUtf8(type.data(), qsizetype(type.size()));
+        }
+        if (size_t(choices.size()) > MaxCategoryChoices)
+            choices.clear();
+
+        const QSignalBlocker blocker(categoryCombo);
+        categoryCombo->clear();
+        categoryCombo->addItem("Tous");
+        categoryCombo->addItems(choices);
+        const int current = selected.isEmpty() ? 0 : categoryCombo->findText(selected);
+        categoryCombo->setCurrentIndex(std::max(0, current));
+        if (current < 0)
+            dataView->setCategory(QString());
+    }
+    
+    void updateMatchLabel()
+    {
+        matchLabel->setText(QString("%1 / %2%3")
+                                .arg(currentMatch + 1)
+                                .arg(searchController->matches().size())
+                                .arg(searchController->isRunning() ? "+" : ""));
+    }
+    
+    // Nouvel onglet: document vide, relié à l'historique et au budget mémoire
+    DataDocument *addDocument(const QString &title)
+    {
+        DataDocument *doc = new DataDocument(title, this);
+        documents.push_back(doc);
+        {
+            const QSignalBlocker blocker(documentBar);
+            documentBar->addTab(title);
+        }
+        undoGroup->addStack(doc->undoStack());
+        memoryBudget->addDocument(doc);
+        
+        // Les surlignages suivent les résultats même onglet caché; le reste
+        // ne concerne l'interface que pour le document actif
+        connect(doc->search(), &SearchController::matchesAdded, this, [this, doc](int first, int count) {
+            onMatchesAdded(doc, first, count);
+        });
+        connect(doc->search(), &SearchController::searchFinished, this, [this, doc](qint64 matchCount, qint64 elapsedMs) {
+            onSearchFinished(doc, matchCount, elapsedMs);
+        });
+        connect(doc->view()->model(), &DataViewModel::sortRequested, this, [this, doc](int column, Qt::SortOrder order) {
+            if (doc == document && !restoringHeader)
+                onSortRequested(column, order);
+        });
+        connect(doc->view(), &DataView::viewUpdated, this, [this, doc](qint64 visibleRows, qint64 elapsedMs) {
+            if (doc == document)
+                onViewUpdated(visibleRows, elapsedMs);
+        });
+        connect(doc->summary(), &SummaryController::summaryChanged, this, [this, doc](qint64 elapsedMs) {
+            if (doc == document)
+                onSummaryChanged(elapsedMs);
+        });
+        auto restructured = [this, doc]() {
+            if (doc == document) {
+                onRowsRestructured();
+                return;
+            }
+            // Relancée au retour sur l'onglet
+            doc->search()->cancel();
+            doc->ui.currentMatch = -1;
+            doc->ui.searchStale = !doc->ui.searchText.isEmpty();
+        };
+        connect(doc->model(), &DataTableModel::rowsErased, this, restructured);
+        connect(doc->model(), &DataTableModel::rowsPlaced, this, restructured);
+        return doc;
+    }
+    
+    // Relie l'interface au document: tableau, historique, filtres, recherche
+    // et synthèse reprennent son état sans rien recalculer
+    void activateDocument(DataDocument *doc)
+    {
+        if (doc == document)
+            return;
+        if (document) {
+            document->ui.searchText = searchBox->text();
+            document->ui.currentMatch = currentMatch;
+            document->ui.headerState = dataTable->horizontalHeader()->saveState();
+        }
+        document = doc;
+        dataModel = doc->model();
+        dataView = doc->view();
+        undoStack = doc->undoStack();
+        searchController = doc->search();
+        summaryController = doc->summary();
+        undoGroup->setActiveStack(undoStack);
+        memoryBudget->setActive(doc);
+        {
+            const QSignalBlocker blocker(documentBar);
+            documentBar->setCurrentIndex(indexOfDocument(doc));
+        }
+        setWindowTitle("Gestionnaire de Données Avancé - " + doc->title());
+        
+        // Le changement d'indicateur de tri demande un tri à la vue: ignoré
+        // pendant la reprise de l'en-tête, le tri du document est déjà appliqué
+        QItemSelectionModel *previousSelection = dataTable->selectionModel();
+        restoringHeader = true;
+        dataTable->setModel(dataView->model());
+        delete previousSelection;
+        if (doc->ui.headerState.isEmpty() || !dataTable->horizontalHeader()->restoreState(doc->ui.headerState)) {
+            dataTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+            dataTable->resizeColumnsToContents();
+        }
+        restoringHeader = false;
+        
+        // Critères du document; la période est commune à tous
+        {
+            const QSignalBlocker blocker(quickSearch);
+            quickSearch->setText(dataView->textFilter());
+        }
+        dataView->setDateRange(period);
+        // Types du document et sa catégorie sélectionnée
+        updateCategoryChoices();
+        
+        searchDelay->stop();
+        {
+            const QSignalBlocker blocker(searchBox);
+            searchBox->setText(doc->ui.searchText);
+        }
+        currentMatch = doc->ui.currentMatch;
+        if (doc->ui.searchStale) {
+            doc->ui.searchStale = false;
+            onSearch();
+        } else if (searchController->matches().empty()) {
+            matchLabel->setText(searchBox->text().isEmpty() ? QString()
+                                : searchController->isRunning() ? QString("Recherche...") : QString("Aucun résultat"));
+        } else if (currentMatch < 0) {
+            showMatch(0);
+        } else {
+            updateMatchLabel();
+        }
+        
+        showSummary();
+        summaryTimeLabel->clear();
+        onViewUpdated(dataView->model()->rowCount(), -1);
+    }
+    
+    void closeDocument(DataDocument *doc)
+    {
+        abortLoad(doc);
+        if (feedDocument == doc && feedController->isRunning())
+            feedListenAction->setChecked(false);
+        // Toujours au moins un document affiché
+        if (documents.size() == 1)
+            addDocument(QString("Sans titre %1").arg(++untitledCount));
+        const int index = indexOfDocument(doc);
+        if (doc == document)
+            activateDocument(documents[size_t(index + 1 < int(documents.size()) ? index + 1 : index - 1)]);
+        documents.erase(documents.begin() + index);
+        documentBar->removeTab(index);
+        memoryBudget->removeDocument(doc);
+        logMessage(LogLevel::Info, "Document fermé: " + doc->title());
+        doc->deleteLater();
+    }
+    
+    int indexOfDocument(DataDocument *doc) const
+    {
+        return int(std::find(documents.begin(), documents.end(), doc) - documents.begin());
+    }
+    
+    void updateDocumentTab(DataDocument *doc)
+    {
+        const int index = indexOfDocument(doc);
+        documentBar->setTabText(index, doc->title());
+        documentBar->setTabToolTip(index, doc->fileName());
+        if (doc == document)
+            setWindowTitle("Gestionnaire de Données Avancé - " + doc->title());
+    }
+    
+    void finishLoadTask(DataDocument *doc)
+    {
+        if (!doc->load.task)
+            return;
+        taskScheduler->finish(doc->load.taskId);
+        doc->load.task.reset();
+    }
+    
+    // Chargement en cours vers doc abandonné
+    void abortLoad(DataDocument *doc)
+    {
+        if (doc->load.loader) {
+            doc->load.loader->disconnect(doc);
+            doc->load.loader->requestInterruption();
+            doc->load.loader = nullptr;
+        }
+        finishLoadTask(doc);
+    }
+    
+    // Dans le document affiché s'il est encore vide, sinon dans un nouvel onglet
+    void startLoading(const QString &fileName)
+    {
+        DataDocument *doc = document->isBlank() ? document : addDocument(QString());
+        doc->setFileName(fileName);
+        updateDocumentTab(doc);
+        activateDocument(doc);
+        doc->load.firstBatchPending = true;
+        doc->load.timer.start();
+        
+        FileLoader *loader = new FileLoader(fileName, this);
+        doc->load.loader = loader;
+        // Le chargeur garde son thread (lecture séquentielle d'une projection
+        // mémoire); il figure parmi les tâches et s'annule par interruption
+        QPointer<FileLoader> guard = loader;
+        QPointer<DataDocument> target = doc;
+        doc->load.task = taskScheduler->begin("Chargement " + doc->title(), "octets",
+                                              TaskPriority::Bulk, &doc->load.taskId, [this, guard, target]() {
+            if (!guard || !target)
+                return;
+            abortLoad(target);
+            logMessage(LogLevel::Attention, "Chargement annulé: " + guard->fileName());
+        });
+        connect(loader, &FileLoader::batchReady, doc, [this, doc](ColumnTablePtr batch) {
+            onBatchLoaded(doc, batch);
+        });
+        connect(loader, &FileLoader::tableReady, doc, [this, doc](ColumnTablePtr table) {
+            onTableLoaded(doc, table);
+        });
+        connect(loader, &FileLoader::progress, doc, [this, doc](qint64 bytesDone, qint64 bytesTotal) {
+            onLoadProgress(doc, bytesDone, bytesTotal);
+        });
+        connect(loader, &FileLoader::loadFinished, doc, [this, doc](qint64 rows, qint64 errors, qint64 elapsedMs) {
+            onLoadFinished(doc, rows, errors, elapsedMs);
+        });
+        connect(loader, &FileLoader::loadFailed, doc, [this, doc](const QString &message) {
+            onLoadFailed(doc, message);
+        });
+        connect(loader, &QThread::finished, loader, &QObject::deleteLater);
+        loader->start();
+    }
+    
     void setupUI()
     {
         // Widget central avec onglets
         centralTabs = new QTabWidget;
         setCentralWidget(centralTabs);
-        
-        // Onglet 1: Tableau de données
+        taskScheduler = new TaskScheduler(this);
+        connect(taskScheduler, &TaskScheduler::tasksChanged, this, &AdvancedMainWindow::refreshTaskPanel);
+        connect(taskScheduler, &TaskScheduler::progressChanged, this, &AdvancedMainWindow::onTaskProgress);
+        // Budget de mémoire résidente des documents (limite de la session)
+        memoryBudget = new MemoryBudget(taskScheduler, this);
+        memoryBudget->setLimit(size_t(std::max(session.memoryBudgetMb, 0)) << 20);
+        
+        // Le journal se remplit dès le démarrage (et alimente l'écriture
+        // continue): son modèle n'attend pas l'onglet
+        logModel = new LogModel(LogModel::DefaultCapacity, this);
+        logMessage(LogLevel::Info, "Application démarrée");
+        logMessage(LogLevel::Info, "Interface utilisateur initialisée");
+        logMessage(LogLevel::Attention, "Configuration par défaut utilisée");
+        
+        // Onglet 1: Tableau de données, seul construit au démarrage
         setupDataTab();
         
-        // Onglet 2: Vue hiérarchique
-        setupHierarchyTab();
-        
-        // Onglet 3: Contrôles avancés
-        setupControlsTab();
+        // Onglets 2 à 5: vue hiérarchique, contrôles avancés, logs et tâches
+        // en cours, construits à leur première activation
+        addDeferredTab("Hiérarchie", [this](QWidget *page) { setupHierarchyTab(page); });
+        addDeferredTab("Contrôles", [this](QWidget *page) { setupControlsTab(page); });
+        addDeferredTab("Logs", [this](QWidget *page) { setupLogTab(page); });
+        addDeferredTab("Tâches", [this](QWidget *page) { setupTaskTab(page); });
+        connect(centralTabs, &QTabWidget::currentChanged, this, &AdvancedMainWindow::buildTab);
         
-        // Onglet 4: Logs
-        setupLogTab();
+        // Panneau flottant des performances, masqué par défaut
+        setupPerfDock();
     }
     
     void setupDataTab()
@@ -213,43 +1521,117 @@ private:
         QWidget *dataWidget = new QWidget;
         QVBoxLayout *layout = new QVBoxLayout(dataWidget);
         
+        // Un onglet par document ouvert; l'historique suit le document actif
+        documentBar = new QTabBar;
+        documentBar->setDocumentMode(true);
+        documentBar->setTabsClosable(true);
+        documentBar->setExpanding(false);
+        documentBar->setMovable(false);
+        undoGroup = new QUndoGroup(this);
+        
         // Barre de recherche
         QHBoxLayout *searchLayout = new QHBoxLayout;
         searchBox = new QLineEdit;
         searchBox->setPlaceholderText("Rechercher...");
         QPushButton *searchButton = new QPushButton("Chercher");
+        QPushButton *previousButton = new QPushButton("Précédent");
+        QPushButton *nextButton = new QPushButton("Suivant");
+        matchLabel = new QLabel;
+        matchLabel->setMinimumWidth(90);
+        
+        // Recherche au fil de la frappe, après une courte pause
+        searchDelay = new QTimer(this);
+        searchDelay->setSingleShot(true);
+        searchDelay->setInterval(250);
         
         categoryCombo = new QComboBox;
-        categoryCombo->addItems({"Tous", "Clients", "Produits", "Commandes", "Factures"});
+        // Valeurs de Type ajoutées au chargement (updateCategoryChoices)
+        categoryCombo->addItem("Tous");
         
         searchLayout->addWidget(new QLabel("Recherche:"));
         searchLayout->addWidget(searchBox);
         searchLayout->addWidget(searchButton);
+        searchLayout->addWidget(previousButton);
+        searchLayout->addWidget(nextButton);
+        searchLayout->addWidget(matchLabel);
         searchLayout->addWidget(new QLabel("Catégorie:"));
         searchLayout->addWidget(categoryCombo);
         searchLayout->addStretch();
         
-        // Tableau de données
-        dataTable = new QTableWidget(10, 6);
-        QStringList headers = {"ID", "Nom", "Type", "Date", "Statut", "Valeur"};
-        dataTable->setHorizontalHeaderLabels(headers);
+        // Tableau de données (modèle colonnaire, formaté à la demande), relié
+        // au modèle du document actif
+        dataTable = new QTableView;
         
-        // Remplissage avec des données d'exemple
+        // Premier document, avec des données d'exemple (activé une fois
+        // l'interface construite)
+        DataDocument *sample = addDocument("Exemple");
         for (int i = 0; i < 10; ++i) {
-            dataTable->setItem(i, 0, new QTableWidgetItem(QString::number(1000 + i)));
-            dataTable->setItem(i, 1, new QTableWidgetItem("Élément " + QString::number(i + 1)));
-            dataTable->setItem(i, 2, new QTableWidgetItem(i % 2 ? "Type A" : "Type B"));
-            dataTable->setItem(i, 3, new QTableWidgetItem("2024-01-" + QString("%1").arg(i + 1, 2, 10, QChar('0'))));
-            dataTable->setItem(i, 4, new QTableWidgetItem(i % 3 ? "Actif" : "Inactif"));
-            dataTable->setItem(i, 5, new QTableWidgetItem(QString::number((i + 1) * 100.5, 'f', 2)));
+            const QByteArray nom = ("Élément " + QString::number(i + 1)).toUtf8();
+            RowValues row;
+            row.id = 1000 + i;
+            row.nom = std::string_view(nom.constData(), size_t(nom.size()));
+            row.type = i % 2 ? "Type A" : "Type B";
+            row.date = daysFromCivil(2024, 1, unsigned(i + 1));
+            row.statut = i % 3 ? "Actif" : "Inactif";
+            row.valeur = (i + 1) * 100.5;
+            sample->model()->appendRow(row);
         }
+        sample->search()->rebuildIndex(sample->model()->store().snapshot());
         
-        dataTable->resizeColumnsToContents();
+        // Hauteur de ligne fixe: la vue n'a pas à mesurer chaque ligne
+        dataTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        dataTable->verticalHeader()->setDefaultSectionSize(theme->rowHeight());
+        connect(theme, &ThemeManager::fontChanged, this, [this]() {
+            dataTable->verticalHeader()->setDefaultSectionSize(theme->rowHeight());
+        });
+        dataTable->setWordWrap(false);
         dataTable->setAlternatingRowColors(true);
         dataTable->setSelectionBehavior(QAbstractItemView::SelectRows);
         
+        // Tri au clic sur l'en-tête (Maj+clic: critère supplémentaire), pas de tri au départ
+        dataTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+        dataTable->setSortingEnabled(true);
+        
+        // Synthèse de Valeur à côté du tableau
+        feedController = new FeedController(this);
+        QGroupBox *summaryBox = new QGroupBox("Synthèse (Valeur)");
+        QVBoxLayout *summaryLayout = new QVBoxLayout(summaryBox);
+        QGridLayout *statsLayout = new QGridLayout;
+        const QStringList fieldNames = {"Lignes:", "Somme:", "Moyenne:", "Minimum:", "Maximum:",
+                                        "1er quartile:", "Médiane:", "3e quartile:", "90e centile:", "99e centile:"};
+        for (int i = 0; i < fieldNames.size(); ++i) {
+            QLabel *field = new QLabel("-");
+            field->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            field->setTextInteractionFlags(Qt::TextSelectableByMouse);
+            statsLayout->addWidget(new QLabel(fieldNames[i]), i, 0);
+            statsLayout->addWidget(field, i, 1);
+            summaryFields.append(field);
+        }
+        summaryLayout->addLayout(statsLayout);
+        
+        QHBoxLayout *groupLayout = new QHBoxLayout;
+        groupByCombo = new QComboBox;
+        groupByCombo->addItems({"Type", "Statut"});
+        groupLayout->addWidget(new QLabel("Regrouper par:"));
+        groupLayout->addWidget(groupByCombo);
+        summaryLayout->addLayout(groupLayout);
+        
+        groupTree = new QTreeWidget;
+        groupTree->setHeaderLabels({"Groupe", "Lignes", "Somme", "Moyenne"});
+        groupTree->setRootIsDecorated(false);
+        summaryLayout->addWidget(groupTree);
+        summaryTimeLabel = new QLabel;
+        summaryLayout->addWidget(summaryTimeLabel);
+        
+        QSplitter *tableSplitter = new QSplitter(Qt::Horizontal);
+        tableSplitter->addWidget(dataTable);
+        tableSplitter->addWidget(summaryBox);
+        tableSplitter->setStretchFactor(0, 3);
+        tableSplitter->setStretchFactor(1, 1);
+        
+        layout->addWidget(documentBar);
         layout->addLayout(searchLayout);
-        layout->addWidget(dataTable);
+        layout->addWidget(tableSplitter);
         
         // Boutons d'action
         QHBoxLayout *buttonLayout = new QHBoxLayout;
@@ -268,43 +1650,72 @@ private:
         
         // Connexions
         connect(searchButton, &QPushButton::clicked, this, &AdvancedMainWindow::onSearch);
+        connect(searchBox, &QLineEdit::returnPressed, this, &AdvancedMainWindow::onSearch);
+        connect(searchBox, &QLineEdit::textChanged, searchDelay, QOverload<>::of(&QTimer::start));
+        connect(searchDelay, &QTimer::timeout, this, &AdvancedMainWindow::onSearch);
+        connect(previousButton, &QPushButton::clicked, this, &AdvancedMainWindow::onPreviousMatch);
+        connect(nextButton, &QPushButton::clicked, this, &AdvancedMainWindow::onNextMatch);
+        connect(new QShortcut(QKeySequence::FindNext, this), &QShortcut::activated,
+                this, &AdvancedMainWindow::onNextMatch);
+        connect(new QShortcut(QKeySequence::FindPrevious, this), &QShortcut::activated,
+                this, &AdvancedMainWindow::onPreviousMatch);
         connect(categoryCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
                 this, &AdvancedMainWindow::onCategoryChanged);
+        connect(groupByCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+            if (const ValueSummary *summary = summaryController->summary())
+                fillGroupTree(*summary);
+        });
+        connect(addButton, &QPushButton::clicked, this, &AdvancedMainWindow::onAddRow);
+        connect(editButton, &QPushButton::clicked, this, &AdvancedMainWindow::onEditRows);
+        connect(deleteButton, &QPushButton::clicked, this, &AdvancedMainWindow::onDeleteRows);
+        connect(documentBar, &QTabBar::currentChanged, this, [this](int index) {
+            if (index >= 0 && size_t(index) < documents.size())
+                activateDocument(documents[size_t(index)]);
+        });
+        connect(documentBar, &QTabBar::tabCloseRequested, this, [this](int index) {
+            closeDocument(documents[size_t(index)]);
+        });
+        
+        // Raccourcis actifs quand le tableau a le focus (pas pendant l'édition d'une cellule)
+        QShortcut *deleteShortcut = new QShortcut(QKeySequence::Delete, dataTable);
+        deleteShortcut->setContext(Qt::WidgetShortcut);
+        connect(deleteShortcut, &QShortcut::activated, this, &AdvancedMainWindow::onDeleteRows);
+        QShortcut *pasteShortcut = new QShortcut(QKeySequence::Paste, dataTable);
+        pasteShortcut->setContext(Qt::WidgetShortcut);
+        connect(pasteShortcut, &QShortcut::activated, this, &AdvancedMainWindow::onPasteRows);
     }
     
-    void setupHierarchyTab()
+    void setupHierarchyTab(QWidget *page)
     {
-        QWidget *hierarchyWidget = new QWidget;
-        QHBoxLayout *layout = new QHBoxLayout(hierarchyWidget);
+        QHBoxLayout *layout = new QHBoxLayout(page);
         
         // Splitter pour diviser l'espace
         QSplitter *splitter = new QSplitter(Qt::Horizontal);
         
-        // Arbre hiérarchique
-        hierarchyTree = new QTreeWidget;
-        hierarchyTree->setHeaderLabels({"Élément", "Type", "Valeur"});
+        // Arbre hiérarchique (table de nœuds à plat, enfants présentés au dépliage)
+        hierarchyModel = new HierarchyModel(this);
+        hierarchyTree = new QTreeView;
+        hierarchyTree->setUniformRowHeights(true);
+        hierarchyTree->setModel(hierarchyModel);
         
         // Création de l'arbre d'exemple
-        QTreeWidgetItem *rootItem = new QTreeWidgetItem(hierarchyTree);
-        rootItem->setText(0, "Racine");
-        rootItem->setText(1, "Dossier");
-        rootItem->setText(2, "---");
-        
+        NodeTable nodes;
+        const uint32_t root = nodes.addNode(NodeTable::NoNode, "Racine", "Dossier", std::nan(""));
         for (int i = 0; i < 3; ++i) {
-            QTreeWidgetItem *categoryItem = new QTreeWidgetItem(rootItem);
-            categoryItem->setText(0, "Catégorie " + QString::number(i + 1));
-            categoryItem->setText(1, "Dossier");
-            categoryItem->setText(2, QString::number((i + 1) * 10));
-            
+            const QByteArray category = ("Catégorie " + QString::number(i + 1)).toUtf8();
+            // La valeur d'un dossier est le cumul de ses éléments
+            const uint32_t categoryNode = nodes.addNode(root, std::string_view(category.constData(), size_t(category.size())),
+                                                        "Dossier", std::nan(""));
             for (int j = 0; j < 4; ++j) {
-                QTreeWidgetItem *subItem = new QTreeWidgetItem(categoryItem);
-                subItem->setText(0, "Élément " + QString::number(j + 1));
-                subItem->setText(1, "Fichier");
-                subItem->setText(2, QString::number((j + 1) * 5.5, 'f', 1));
+                const QByteArray element = ("Élément " + QString::number(j + 1)).toUtf8();
+                nodes.addNode(categoryNode, std::string_view(element.constData(), size_t(element.size())),
+                              "Fichier", (j + 1) * 5.5);
             }
         }
+        hierarchyModel->setNodes(std::move(nodes));
         
-        hierarchyTree->expandAll();
+        // Seul le premier niveau est déplié: le reste se charge à la demande
+        hierarchyTree->expandToDepth(0);
         
         // Panel de détails
         QWidget *detailsPanel = new QWidget;
@@ -312,9 +1723,37 @@ private:
         
         detailsLayout->addWidget(new QLabel("Détails de l'élément sélectionné:"));
         
-        QTextEdit *detailsText = new QTextEdit;
-        detailsText->setPlainText("Sélectionnez un élément dans l'arbre pour voir ses détails...");
-        detailsLayout->addWidget(detailsText);
+        nodeDetails = new QTextEdit;
+        nodeDetails->setReadOnly(true);
+        nodeDetails->setPlainText("Sélectionnez un élément dans l'arbre pour voir ses détails...");
+        detailsLayout->addWidget(nodeDetails);
+        
+        // Édition de l'arbre (la Valeur d'un élément se modifie dans l'arbre)
+        QGridLayout *nodeButtons = new QGridLayout;
+        QPushButton *addNodeButton = new QPushButton("Ajouter");
+        QPushButton *removeNodeButton = new QPushButton("Supprimer");
+        QPushButton *cutNodeButton = new QPushButton("Couper");
+        QPushButton *pasteNodeButton = new QPushButton("Coller dans");
+        nodeButtons->addWidget(addNodeButton, 0, 0);
+        nodeButtons->addWidget(removeNodeButton, 0, 1);
+        nodeButtons->addWidget(cutNodeButton, 1, 0);
+        nodeButtons->addWidget(pasteNodeButton, 1, 1);
+        detailsLayout->addLayout(nodeButtons);
+        
+        connect(hierarchyTree->selectionModel(), &QItemSelectionModel::currentChanged,
+                this, &AdvancedMainWindow::showNodeDetails);
+        connect(hierarchyModel, &QAbstractItemModel::dataChanged, this, &AdvancedMainWindow::showNodeDetails);
+        connect(addNodeButton, &QPushButton::clicked, this, &AdvancedMainWindow::onAddNode);
+        connect(removeNodeButton, &QPushButton::clicked, this, [this]() {
+            hierarchyModel->removeNode(hierarchyTree->currentIndex().siblingAtColumn(0));
+            showNodeDetails();
+        });
+        connect(cutNodeButton, &QPushButton::clicked, this, [this]() {
+            cutNode = QPersistentModelIndex(hierarchyTree->currentIndex().siblingAtColumn(0));
+            if (cutNode.isValid())
+                statusLabel->setText("Coupé: " + cutNode.data().toString());
+        });
+        connect(pasteNodeButton, &QPushButton::clicked, this, &AdvancedMainWindow::onPasteNode);
         
         splitter->addWidget(hierarchyTree);
         splitter->addWidget(detailsPanel);
@@ -322,14 +1761,11 @@ private:
         splitter->setStretchFactor(1, 1);
         
         layout->addWidget(splitter);
-        
-        centralTabs->addTab(hierarchyWidget, "Hiérarchie");
     }
     
-    void setupControlsTab()
+    void setupControlsTab(QWidget *page)
     {
-        QWidget *controlsWidget = new QWidget;
-        QVBoxLayout *mainLayout = new QVBoxLayout(controlsWidget);
+        QVBoxLayout *mainLayout = new QVBoxLayout(page);
         
         // Groupe de contrôles numériques
         QGroupBox *numericGroup = new QGroupBox("Contrôles Numériques");
@@ -365,9 +1801,13 @@ private:
         QGroupBox *dateGroup = new QGroupBox("Date et Temps");
         QGridLayout *dateLayout = new QGridLayout(dateGroup);
         
-        QDateEdit *dateEdit = new QDateEdit(QDate::currentDate());
+        QDateEdit *dateEdit = new QDateEdit(QDate::currentDate().addYears(-1));
+        dateEdit->setCalendarPopup(true);
         QTimeEdit *timeEdit = new QTimeEdit(QTime::currentTime());
         QDateTimeEdit *dateTimeEdit = new QDateTimeEdit(QDateTime::currentDateTime());
+        dateTimeEdit->setCalendarPopup(true);
+        // La période (Date -> Date/Temps) filtre le tableau de données
+        QCheckBox *periodCheck = new QCheckBox("Filtrer les données sur la période");
         
         dateLayout->addWidget(new QLabel("Date:"), 0, 0);
         dateLayout->addWidget(dateEdit, 0, 1);
@@ -375,6 +1815,7 @@ private:
         dateLayout->addWidget(timeEdit, 1, 1);
         dateLayout->addWidget(new QLabel("Date/Temps:"), 2, 0);
         dateLayout->addWidget(dateTimeEdit, 2, 1);
+        dateLayout->addWidget(periodCheck, 3, 0, 1, 2);
         
         // Groupe de listes
         QGroupBox *listGroup = new QGroupBox("Listes et Sélections");
@@ -402,16 +1843,30 @@ private:
         mainLayout->addWidget(dateGroup);
         mainLayout->addWidget(listGroup);
         
-        centralTabs->addTab(controlsWidget, "Contrôles");
-        
         // Connexions
         connect(volumeSlider, &QSlider::valueChanged, this, &AdvancedMainWindow::onVolumeChanged);
+        
+        // La colonne Date ne garde que le jour: l'heure de Date/Temps est ignorée
+        auto applyPeriod = [this, dateEdit, dateTimeEdit, periodCheck]() {
+            DateRange range;
+            if (periodCheck->isChecked()) {
+                const QDate from = dateEdit->date();
+                const QDate to = dateTimeEdit->date();
+                range.from = daysFromCivil(from.year(), unsigned(from.month()), unsigned(from.day()));
+                range.to = daysFromCivil(to.year(), unsigned(to.month()), unsigned(to.day()));
+            }
+            // Même période pour tous les documents: reprise à leur activation
+            period = range;
+            dataView->setDateRange(range);
+        };
+        connect(periodCheck, &QCheckBox::toggled, this, applyPeriod);
+        connect(dateEdit, &QDateEdit::dateChanged, this, applyPeriod);
+        connect(dateTimeEdit, &QDateTimeEdit::dateTimeChanged, this, applyPeriod);
     }
     
-    void setupLogTab()
+    void setupLogTab(QWidget *page)
     {
-        QWidget *logWidget = new QWidget;
-        QVBoxLayout *layout = new QVBoxLayout(logWidget);
+        QVBoxLayout *layout = new QVBoxLayout(page);
         
         // Contrôles de log
         QHBoxLayout *logControls = new QHBoxLayout;
@@ -419,30 +1874,124 @@ private:
         QPushButton *saveLogButton = new QPushButton("Sauvegarder Log");
         QComboBox *logLevelCombo = new QComboBox;
         logLevelCombo->addItems({"Tous", "Info", "Attention", "Erreur"});
+        logLevelCombo->setCurrentIndex(logModel->levelFilter() + 1);
+        continuousLogCheck = new QCheckBox("Écriture continue");
+        continuousLogCheck->setToolTip("Copie le journal dans un fichier au fil de l'eau "
+                                       "(rotation par taille, compression gzip possible)");
         
         logControls->addWidget(new QLabel("Niveau:"));
         logControls->addWidget(logLevelCombo);
         logControls->addStretch();
+        logControls->addWidget(continuousLogCheck);
         logControls->addWidget(clearButton);
         logControls->addWidget(saveLogButton);
         
-        // Zone de log
-        logOutput = new QTextEdit;
-        logOutput->setReadOnly(true);
-        logOutput->setFont(QFont("Courier", 9));
-        
-        // Messages d'exemple
-        logOutput->append("[INFO] Application démarrée");
-        logOutput->append("[INFO] Interface utilisateur initialisée");
-        logOutput->append("[ATTENTION] Configuration par défaut utilisée");
+        // Zone de log: seules les lignes visibles sont dessinées
+        logView = new QListView;
+        logView->setModel(logModel);
+        logView->setUniformItemSizes(true);
+        logView->setFont(QFont("Courier", 9));
+        logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+        logView->scrollToBottom();
         
         layout->addLayout(logControls);
-        layout->addWidget(logOutput);
+        layout->addWidget(logView);
+        
+        // Connexions
+        connect(clearButton, &QPushButton::clicked, logModel, &LogModel::clear);
+        connect(saveLogButton, &QPushButton::clicked, this, &AdvancedMainWindow::onSaveLog);
+        connect(continuousLogCheck, &QCheckBox::toggled, this, &AdvancedMainWindow::onContinuousLogToggled);
+        // "Tous" d'abord, puis les niveaux dans l'ordre de LogLevel
+        connect(logLevelCombo, &QComboBox::currentIndexChanged, this, [this](int index) {
+            logModel->setLevelFilter(index - 1);
+        });
+        // La vue suit les nouveaux messages tant qu'elle est en bas de liste
+        connect(logModel, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+            const QScrollBar *bar = logView->verticalScrollBar();
+            logFollowsTail = bar->value() == bar->maximum();
+        });
+        connect(logModel, &QAbstractItemModel::rowsInserted, this, [this]() {
+            if (logFollowsTail)
+                logView->scrollToBottom();
+        });
+    }
+    
+    void setupTaskTab(QWidget *page)
+    {
+        QVBoxLayout *layout = new QVBoxLayout(page);
+        
+        taskTree = new QTreeWidget;
+        taskTree->setHeaderLabels({"Tâche", "Priorité", "Progression", "Débit", "Durée"});
+        taskTree->setRootIsDecorated(false);
+        taskTree->setUniformRowHeights(true);
+        
+        QHBoxLayout *taskControls = new QHBoxLayout;
+        QPushButton *cancelTaskButton = new QPushButton("Annuler la tâche");
+        QPushButton *cancelAllButton = new QPushButton("Tout annuler");
+        taskControls->addStretch();
+        taskControls->addWidget(cancelTaskButton);
+        taskControls->addWidget(cancelAllButton);
+        
+        layout->addWidget(taskTree);
+        layout->addLayout(taskControls);
         
-        centralTabs->addTab(logWidget, "Logs");
+        // Connexions
+        connect(cancelTaskButton, &QPushButton::clicked, this, [this]() {
+            if (QTreeWidgetItem *item = taskTree->currentItem())
+                taskScheduler->cancel(item->data(0, Qt::UserRole).toULongLong());
+        });
+        connect(cancelAllButton, &QPushButton::clicked, taskScheduler, &TaskScheduler::cancelAll);
+        
+        // Tâches lancées avant la construction de l'onglet
+        refreshTaskPanel();
+    }
+    
+    void setupPerfDock()
+    {
+        perfMonitor = new PerfMonitor(this);
+        perfDock = new QDockWidget("Performances", this);
+        perfDock->setObjectName("perfDock");
+        
+        QWidget *perfWidget = new QWidget;
+        QVBoxLayout *layout = new QVBoxLayout(perfWidget);
+        
+        perfSummaryLabel = new QLabel("En attente des premières mesures...");
+        perfSummaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        
+        perfTree = new QTreeWidget;
+        perfTree->setHeaderLabels({"Point", "Appels/s", "Moyenne (µs)", "Max (µs)", "Occupation", "Éléments/s"});
+        perfTree->setRootIsDecorated(false);
+        perfTree->setUniformRowHeights(true);
+        
+        QHBoxLayout *traceControls = new QHBoxLayout;
+        traceCheck = new QCheckBox("Enregistrer la trace");
+        QPushButton *exportTraceButton = new QPushButton("Exporter la trace...");
+        QPushButton *clearTraceButton = new QPushButton("Réinitialiser");
+        traceControls->addWidget(traceCheck);
+        traceControls->addStretch();
+        traceControls->addWidget(exportTraceButton);
+        traceControls->addWidget(clearTraceButton);
+        
+        layout->addWidget(perfSummaryLabel);
+        layout->addWidget(perfTree);
+        layout->addLayout(traceControls);
+        
+        perfDock->setWidget(perfWidget);
+        addDockWidget(Qt::RightDockWidgetArea, perfDock);
+        perfDock->hide();
         
         // Connexions
-        connect(clearButton, &QPushButton::clicked, logOutput, &QTextEdit::clear);
+        connect(perfDock, &QDockWidget::visibilityChanged, perfMonitor, &PerfMonitor::setActive);
+        connect(perfMonitor, &PerfMonitor::updated, this, &AdvancedMainWindow::onPerfUpdated);
+        connect(traceCheck, &QCheckBox::toggled, this, [this](bool checked) {
+            Profiler::setTracing(checked);
+            // Sans le panneau, la fin de l'enregistrement arrête aussi la mesure
+            if (!checked && !perfMonitor->isActive())
+                Profiler::setEnabled(false);
+        });
+        connect(exportTraceButton, &QPushButton::clicked, this, &AdvancedMainWindow::onExportTrace);
+        connect(clearTraceButton, &QPushButton::clicked, this, []() { Profiler::clearTrace(); });
     }
     
     void setupMenus()
@@ -462,6 +2011,14 @@ private:
         saveAction->setShortcut(QKeySequence::Save);
         saveAction->setStatusTip("Sauvegarder le fichier actuel");
         
+        exportAction = new QAction("Exporter la vue...", this);
+        exportAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_E));
+        exportAction->setStatusTip("Exporter les lignes affichées (filtre et tri compris) en CSV ou .dat");
+        
+        closeAction = new QAction("Fermer le document", this);
+        closeAction->setShortcut(QKeySequence::Close);
+        closeAction->setStatusTip("Fermer le document affiché");
+        
         exitAction = new QAction("Quitter", this);
         exitAction->setShortcut(QKeySequence::Quit);
         exitAction->setStatusTip("Quitter l'application");
@@ -469,9 +2026,25 @@ private:
         fileMenu->addAction(newAction);
         fileMenu->addAction(openAction);
         fileMenu->addAction(saveAction);
+        fileMenu->addAction(exportAction);
+        fileMenu->addAction(closeAction);
         fileMenu->addSeparator();
         fileMenu->addAction(exitAction);
         
+        // Menu Édition (historique du document actif)
+        QMenu *editMenu = menuBar()->addMenu("Édition");
+        QAction *undoAction = undoGroup->createUndoAction(this, "Annuler");
+        undoAction->setShortcut(QKeySequence::Undo);
+        QAction *redoAction = undoGroup->createRedoAction(this, "Rétablir");
+        redoAction->setShortcut(QKeySequence::Redo);
+        editMenu->addAction(undoAction);
+        editMenu->addAction(redoAction);
+        editMenu->addSeparator();
+        addComputedAction = editMenu->addAction("Ajouter une colonne calculée...");
+        addComputedAction->setStatusTip("Colonne définie par une formule, calculée pour les lignes affichées");
+        removeComputedAction = editMenu->addAction("Retirer la colonne calculée");
+        removeComputedAction->setStatusTip("Retirer la colonne calculée de la cellule courante");
+        
         // Menu Outils
         QMenu *toolsMenu = menuBar()->addMenu("Outils");
         
@@ -480,6 +2053,24 @@ private:
         
         toolsMenu->addAction(settingsAction);
         
+        QAction *perfAction = perfDock->toggleViewAction();
+        perfAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_P));
+        perfAction->setStatusTip("Afficher les mesures de performances");
+        toolsMenu->addAction(perfAction);
+        
+        // Flux de données en direct
+        QMenu *feedMenu = toolsMenu->addMenu("Flux de données");
+        feedListenAction = feedMenu->addAction("Écouter le flux");
+        feedListenAction->setCheckable(true);
+        feedListenAction->setStatusTip(QString("Recevoir des lignes sur le socket local « %1 »").arg(FeedServerName));
+        feedGeneratorAction = feedMenu->addAction("Générateur de test");
+        feedGeneratorAction->setCheckable(true);
+        feedGeneratorAction->setEnabled(false);
+        feedGeneratorAction->setStatusTip("Envoyer des lignes de test au flux (100 000 par seconde)");
+        QAction *retentionAction = feedMenu->addAction("Rétention...");
+        retentionAction->setStatusTip("Nombre de lignes gardées pendant le flux");
+        connect(retentionAction, &QAction::triggered, this, &AdvancedMainWindow::onFeedRetention);
+        
         // Menu Aide
         QMenu *helpMenu = menuBar()->addMenu("Aide");
         
@@ -492,6 +2083,7 @@ private:
     void setupToolBar()
     {
         mainToolBar = addToolBar("Principal");
+        mainToolBar->setObjectName("mainToolBar");
         mainToolBar->addAction(newAction);
         mainToolBar->addAction(openAction);
         mainToolBar->addAction(saveAction);
@@ -499,10 +2091,17 @@ private:
         
         // Ajout de widgets dans la toolbar
         mainToolBar->addWidget(new QLabel(" Recherche rapide: "));
-        QLineEdit *quickSearch = new QLineEdit;
+        quickSearch = new QLineEdit;
         quickSearch->setMaximumWidth(200);
         quickSearch->setPlaceholderText("Recherche rapide...");
+        quickSearch->setClearButtonEnabled(true);
         mainToolBar->addWidget(quickSearch);
+        
+        // Filtrage des lignes du document actif au fil de la frappe
+        connect(quickSearch, &QLineEdit::textChanged, this, [this](const QString &text) {
+            dataView->setTextFilter(text);
+        });
+        connect(quickSearch, &QLineEdit::returnPressed, this, [this]() { dataView->applyNow(); });
     }
     
     void setupStatusBar()
@@ -510,8 +2109,8 @@ private:
         statusLabel = new QLabel("Prêt");
         statusBar()->addWidget(statusLabel);
         
-        // Indicateur de progression permanent
-        QProgressBar *permProgressBar = new QProgressBar;
+        // Indicateur de progression permanent, visible pendant les tâches
+        permProgressBar = new QProgressBar;
         permProgressBar->setMaximumWidth(150);
         permProgressBar->setVisible(false);
         statusBar()->addPermanentWidget(permProgressBar);
@@ -519,6 +2118,15 @@ private:
         // Label de statut permanent
         QLabel *permLabel = new QLabel("Connecté");
         statusBar()->addPermanentWidget(permLabel);
+        
+        // Mémoire résidente et budget des documents
+        memoryLabel = new QLabel;
+        statusBar()->addPermanentWidget(memoryLabel);
+        
+        // Débit du flux de données, visible pendant l'écoute
+        feedLabel = new QLabel;
+        feedLabel->setVisible(false);
+        statusBar()->addPermanentWidget(feedLabel);
     }
     
     void setupConnections()
@@ -526,47 +2134,52 @@ private:
         connect(newAction, &QAction::triggered, this, &AdvancedMainWindow::onNewFile);
         connect(openAction, &QAction::triggered, this, &AdvancedMainWindow::onOpenFile);
         connect(saveAction, &QAction::triggered, this, &AdvancedMainWindow::onSaveFile);
+        connect(exportAction, &QAction::triggered, this, &AdvancedMainWindow::onExportView);
+        connect(closeAction, &QAction::triggered, this, [this]() { closeDocument(document); });
+        connect(addComputedAction, &QAction::triggered, this, &AdvancedMainWindow::onAddComputedColumn);
+        connect(removeComputedAction, &QAction::triggered, this, &AdvancedMainWindow::onRemoveComputedColumn);
         connect(exitAction, &QAction::triggered, this, &QWidget::close);
         connect(aboutAction, &QAction::triggered, this, &AdvancedMainWindow::onAbout);
         connect(settingsAction, &QAction::triggered, this, &AdvancedMainWindow::onSettings);
-    }
-    
-    void setupTimer()
-    {
-        updateTimer = new QTimer(this);
-        connect(updateTimer, &QTimer::timeout, this, &AdvancedMainWindow::updateProgress);
+        
+        connect(feedListenAction, &QAction::toggled, this, &AdvancedMainWindow::onFeedToggled);
+        connect(feedGeneratorAction, &QAction::toggled, this, &AdvancedMainWindow::onFeedGeneratorToggled);
+        connect(feedController, &FeedController::statsChanged, this, &AdvancedMainWindow::onFeedStats);
+        connect(feedController, &FeedController::failed, this, [this](const QString &message) {
+            logMessage(LogLevel::Erreur, "Flux de données: " + message);
+            statusLabel->setText("Flux de données: " + message);
+        });
+        // Les numéros de lignes de l'historique ne sont plus valables
+        connect(feedController, &FeedController::rowsTrimmed, this, [this]() {
+            if (feedDocument)
+                feedDocument->undoStack()->clear();
+        });
+        
+        connect(memoryBudget, &MemoryBudget::usageChanged, this, &AdvancedMainWindow::onMemoryUsage);
+        connect(memoryBudget, &MemoryBudget::documentReleased, this, [](const QString &title, qint64 bytes, bool spilled) {
+            logMessage(LogLevel::Info, QString(spilled ? "Document « %1 » déchargé dans un fichier temporaire (%2 Mo)"
+                                                       : "Document « %1 »: pages projetées rendues (%2 Mo)")
+                                           .arg(title).arg(bytes >> 20));
+        });
+        connect(memoryBudget, &MemoryBudget::spillFailed, this, [](const QString &title, const QString &message) {
+            logMessage(LogLevel::Attention, QString("Document « %1 » non déchargé: %2").arg(title, message));
+        });
     }
 };
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    startupClock().start();
+    ProfiledApplication app(argc, argv);
     
     // Configuration de l'application
     app.setApplicationName("Gestionnaire de Données Avancé");
     app.setApplicationVersion("2.0");
     app.setOrganizationName("Mon Entreprise");
     
-    // Style moderne
+    // Style moderne (thème sombre éventuel: restauré avec la session)
     app.setStyle("Fusion");
     
-    // Palette sombre optionnelle
-    QPalette darkPalette;
-    darkPalette.setColor(QPalette::Window, QColor(53, 53, 53));
-    darkPalette.setColor(QPalette::WindowText, Qt::white);
-    darkPalette.setColor(QPalette::Base, QColor(25, 25, 25));
-    darkPalette.setColor(QPalette::AlternateBase, QColor(53, 53, 53));
-    darkPalette.setColor(QPalette::ToolTipBase, Qt::white);
-    darkPalette.setColor(QPalette::ToolTipText, Qt::white);
-    darkPalette.setColor(QPalette::Text, Qt::white);
-    darkPalette.setColor(QPalette::Button, QColor(53, 53, 53));
-    darkPalette.setColor(QPalette::ButtonText, Qt::white);
-    darkPalette.setColor(QPalette::BrightText, Qt::red);
-    darkPalette.setColor(QPalette::Link, QColor(42, 130, 218));
-    darkPalette.setColor(QPalette::Highlight, QColor(42, 130, 218));
-    darkPalette.setColor(QPalette::HighlightedText, Qt::black);
-    // app.setPalette(darkPalette); // Décommentez pour le thème sombre
-    
     AdvancedMainWindow window;
     window.show();
     
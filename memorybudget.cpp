@@ -0,0 +1,209 @@
+// memorybudget.cpp
+#include "memorybudget.h"
+#include "datadocument.h"
+#include "datatablemodel.h"
+#include "datfile.h"
+#include "profiler.h"
+#include "taskscheduler.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <algorithm>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Les blocs libérés sont rendus au système, pas seulement à l'allocateur
+void trimHeap()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+} // namespace
+
+MemoryBudget::MemoryBudget(TaskScheduler *scheduler, QObject *parent)
+    : QObject(parent)
+    , scheduler(scheduler)
+    , checkTimer(new QTimer(this))
+    , limitBytes(size_t(DefaultLimitMb) << 20)
+{
+    checkTimer->setInterval(CheckIntervalMs);
+    connect(checkTimer, &QTimer::timeout, this, &MemoryBudget::check);
+    checkTimer->start();
+}
+
+MemoryBudget::~MemoryBudget() = default;
+
+void MemoryBudget::setLimit(size_t bytes)
+{
+    limitBytes = bytes;
+    check();
+}
+
+void MemoryBudget::addDocument(DataDocument *document)
+{
+    Entry entry;
+    entry.document = document;
+    entry.lastUse = ++useCount;
+    entry.version = document->model()->store().version();
+    entries.push_back(entry);
+}
+
+void MemoryBudget::removeDocument(DataDocument *document)
+{
+    Entry *entry = find(document);
+    if (!entry)
+        return;
+    // Sous Windows, le fichier encore projeté est retiré avec le dossier
+    if (!entry->spillFile.isEmpty())
+        QFile::remove(entry->spillFile);
+    entries.erase(entries.begin() + (entry - entries.data()));
+}
+
+void MemoryBudget::setActive(DataDocument *document)
+{
+    active = document;
+    if (Entry *entry = find(document)) {
+        entry->lastUse = ++useCount;
+        entry->pagesResident = true;
+    }
+}
+
+MemoryBudget::Entry *MemoryBudget::find(DataDocument *document)
+{
+    for (Entry &entry : entries) {
+        if (entry.document == document)
+            return &entry;
+    }
+    return nullptr;
+}
+
+size_t MemoryBudget::estimatedUsage() const
+{
+    size_t bytes = StringPool::instance().memoryUsage();
+    for (const Entry &entry : entries) {
+        if (entry.document)
+            bytes += entry.document->model()->store().memoryUsage();
+    }
+    return bytes;
+}
+
+void MemoryBudget::check()
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry &entry) {
+        return !entry.document;
+    }), entries.end());
+    for (Entry &entry : entries) {
+        const quint64 version = entry.document->model()->store().version();
+        if (version != entry.version) {
+            entry.version = version;
+            entry.lastUse = ++useCount;
+            entry.pagesResident = true;
+            entry.spillFailed = false;
+        }
+    }
+
+    const int64_t measured = Profiler::residentMemory();
+    const size_t resident = measured >= 0 ? size_t(measured) : estimatedUsage();
+    emit usageChanged(qint64(resident), qint64(limitBytes));
+    if (limitBytes == 0 || resident <= limitBytes || spilling)
+        return;
+    PROFILE_SCOPE("Budget mémoire");
+
+    // Du moins récemment utilisé au plus récent
+    std::vector<Entry *> cold;
+    for (Entry &entry : entries) {
+        if (entry.document != active)
+            cold.push_back(&entry);
+    }
+    std::sort(cold.begin(), cold.end(), [](const Entry *a, const Entry *b) { return a->lastUse < b->lastUse; });
+
+    size_t excess = resident - limitBytes;
+    for (Entry *entry : cold) {
+        DataDocument *document = entry->document;
+        const ColumnStore &store = document->model()->store();
+        if (entry->pagesResident) {
+            entry->pagesResident = false;
+            const size_t released = DatFile::releasePages(store.table());
+            if (released > 0) {
+                emit documentReleased(document->title(), qint64(released), false);
+                excess -= std::min(excess, released);
+                if (excess == 0)
+                    return;
+            }
+        }
+        // Une copie à la fois: le relevé suivant en mesure l'effet
+        if (!entry->spillFailed && store.memoryUsage() >= MinSpillBytes) {
+            spill(*entry);
+            return;
+        }
+    }
+}
+
+void MemoryBudget::spill(Entry &entry)
+{
+    QPointer<DataDocument> document = entry.document;
+    if (!spillDir)
+        spillDir = std::make_unique<QTemporaryDir>(QDir::temp().filePath("interfaceqt-XXXXXX"));
+    if (!spillDir->isValid()) {
+        entry.spillFailed = true;
+        emit spillFailed(document->title(), "dossier temporaire indisponible: " + spillDir->errorString());
+        return;
+    }
+
+    const ColumnStore &store = document->model()->store();
+    ColumnTablePtr snapshot = store.snapshot();
+    const quint64 version = store.version();
+    const qint64 bytes = qint64(store.memoryUsage());
+    const QString fileName = spillDir->filePath(QString("document-%1.dat").arg(++spillCount));
+    auto loaded = std::make_shared<ColumnTable>();
+    auto error = std::make_shared<QString>();
+    auto ok = std::make_shared<bool>(false);
+    spilling = true;
+
+    scheduler->run("Déchargement " + document->title(), "blocs", TaskPriority::Bulk,
+        [snapshot, fileName, loaded, error, ok](TaskContext &task) mutable {
+            *ok = DatFile::save(*snapshot, fileName, DatFile::NoCompression, error.get(),
+                                [&task](qint64 done, qint64 total) {
+                                    task.setTotal(total);
+                                    task.setDone(done);
+                                    return !task.isCancelled();
+                                });
+            // Les blocs alloués ne doivent plus être retenus par la tâche
+            snapshot.reset();
+            // Fichier écrit à l'instant: les codes ne sont pas relus
+            *ok = *ok && DatFile::load(fileName, *loaded, error.get(), false);
+        },
+        [this, document, fileName, version, bytes, loaded, error, ok](bool cancelled) {
+            spilling = false;
+            Entry *entry = document ? find(document) : nullptr;
+            // Fermé ou modifié entre-temps: la copie ne correspond plus
+            if (!*ok || !entry || document->model()->store().version() != version) {
+                loaded->clear();
+                QFile::remove(fileName);
+                if (!*ok && !cancelled && entry) {
+                    entry->spillFailed = true;
+                    emit spillFailed(document->title(), *error);
+                }
+                return;
+            }
+            document->model()->adoptStorage(*loaded);
+            loaded->clear();
+            if (!entry->spillFile.isEmpty())
+                QFile::remove(entry->spillFile);
+            entry->spillFile = fileName;
+            // Les segments relus à l'ouverture sont rendus eux aussi
+            DatFile::releasePages(document->model()->store().table());
+            entry->pagesResident = document == active;
+            trimHeap();
+            emit documentReleased(document->title(), bytes, true);
+        });
+}
@@ -0,0 +1,85 @@
+// memorybudget.h
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+class DataDocument;
+class QTemporaryDir;
+class QTimer;
+class TaskScheduler;
+
+// Budget de mémoire résidente des documents ouverts. Au-delà de la limite,
+// les documents inactifs rendent leur mémoire, du moins récemment utilisé
+// au plus récent:
+// - les pages des blocs projetés depuis un fichier .dat sont rendues au
+//   système, elles seront relues depuis le fichier au prochain accès;
+// - les blocs alloués (fichier texte, flux, modifications) sont écrits tels
+//   quels dans un fichier temporaire puis remplacés par sa projection.
+//   Contenu et version sont inchangés: tri, filtres et index du document
+//   restent valables, et revenir sur le document ne relit que les pages
+//   affichées.
+// Le document actif n'est jamais touché; un document modifié depuis le
+// relevé précédent (chargement, flux) compte comme utilisé.
+class MemoryBudget : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CheckIntervalMs = 2000;
+    static constexpr int DefaultLimitMb = 4096;
+    // En dessous, un document ne vaut pas une écriture sur disque
+    static constexpr size_t MinSpillBytes = size_t(16) << 20;
+
+    explicit MemoryBudget(TaskScheduler *scheduler, QObject *parent = nullptr);
+    ~MemoryBudget() override;
+
+    // 0: sans limite
+    void setLimit(size_t bytes);
+    size_t limit() const { return limitBytes; }
+
+    void addDocument(DataDocument *document);
+    void removeDocument(DataDocument *document);
+    void setActive(DataDocument *document);
+
+    // Relevé immédiat (fin de chargement); sinon toutes les CheckIntervalMs
+    void check();
+
+signals:
+    void usageChanged(qint64 residentBytes, qint64 limitBytes);
+    // bytes: octets rendus; spilled: copiés dans un fichier temporaire
+    void documentReleased(const QString &title, qint64 bytes, bool spilled);
+    void spillFailed(const QString &title, const QString &message);
+
+private:
+    struct Entry
+    {
+        QPointer<DataDocument> document;
+        quint64 lastUse = 0;
+        quint64 version = 0;
+        bool pagesResident = true;   // pages projetées lues depuis l'activation
+        bool spillFailed = false;    // pas de nouvel essai avant une modification
+        QString spillFile;
+    };
+
+    TaskScheduler *scheduler;
+    QTimer *checkTimer;
+    std::unique_ptr<QTemporaryDir> spillDir;
+    std::vector<Entry> entries;
+    QPointer<DataDocument> active;
+    size_t limitBytes = 0;
+    quint64 useCount = 0;
+    quint64 spillCount = 0;
+    bool spilling = false;
+
+    Entry *find(DataDocument *document);
+    size_t estimatedUsage() const;
+    void spill(Entry &entry);
+};
+
+#endif // MEMORYBUDGET_H
@@ -0,0 +1,238 @@
+// nodetable.cpp
+#include "nodetable.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Le parent d'un nœud détaché (supprimé)
+constexpr uint32_t Detached = NodeTable::NoNode - 1;
+
+ValueStats single(double valeur)
+{
+    ValueStats stats;
+    if (!std::isnan(valeur)) {
+        stats.count = 1;
+        stats.sum = valeur;
+        stats.min = valeur;
+        stats.max = valeur;
+    }
+    return stats;
+}
+
+} // namespace
+
+uint32_t NodeTable::addNode(uint32_t parent, std::string_view name, std::string_view kind, double valeur)
+{
+    const uint32_t node = uint32_t(parents.size());
+    parents.push_back(NoNode);
+    firstChildren.push_back(NoNode);
+    lastChildren.push_back(NoNode);
+    nextSiblings.push_back(NoNode);
+    previousSiblings.push_back(NoNode);
+    childCounts.push_back(0);
+    kinds.push_back(kindIndex.intern(kindValues, kind));
+    valeurs.push_back(valeur);
+    rollups.push_back(single(valeur));
+    nameValues.append(name);
+
+    link(node, parent);
+    if (rollupsReady)
+        addToPath(parent, rollups[node]);
+    return node;
+}
+
+void NodeTable::link(uint32_t node, uint32_t parent)
+{
+    // Chaînage en dernier enfant: l'ordre d'ajout est l'ordre d'affichage
+    uint32_t &first = parent == NoNode ? firstRoot : firstChildren[parent];
+    uint32_t &last = parent == NoNode ? lastRoot : lastChildren[parent];
+    parents[node] = parent;
+    previousSiblings[node] = last;
+    nextSiblings[node] = NoNode;
+    if (last == NoNode)
+        first = node;
+    else
+        nextSiblings[last] = node;
+    last = node;
+    if (parent == NoNode)
+        ++rootCount;
+    else
+        ++childCounts[parent];
+}
+
+void NodeTable::unlink(uint32_t node)
+{
+    const uint32_t parent = parents[node];
+    uint32_t &first = parent == NoNode ? firstRoot : firstChildren[parent];
+    uint32_t &last = parent == NoNode ? lastRoot : lastChildren[parent];
+    const uint32_t previous = previousSiblings[node];
+    const uint32_t next = nextSiblings[node];
+    if (previous == NoNode)
+        first = next;
+    else
+        nextSiblings[previous] = next;
+    if (next == NoNode)
+        last = previous;
+    else
+        previousSiblings[next] = previous;
+    if (parent == NoNode)
+        --rootCount;
+    else
+        --childCounts[parent];
+    parents[node] = Detached;
+    previousSiblings[node] = NoNode;
+    nextSiblings[node] = NoNode;
+}
+
+void NodeTable::reserve(size_t nodes)
+{
+    parents.reserve(nodes);
+    firstChildren.reserve(nodes);
+    lastChildren.reserve(nodes);
+    nextSiblings.reserve(nodes);
+    previousSiblings.reserve(nodes);
+    childCounts.reserve(nodes);
+    kinds.reserve(nodes);
+    valeurs.reserve(nodes);
+    rollups.reserve(nodes);
+}
+
+void NodeTable::clear()
+{
+    *this = NodeTable();
+}
+
+void NodeTable::computeRollups()
+{
+    // Parcours en largeur depuis les racines: order contient les nœuds
+    // rattachés, niveau après niveau; levels[k] est le début du niveau k
+    std::vector<uint32_t> order;
+    order.reserve(parents.size());
+    std::vector<size_t> levels{0};
+    for (uint32_t root = firstRoot; root != NoNode; root = nextSiblings[root])
+        order.push_back(root);
+    size_t begin = 0;
+    while (begin < order.size()) {
+        const size_t end = order.size();
+        levels.push_back(end);
+        for (size_t i = begin; i < end; ++i) {
+            for (uint32_t child = firstChildren[order[i]]; child != NoNode; child = nextSiblings[child])
+                order.push_back(child);
+        }
+        begin = end;
+    }
+
+    // Du niveau le plus profond vers la racine: les enfants d'un niveau
+    // sont déjà cumulés quand on le traite, chaque nœud n'écrit que le sien
+    for (size_t level = levels.size() - 1; level-- > 0;) {
+        const size_t first = levels[level];
+        parallelFor(levels[level + 1] - first, 4096, [&](size_t from, size_t to) {
+            for (size_t i = first + from; i < first + to; ++i) {
+                const uint32_t node = order[i];
+                ValueStats total = single(valeurs[node]);
+                for (uint32_t child = firstChildren[node]; child != NoNode; child = nextSiblings[child])
+                    total.merge(rollups[child]);
+                rollups[node] = total;
+            }
+        });
+    }
+    rollupsReady = true;
+}
+
+void NodeTable::addToPath(uint32_t from, const ValueStats &added)
+{
+    if (added.count == 0)
+        return;
+    for (uint32_t node = from; node != NoNode && node != Detached; node = parents[node])
+        rollups[node].merge(added);
+}
+
+void NodeTable::removeFromPath(uint32_t from, const ValueStats &removed)
+{
+    if (removed.count == 0)
+        return;
+    for (uint32_t node = from; node != NoNode && node != Detached; node = parents[node]) {
+        ValueStats &stats = rollups[node];
+        stats.count -= removed.count;
+        if (stats.count == 0) {
+            stats = ValueStats();
+            continue;
+        }
+        stats.sum -= removed.sum;
+        // Un extrême retiré se retrouve parmi les enfants, déjà à jour
+        if (removed.min <= stats.min || removed.max >= stats.max)
+            recomputeExtremes(node);
+    }
+}
+
+void NodeTable::recomputeExtremes(uint32_t node)
+{
+    ValueStats &stats = rollups[node];
+    const ValueStats own = single(valeurs[node]);
+    stats.min = own.min;
+    stats.max = own.max;
+    for (uint32_t child = firstChildren[node]; child != NoNode; child = nextSiblings[child]) {
+        stats.min = std::min(stats.min, rollups[child].min);
+        stats.max = std::max(stats.max, rollups[child].max);
+    }
+}
+
+void NodeTable::setValeur(uint32_t node, double valeur)
+{
+    if (!rollupsReady) {
+        valeurs[node] = valeur;
+        rollups[node] = single(valeur);
+        return;
+    }
+    // L'ancienne valeur est retirée du chemin (le nœud compris), puis la
+    // nouvelle y est ajoutée
+    const ValueStats previous = single(valeurs[node]);
+    valeurs[node] = std::nan("");
+    removeFromPath(node, previous);
+    valeurs[node] = valeur;
+    addToPath(node, single(valeur));
+}
+
+void NodeTable::removeNode(uint32_t node)
+{
+    const uint32_t parent = parents[node];
+    if (parent == Detached)
+        return;
+    unlink(node);
+    if (rollupsReady)
+        removeFromPath(parent, rollups[node]);
+}
+
+bool NodeTable::contains(uint32_t ancestor, uint32_t node) const
+{
+    for (; node != NoNode && node != Detached; node = parents[node]) {
+        if (node == ancestor)
+            return true;
+    }
+    return false;
+}
+
+bool NodeTable::moveNode(uint32_t node, uint32_t parent)
+{
+    const uint32_t previousParent = parents[node];
+    if (previousParent == Detached || contains(node, parent))
+        return false;
+    unlink(node);
+    if (rollupsReady)
+        removeFromPath(previousParent, rollups[node]);
+    link(node, parent);
+    if (rollupsReady)
+        addToPath(parent, rollups[node]);
+    return true;
+}
+
+size_t NodeTable::memoryUsage() const
+{
+    return (parents.capacity() + firstChildren.capacity() + lastChildren.capacity() + nextSiblings.capacity()
+            + previousSiblings.capacity() + childCounts.capacity() + kinds.capacity()) * sizeof(uint32_t)
+         + valeurs.capacity() * sizeof(double) + rollups.capacity() * sizeof(ValueStats)
+         + kindIndex.memoryUsage();
+}
@@ -0,0 +1,92 @@
+// nodetable.h
+#ifndef NODETABLE_H
+#define NODETABLE_H
+
+#include "columnstore.h"
+#include "summaryengine.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Arbre stocké à plat: un nœud est un indice dans des tableaux parallèles
+// (parent, premier et dernier enfant, frère suivant) et dans les colonnes
+// Élément/Type/Valeur. Aucune allocation par nœud: des centaines de
+// milliers de nœuds tiennent dans quelques tableaux contigus. NoNode
+// désigne la racine invisible, parent des nœuds de premier niveau.
+//
+// Chaque nœud porte le cumul de Valeur de son sous-arbre (nombre, somme,
+// extrêmes). Les cumuls sont calculés d'un bloc par computeRollups(), puis
+// tenus à jour opération par opération en ne remontant que le chemin vers
+// la racine. Un nœud supprimé est seulement détaché: son indice n'est pas
+// réutilisé.
+class NodeTable
+{
+public:
+    static constexpr uint32_t NoNode = UINT32_MAX;
+
+    size_t size() const { return parents.size(); }
+    bool empty() const { return parents.empty(); }
+
+    // Ajoute un nœud en dernier enfant de parent; valeur NaN: sans valeur
+    uint32_t addNode(uint32_t parent, std::string_view name, std::string_view kind, double valeur);
+    void reserve(size_t nodes);
+    void clear();
+
+    // Calcule tous les cumuls, niveau par niveau des feuilles vers la
+    // racine; les nœuds d'un même niveau sont traités en parallèle
+    void computeRollups();
+    bool hasRollups() const { return rollupsReady; }
+    const ValueStats &rollup(uint32_t node) const { return rollups[node]; }
+
+    // Opérations qui tiennent les cumuls à jour (chemin vers la racine)
+    void setValeur(uint32_t node, double valeur);
+    // Détache le nœud et son sous-arbre
+    void removeNode(uint32_t node);
+    // Déplace le nœud et son sous-arbre en dernier enfant de parent;
+    // refusé si parent est dans ce sous-arbre
+    bool moveNode(uint32_t node, uint32_t parent);
+    // ancestor est node ou l'un de ses ascendants
+    bool contains(uint32_t ancestor, uint32_t node) const;
+
+    uint32_t parent(uint32_t node) const { return parents[node]; }
+    uint32_t firstChild(uint32_t node) const { return node == NoNode ? firstRoot : firstChildren[node]; }
+    uint32_t nextSibling(uint32_t node) const { return nextSiblings[node]; }
+    size_t childCount(uint32_t node) const { return node == NoNode ? rootCount : childCounts[node]; }
+
+    std::string_view name(uint32_t node) const { return nameValues[node]; }
+    std::string_view kind(uint32_t node) const { return kindValues[kinds[node]]; }
+    double valeur(uint32_t node) const { return valeurs[node]; }
+
+    size_t memoryUsage() const;
+
+private:
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> firstChildren;
+    std::vector<uint32_t> lastChildren;
+    std::vector<uint32_t> nextSiblings;
+    std::vector<uint32_t> previousSiblings;
+    std::vector<uint32_t> childCounts;
+    std::vector<uint32_t> kinds;       // codes dans kindValues
+    std::vector<double> valeurs;
+    std::vector<ValueStats> rollups;
+    bool rollupsReady = false;
+
+    StringColumn nameValues;           // un nom par nœud, dans l'ordre des nœuds
+    StringColumn kindValues;
+    StringIndex kindIndex;
+
+    uint32_t firstRoot = NoNode;
+    uint32_t lastRoot = NoNode;
+    size_t rootCount = 0;
+
+    void link(uint32_t node, uint32_t parent);
+    void unlink(uint32_t node);
+    // Ajoute ou retire le cumul d'un sous-arbre à from et à ses ascendants
+    void addToPath(uint32_t from, const ValueStats &added);
+    void removeFromPath(uint32_t from, const ValueStats &removed);
+    // Extrêmes de node refaits à partir de sa valeur et des cumuls des enfants
+    void recomputeExtremes(uint32_t node);
+};
+
+#endif // NODETABLE_H
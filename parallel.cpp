@@ -0,0 +1,212 @@
+// parallel.cpp
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+// Thread de réserve courant et priorité de la tâche qu'il exécute
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+thread_local TaskPriority runningPriority = TaskPriority::Interactive;
+
+} // namespace
+
+ThreadPool &ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    // Au moins deux threads: l'un d'eux reste toujours disponible pour l'interactif
+    threads = std::max<size_t>(threads, 2);
+    bulkLimit = threads - 1;
+    for (size_t i = 0; i <= threads; ++i)
+        queues.push_back(std::make_unique<Queue>());
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back([this, i]() { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+TaskPriority ThreadPool::currentPriority()
+{
+    return runningPriority;
+}
+
+void ThreadPool::submit(std::function<void()> task, TaskPriority priority)
+{
+    const size_t level = size_t(priority);
+    Queue &queue = currentPool == this ? *queues[currentWorker] : *queues.back();
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks[level].push_back(std::move(task));
+    }
+    pending[level].fetch_add(1);
+    notify();
+}
+
+void ThreadPool::notify(bool all)
+{
+    // Passage par le verrou: un thread qui vient d'évaluer canRun() sans
+    // s'être encore endormi ne peut pas manquer le réveil
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    if (all)
+        wakeUp.notify_all();
+    else
+        wakeUp.notify_one();
+}
+
+bool ThreadPool::canRun() const
+{
+    return pending[size_t(TaskPriority::Interactive)].load() > 0
+        || (pending[size_t(TaskPriority::Bulk)].load() > 0 && bulkRunning.load() < bulkLimit);
+}
+
+bool ThreadPool::take(size_t index, TaskPriority priority, std::function<void()> &task)
+{
+    const size_t level = size_t(priority);
+    if (pending[level].load() == 0)
+        return false;
+    {
+        Queue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks[level].empty()) {
+            task = std::move(own.tasks[level].back());
+            own.tasks[level].pop_back();
+            pending[level].fetch_sub(1);
+            return true;
+        }
+    }
+    // Vol par le début, en commençant par le voisin suivant
+    const size_t count = queues.size();
+    for (size_t k = 1; k < count; ++k) {
+        Queue &other = *queues[(index + k) % count];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks[level].empty()) {
+            task = std::move(other.tasks[level].front());
+            other.tasks[level].pop_front();
+            pending[level].fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+    for (;;) {
+        std::function<void()> task;
+        TaskPriority priority = TaskPriority::Interactive;
+        bool found = take(index, TaskPriority::Interactive, task);
+        if (!found) {
+            // Une place Bulk est réservée avant de chercher, rendue si rien n'est trouvé
+            if (bulkRunning.fetch_add(1) < bulkLimit && take(index, TaskPriority::Bulk, task)) {
+                found = true;
+                priority = TaskPriority::Bulk;
+            } else {
+                bulkRunning.fetch_sub(1);
+            }
+        }
+        if (found) {
+            runningPriority = priority;
+            task();
+            runningPriority = TaskPriority::Interactive;
+            if (priority == TaskPriority::Bulk)
+                bulkRunning.fetch_sub(1);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return stopping || canRun(); });
+        if (stopping && !canRun())
+            return;
+    }
+}
+
+namespace {
+
+struct ParallelForState
+{
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> running{0};
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+} // namespace
+
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &fn)
+{
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+    const size_t chunks = (count + grain - 1) / grain;
+    ThreadPool &pool = ThreadPool::instance();
+    if (chunks == 1 || pool.threadCount() <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Les tranches sont réclamées par compteur atomique: un assistant qui
+    // démarre après la fin ne trouve plus rien et repart aussitôt.
+    auto state = std::make_shared<ParallelForState>();
+    auto work = [state, count, grain, chunks, &fn]() {
+        for (;;) {
+            state->running.fetch_add(1);
+            const size_t chunk = state->next.fetch_add(1);
+            if (chunk >= chunks) {
+                if (state->running.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->done.notify_all();
+                }
+                return;
+            }
+            const size_t begin = chunk * grain;
+            const size_t end = begin + grain < count ? begin + grain : count;
+            fn(begin, end);
+            if (state->running.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(pool.threadCount(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i)
+        pool.submit(work, ThreadPool::currentPriority());
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state]() { return state->running.load() == 0; });
+}
+
+std::future<void> runAsync(std::function<void()> task, TaskPriority priority)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    ThreadPool::instance().submit([promise, task = std::move(task)]() {
+        task();
+        promise->set_value();
+    }, priority);
+    return future;
+}
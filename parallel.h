@@ -0,0 +1,80 @@
+// parallel.h
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Interactive: l'utilisateur attend le résultat (recherche, tri, synthèse).
+// Bulk: travail de fond (sauvegarde, export, construction d'index).
+enum class TaskPriority { Interactive, Bulk };
+
+// Réserve de threads de travail partagée par les moteurs (recherche, filtre...)
+//
+// Chaque thread a sa propre file: ce qu'il soumet y est empilé et repris par
+// lui en dernier arrivé, premier servi (données encore en cache); un thread
+// sans travail vole par l'autre bout dans la file des autres. Les soumissions
+// extérieures passent par une file commune.
+//
+// Les tâches Interactive passent toujours avant les tâches Bulk, et celles-ci
+// n'occupent jamais plus de threadCount() - 1 threads: un travail interactif
+// trouve un thread libre au plus tard à la fin de la tranche Bulk en cours.
+// Une tâche hérite de la priorité de celle qui la soumet (parallelFor).
+class ThreadPool
+{
+public:
+    static ThreadPool &instance();
+
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t threadCount() const { return workers.size(); }
+    void submit(std::function<void()> task, TaskPriority priority = TaskPriority::Interactive);
+
+    // Priorité de la tâche en cours sur ce thread (Interactive hors réserve)
+    static TaskPriority currentPriority();
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks[2];
+    };
+
+    std::vector<std::thread> workers;
+    // Une file par thread, puis la file commune
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> pending[2] = {};
+    std::atomic<size_t> bulkRunning{0};
+    size_t bulkLimit = 1;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    void workerLoop(size_t index);
+    bool take(size_t index, TaskPriority priority, std::function<void()> &task);
+    bool canRun() const;
+    void notify(bool all = false);
+};
+
+// Découpe [0, count) en tranches de grain éléments et appelle fn(begin, end)
+// sur tous les cœurs. Le thread appelant participe et l'appel ne rend la main
+// qu'une fois toutes les tranches traitées; il peut donc être imbriqué dans
+// une tâche de la réserve sans risque d'interblocage.
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &fn);
+
+// Soumet une tâche à la réserve et renvoie de quoi attendre sa fin
+std::future<void> runAsync(std::function<void()> task, TaskPriority priority = TaskPriority::Interactive);
+
+#endif // PARALLEL_H
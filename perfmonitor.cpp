@@ -0,0 +1,140 @@
+// perfmonitor.cpp
+#include "perfmonitor.h"
+
+#include <QFile>
+#include <QTimer>
+#include <QWidget>
+
+#include <algorithm>
+
+PerfMonitor::PerfMonitor(QObject *parent)
+    : QObject(parent)
+    , refreshTimer(new QTimer(this))
+    , probeTimer(new QTimer(this))
+{
+    refreshTimer->setInterval(RefreshIntervalMs);
+    probeTimer->setInterval(ProbeIntervalMs);
+    probeTimer->setTimerType(Qt::PreciseTimer);
+    connect(refreshTimer, &QTimer::timeout, this, &PerfMonitor::refresh);
+    connect(probeTimer, &QTimer::timeout, this, &PerfMonitor::probe);
+}
+
+ProfilePoint &PerfMonitor::framePoint()
+{
+    static ProfilePoint point("Image");
+    return point;
+}
+
+void PerfMonitor::setActive(bool on)
+{
+    if (on == active)
+        return;
+    active = on;
+    if (!active) {
+        refreshTimer->stop();
+        probeTimer->stop();
+        // La trace en cours d'enregistrement garde la mesure active
+        if (!Profiler::isTracing())
+            Profiler::setEnabled(false);
+        return;
+    }
+    Profiler::setEnabled(true);
+    // Premier intervalle: ce qui précède l'activation n'est pas compté
+    previous.clear();
+    for (ProfilePoint *point : Profiler::points()) {
+        const ProfilePoint::Totals totals = point->totals();
+        previous[point] = {totals.calls, totals.totalNs, totals.items};
+        point->takeMax();
+    }
+    latencySumMs = 0;
+    latencyMaxMs = 0;
+    latencySamples = 0;
+    intervalClock.start();
+    probeClock.start();
+    refreshTimer->start();
+    probeTimer->start();
+}
+
+void PerfMonitor::probe()
+{
+    const double late = std::max(0.0, double(probeClock.nsecsElapsed()) / 1e6 - ProbeIntervalMs);
+    probeClock.restart();
+    latencySumMs += late;
+    latencyMaxMs = std::max(latencyMaxMs, late);
+    ++latencySamples;
+}
+
+void PerfMonitor::refresh()
+{
+    const double seconds = std::max<qint64>(intervalClock.nsecsElapsed(), 1) / 1e9;
+    intervalClock.restart();
+
+    PerfSnapshot snapshot;
+    for (ProfilePoint *point : Profiler::points()) {
+        const ProfilePoint::Totals totals = point->totals();
+        const uint64_t maxNs = point->takeMax();
+        Previous &before = previous[point];
+        const uint64_t calls = totals.calls - before.calls;
+        const uint64_t busyNs = totals.totalNs - before.totalNs;
+        const uint64_t items = totals.items - before.items;
+        before = {totals.calls, totals.totalNs, totals.items};
+        if (calls == 0)
+            continue;
+
+        PerfSnapshot::Point measured;
+        measured.name = QString::fromUtf8(point->name());
+        measured.callsPerSecond = double(calls) / seconds;
+        measured.averageUs = double(busyNs) / double(calls) / 1e3;
+        measured.maxUs = double(maxNs) / 1e3;
+        measured.busyPercent = double(busyNs) / (seconds * 1e9) * 100.0;
+        measured.itemsPerSecond = double(items) / seconds;
+        if (point == &framePoint()) {
+            snapshot.framesPerSecond = measured.callsPerSecond;
+            snapshot.frameAverageMs = measured.averageUs / 1e3;
+            snapshot.frameMaxMs = measured.maxUs / 1e3;
+        }
+        snapshot.points.push_back(std::move(measured));
+    }
+    std::sort(snapshot.points.begin(), snapshot.points.end(),
+              [](const PerfSnapshot::Point &a, const PerfSnapshot::Point &b) { return a.busyPercent > b.busyPercent; });
+
+    if (latencySamples > 0) {
+        snapshot.latencyAverageMs = latencySumMs / latencySamples;
+        snapshot.latencyMaxMs = latencyMaxMs;
+    }
+    latencySumMs = 0;
+    latencyMaxMs = 0;
+    latencySamples = 0;
+    snapshot.residentBytes = qint64(Profiler::residentMemory());
+    snapshot.traceEvents = Profiler::eventCount();
+    emit updated(snapshot);
+}
+
+bool PerfMonitor::exportTrace(const QString &fileName, QString *errorMessage)
+{
+    const std::string json = Profiler::traceJson();
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(json.data(), qint64(json.size())) != qint64(json.size())) {
+        if (errorMessage)
+            *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ProfiledApplication::notify(QObject *receiver, QEvent *event)
+{
+    if (!Profiler::isEnabled())
+        return QApplication::notify(receiver, event);
+    if (event->type() == QEvent::UpdateRequest && receiver->isWidgetType()
+        && static_cast<QWidget *>(receiver)->isWindow()) {
+        ProfileScope scope(PerfMonitor::framePoint());
+        return QApplication::notify(receiver, event);
+    }
+    if (event->type() == QEvent::Paint) {
+        PROFILE_AGGREGATE("Dessin des widgets");
+        return QApplication::notify(receiver, event);
+    }
+    return QApplication::notify(receiver, event);
+}
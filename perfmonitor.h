@@ -0,0 +1,100 @@
+// perfmonitor.h
+#ifndef PERFMONITOR_H
+#define PERFMONITOR_H
+
+#include "profiler.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include <unordered_map>
+#include <vector>
+
+class QTimer;
+
+// Mesures d'un intervalle de relevé, ramenées à la seconde
+struct PerfSnapshot
+{
+    struct Point
+    {
+        QString name;
+        double callsPerSecond = 0;
+        double averageUs = 0;
+        double maxUs = 0;
+        double busyPercent = 0;   // temps passé dans le point / durée de l'intervalle
+        // Éléments comptés par le point (addItems): lignes, octets... selon
+        // le point. Pas de total: les points imbriqués compteraient deux fois
+        // les mêmes lignes.
+        double itemsPerSecond = 0;
+    };
+
+    double framesPerSecond = 0;
+    double frameAverageMs = 0;
+    double frameMaxMs = 0;
+    double latencyAverageMs = 0;
+    double latencyMaxMs = 0;
+    qint64 residentBytes = -1;
+    size_t traceEvents = 0;
+    // Points actifs pendant l'intervalle, du plus occupé au moins occupé
+    std::vector<Point> points;
+};
+
+// Relevé périodique des points de mesure pour le panneau de performances.
+// Actif, il allume le profileur et sonde la latence de la boucle
+// d'événements: un minuteur de ProbeIntervalMs mesure son propre retard.
+// Inactif, plus rien n'est mesuré (hors enregistrement de la trace).
+class PerfMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RefreshIntervalMs = 500;
+    static constexpr int ProbeIntervalMs = 50;
+
+    explicit PerfMonitor(QObject *parent = nullptr);
+
+    void setActive(bool active);
+    bool isActive() const { return active; }
+
+    // Une image: traitement d'une demande de rafraîchissement d'une fenêtre
+    static ProfilePoint &framePoint();
+    static bool exportTrace(const QString &fileName, QString *errorMessage = nullptr);
+
+signals:
+    void updated(const PerfSnapshot &snapshot);
+
+private:
+    struct Previous
+    {
+        uint64_t calls = 0;
+        uint64_t totalNs = 0;
+        uint64_t items = 0;
+    };
+
+    bool active = false;
+    QTimer *refreshTimer;
+    QTimer *probeTimer;
+    QElapsedTimer intervalClock;
+    QElapsedTimer probeClock;
+    double latencySumMs = 0;
+    double latencyMaxMs = 0;
+    int latencySamples = 0;
+    std::unordered_map<const ProfilePoint *, Previous> previous;
+
+    void probe();
+    void refresh();
+};
+
+// Application qui mesure les images et le dessin des widgets quand le
+// profileur est actif; sinon un simple test avant l'envoi de l'événement
+class ProfiledApplication : public QApplication
+{
+public:
+    using QApplication::QApplication;
+
+    bool notify(QObject *receiver, QEvent *event) override;
+};
+
+#endif // PERFMONITOR_H
@@ -0,0 +1,260 @@
+// profiler.cpp
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+std::atomic<bool> Profiler::enabled{false};
+std::atomic<bool> Profiler::tracing{false};
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Anneau d'événements d'un thread; le verrou n'est disputé que pendant
+// l'export ou l'effacement
+struct ThreadTrace
+{
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    size_t next = 0;
+    uint32_t tid = 0;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ProfilePoint *> points;
+    std::vector<std::shared_ptr<ThreadTrace>> threads;
+    uint32_t nextTid = 1;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+ThreadTrace &threadTrace()
+{
+    // Gardée par le registre après la fin du thread: ses événements restent exportables
+    thread_local std::shared_ptr<ThreadTrace> trace = [] {
+        auto created = std::make_shared<ThreadTrace>();
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        created->tid = reg.nextTid++;
+        reg.threads.push_back(created);
+        return created;
+    }();
+    return *trace;
+}
+
+std::chrono::steady_clock::time_point epoch()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+void appendJsonString(std::string &out, const char *text)
+{
+    out += '"';
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            out += '\\';
+        out += *c;
+    }
+    out += '"';
+}
+
+// Microsecondes avec trois décimales
+void appendMicroseconds(std::string &out, int64_t ns)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                  static_cast<long long>(std::max<int64_t>(ns, 0) % 1000));
+    out += text;
+}
+
+} // namespace
+
+ProfilePoint::ProfilePoint(const char *name, Kind kind)
+    : label(name)
+    , pointKind(kind)
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.points.push_back(this);
+}
+
+void ProfilePoint::record(int64_t startNs, int64_t durationNs)
+{
+    const uint64_t duration = uint64_t(std::max<int64_t>(durationNs, 0));
+    calls.fetch_add(1, std::memory_order_relaxed);
+    totalNs.fetch_add(duration, std::memory_order_relaxed);
+    uint64_t previous = maxNs.load(std::memory_order_relaxed);
+    while (duration > previous && !maxNs.compare_exchange_weak(previous, duration, std::memory_order_relaxed)) {
+    }
+    if (pointKind == Traced && Profiler::isTracing())
+        Profiler::addEvent(*this, startNs, durationNs);
+}
+
+ProfilePoint::Totals ProfilePoint::totals() const
+{
+    Totals result;
+    result.calls = calls.load(std::memory_order_relaxed);
+    result.totalNs = totalNs.load(std::memory_order_relaxed);
+    result.maxNs = maxNs.load(std::memory_order_relaxed);
+    result.items = items.load(std::memory_order_relaxed);
+    return result;
+}
+
+void Profiler::setEnabled(bool on)
+{
+    epoch();
+    enabled.store(on, std::memory_order_relaxed);
+    if (!on)
+        tracing.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::setTracing(bool on)
+{
+    if (on)
+        setEnabled(true);
+    tracing.store(on, std::memory_order_relaxed);
+}
+
+int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch()).count();
+}
+
+std::vector<ProfilePoint *> Profiler::points()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.points;
+}
+
+void Profiler::addEvent(const ProfilePoint &point, int64_t startNs, int64_t durationNs)
+{
+    ThreadTrace &trace = threadTrace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    const TraceEvent event{point.name(), startNs, durationNs};
+    if (trace.events.size() < EventsPerThread) {
+        trace.events.push_back(event);
+    } else {
+        trace.events[trace.next] = event;
+        trace.next = (trace.next + 1) % EventsPerThread;
+    }
+}
+
+size_t Profiler::eventCount()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (const std::shared_ptr<ThreadTrace> &trace : reg.threads) {
+        std::lock_guard<std::mutex> traceLock(trace->mutex);
+        count += trace->events.size();
+    }
+    return count;
+}
+
+void Profiler::clearTrace()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const std::shared_ptr<ThreadTrace> &trace : reg.threads) {
+        std::lock_guard<std::mutex> traceLock(trace->mutex);
+        trace->events.clear();
+        trace->next = 0;
+    }
+}
+
+std::string Profiler::traceJson()
+{
+    // Copie sous verrou, mise en forme ensuite: les threads mesurés
+    // n'attendent que le temps de la copie
+    struct ThreadEvents
+    {
+        uint32_t tid;
+        std::vector<TraceEvent> events;
+    };
+    std::vector<ThreadEvents> threads;
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const std::shared_ptr<ThreadTrace> &trace : reg.threads) {
+            std::lock_guard<std::mutex> traceLock(trace->mutex);
+            threads.push_back({trace->tid, trace->events});
+        }
+    }
+
+    std::string json("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (ThreadEvents &thread : threads) {
+        std::sort(thread.events.begin(), thread.events.end(),
+                  [](const TraceEvent &a, const TraceEvent &b) { return a.startNs < b.startNs; });
+        for (const TraceEvent &event : thread.events) {
+            if (!first)
+                json += ",\n";
+            first = false;
+            json += "{\"name\":";
+            appendJsonString(json, event.name);
+            json += ",\"cat\":\"interfaceqt\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            json += std::to_string(thread.tid);
+            json += ",\"ts\":";
+            appendMicroseconds(json, event.startNs);
+            json += ",\"dur\":";
+            appendMicroseconds(json, event.durationNs);
+            json += '}';
+        }
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+int64_t Profiler::residentMemory()
+{
+#if defined(__linux__)
+    long pages = 0;
+    long resident = 0;
+    FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1;
+    const int read = std::fscanf(statm, "%ld %ld", &pages, &resident);
+    std::fclose(statm);
+    return read == 2 ? int64_t(resident) * sysconf(_SC_PAGESIZE) : -1;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return int64_t(counters.WorkingSetSize);
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, task_info_t(&info), &count) != KERN_SUCCESS)
+        return -1;
+    return int64_t(info.resident_size);
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,138 @@
+// profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Instrumentation des chemins chauds. Un point de mesure est une variable
+// statique nommée, créée au premier passage; chaque passage dans une portée
+// PROFILE_SCOPE ajoute sa durée aux totaux du point (appels, temps cumulé,
+// maximum) et, si la trace est enregistrée, un événement horodaté.
+//
+// Désactivé, le coût d'une portée est une lecture atomique et un test; en
+// compilant avec INTERFACEQT_NO_PROFILING, les macros disparaissent.
+class ProfilePoint
+{
+public:
+    // AggregateOnly: totaux seulement, jamais d'événement de trace (appels
+    // trop nombreux, comme data() du modèle)
+    enum Kind { Traced, AggregateOnly };
+
+    struct Totals
+    {
+        uint64_t calls = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        uint64_t items = 0;   // éléments traités (lignes, enregistrements...)
+    };
+
+    explicit ProfilePoint(const char *name, Kind kind = Traced);
+
+    ProfilePoint(const ProfilePoint &) = delete;
+    ProfilePoint &operator=(const ProfilePoint &) = delete;
+
+    const char *name() const { return label; }
+    Kind kind() const { return pointKind; }
+
+    void record(int64_t startNs, int64_t durationNs);
+    void addItems(uint64_t count) { items.fetch_add(count, std::memory_order_relaxed); }
+    Totals totals() const;
+    // Maximum depuis le dernier appel, remis à zéro
+    uint64_t takeMax() { return maxNs.exchange(0, std::memory_order_relaxed); }
+
+private:
+    const char *label;
+    Kind pointKind;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> items{0};
+};
+
+class Profiler
+{
+public:
+    // Événements gardés par thread (les plus récents)
+    static constexpr size_t EventsPerThread = 1 << 18;
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static bool isTracing() { return tracing.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on);
+    // L'enregistrement de la trace suppose la mesure active
+    static void setTracing(bool on);
+
+    // Nanosecondes depuis le démarrage du profileur (horloge monotone)
+    static int64_t now();
+
+    static std::vector<ProfilePoint *> points();
+    static void addEvent(const ProfilePoint &point, int64_t startNs, int64_t durationNs);
+    static size_t eventCount();
+    static void clearTrace();
+    // Trace au format Chrome (chrome://tracing, Perfetto): événements "X"
+    static std::string traceJson();
+
+    // Mémoire résidente du processus, -1 si inconnue
+    static int64_t residentMemory();
+
+private:
+    static std::atomic<bool> enabled;
+    static std::atomic<bool> tracing;
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(ProfilePoint &point)
+        : point(Profiler::isEnabled() ? &point : nullptr)
+        , start(this->point ? Profiler::now() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (point)
+            point->record(start, Profiler::now() - start);
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+    void addItems(uint64_t count)
+    {
+        if (point)
+            point->addItems(count);
+    }
+
+private:
+    ProfilePoint *point;
+    int64_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifndef INTERFACEQT_NO_PROFILING
+// Mesure la portée courante. PROFILE_SCOPE_AS nomme la variable pour compter
+// les lignes traitées (variable.addItems(n)); PROFILE_AGGREGATE ne produit
+// jamais d'événement de trace.
+#define PROFILE_SCOPE_AS(variable, name) \
+    static ProfilePoint PROFILE_CONCAT(profilePoint_, __LINE__)(name); \
+    ProfileScope variable(PROFILE_CONCAT(profilePoint_, __LINE__))
+#define PROFILE_SCOPE(name) PROFILE_SCOPE_AS(PROFILE_CONCAT(profileScope_, __LINE__), name)
+#define PROFILE_AGGREGATE(name) \
+    static ProfilePoint PROFILE_CONCAT(profilePoint_, __LINE__)(name, ProfilePoint::AggregateOnly); \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profilePoint_, __LINE__))
+#else
+struct ProfileScopeStub
+{
+    void addItems(uint64_t) {}
+};
+#define PROFILE_SCOPE_AS(variable, name) ProfileScopeStub variable
+#define PROFILE_SCOPE(name) do {} while (false)
+#define PROFILE_AGGREGATE(name) do {} while (false)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,240 @@
+// rowbitmap.cpp
+#include "rowbitmap.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t WordCount = 65536 / 64;
+
+} // namespace
+
+bool RowBitmap::Container::contains(uint16_t low) const
+{
+    if (isDense())
+        return bits[low >> 6] >> (low & 63) & 1;
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+RowBitmap::Container *RowBitmap::findContainer(uint16_t key)
+{
+    // Cas courant: ajout en fin de tableau
+    if (!containers.empty() && containers.back().key == key)
+        return &containers.back();
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container &c, uint16_t k) { return c.key < k; });
+    return it != containers.end() && it->key == key ? &*it : nullptr;
+}
+
+const RowBitmap::Container *RowBitmap::findContainer(uint16_t key) const
+{
+    return const_cast<RowBitmap *>(this)->findContainer(key);
+}
+
+void RowBitmap::toDense(Container &container)
+{
+    container.bits.assign(WordCount, 0);
+    for (uint16_t low : container.array)
+        container.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    std::vector<uint16_t>().swap(container.array);
+}
+
+void RowBitmap::toSparse(Container &container)
+{
+    container.array.clear();
+    container.array.reserve(container.cardinality);
+    for (size_t w = 0; w < WordCount; ++w) {
+        for (uint64_t word = container.bits[w]; word; word &= word - 1)
+            container.array.push_back(uint16_t(w * 64 + size_t(__builtin_ctzll(word))));
+    }
+    std::vector<uint64_t>().swap(container.bits);
+}
+
+void RowBitmap::add(uint32_t row)
+{
+    const uint16_t key = uint16_t(row >> 16);
+    const uint16_t low = uint16_t(row);
+    Container *container = findContainer(key);
+    if (!container) {
+        auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                                   [](const Container &c, uint16_t k) { return c.key < k; });
+        it = containers.insert(it, Container());
+        it->key = key;
+        container = &*it;
+    }
+
+    if (container->isDense()) {
+        uint64_t &word = container->bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if (word & mask)
+            return;
+        word |= mask;
+    } else {
+        std::vector<uint16_t> &array = container->array;
+        if (array.empty() || array.back() < low) {
+            array.push_back(low);
+        } else {
+            auto it = std::lower_bound(array.begin(), array.end(), low);
+            if (*it == low)
+                return;
+            array.insert(it, low);
+        }
+        if (array.size() > ArrayLimit)
+            toDense(*container);
+    }
+    ++container->cardinality;
+    ++total;
+}
+
+void RowBitmap::remove(uint32_t row)
+{
+    const uint16_t low = uint16_t(row);
+    Container *container = findContainer(uint16_t(row >> 16));
+    if (!container)
+        return;
+
+    if (container->isDense()) {
+        uint64_t &word = container->bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if (!(word & mask))
+            return;
+        word &= ~mask;
+    } else {
+        auto it = std::lower_bound(container->array.begin(), container->array.end(), low);
+        if (it == container->array.end() || *it != low)
+            return;
+        container->array.erase(it);
+    }
+    --container->cardinality;
+    --total;
+
+    if (container->cardinality == 0)
+        containers.erase(containers.begin() + (container - containers.data()));
+    else if (container->isDense() && container->cardinality <= ArrayLimit / 2)
+        toSparse(*container);
+}
+
+bool RowBitmap::contains(uint32_t row) const
+{
+    const Container *container = findContainer(uint16_t(row >> 16));
+    return container && container->contains(uint16_t(row));
+}
+
+void RowBitmap::appendBitmap(RowBitmap &&tail)
+{
+    total += tail.total;
+    if (containers.empty()) {
+        containers = std::move(tail.containers);
+    } else {
+        containers.insert(containers.end(), std::make_move_iterator(tail.containers.begin()),
+                          std::make_move_iterator(tail.containers.end()));
+    }
+    tail.clear();
+}
+
+void RowBitmap::appendTo(const Container &container, std::vector<uint32_t> &rows)
+{
+    const uint32_t high = uint32_t(container.key) << 16;
+    if (container.isDense()) {
+        for (size_t w = 0; w < WordCount; ++w) {
+            for (uint64_t word = container.bits[w]; word; word &= word - 1)
+                rows.push_back(high | uint32_t(w * 64 + size_t(__builtin_ctzll(word))));
+        }
+    } else {
+        for (uint16_t low : container.array)
+            rows.push_back(high | low);
+    }
+}
+
+std::vector<uint32_t> RowBitmap::toVector() const
+{
+    std::vector<uint32_t> rows;
+    rows.reserve(total);
+    for (const Container &container : containers)
+        appendTo(container, rows);
+    return rows;
+}
+
+std::vector<uint32_t> RowBitmap::takeFrom(uint16_t key)
+{
+    auto first = std::lower_bound(containers.begin(), containers.end(), key,
+                                  [](const Container &c, uint16_t k) { return c.key < k; });
+    std::vector<uint32_t> rows;
+    for (auto it = first; it != containers.end(); ++it) {
+        appendTo(*it, rows);
+        total -= it->cardinality;
+    }
+    containers.erase(first, containers.end());
+    return rows;
+}
+
+void RowBitmap::removeRows(const std::vector<uint32_t> &removed)
+{
+    if (removed.empty() || containers.empty())
+        return;
+    const std::vector<uint32_t> tail = takeFrom(uint16_t(removed.front() >> 16));
+    // Les deux listes sont triées: un seul parcours suffit
+    size_t shift = 0;
+    for (uint32_t row : tail) {
+        while (shift < removed.size() && removed[shift] < row)
+            ++shift;
+        if (shift < removed.size() && removed[shift] == row)
+            continue;
+        add(row - uint32_t(shift));
+    }
+}
+
+void RowBitmap::insertRows(const std::vector<uint32_t> &inserted)
+{
+    if (inserted.empty() || containers.empty())
+        return;
+    const std::vector<uint32_t> tail = takeFrom(uint16_t(inserted.front() >> 16));
+    // inserted[k] - k: ligne d'origine devant laquelle arrive l'insertion k
+    size_t shift = 0;
+    for (uint32_t row : tail) {
+        while (shift < inserted.size() && inserted[shift] - uint32_t(shift) <= row)
+            ++shift;
+        add(row + uint32_t(shift));
+    }
+}
+
+void RowBitmap::intersect(const uint32_t *rows, size_t count, std::vector<uint32_t> &out) const
+{
+    // Les deux côtés sont triés: on avance tranche par tranche
+    auto container = containers.begin();
+    for (size_t i = 0; i < count && container != containers.end();) {
+        const uint16_t key = uint16_t(rows[i] >> 16);
+        if (container->key < key) {
+            container = std::lower_bound(container, containers.end(), key,
+                                         [](const Container &c, uint16_t k) { return c.key < k; });
+            continue;
+        }
+        // Lignes de la même tranche
+        size_t end = i;
+        while (end < count && uint16_t(rows[end] >> 16) == key)
+            ++end;
+        if (container->key == key) {
+            if (container->isDense()) {
+                for (size_t j = i; j < end; ++j) {
+                    const uint16_t low = uint16_t(rows[j]);
+                    if (container->bits[low >> 6] >> (low & 63) & 1)
+                        out.push_back(rows[j]);
+                }
+            } else {
+                std::set_intersection(rows + i, rows + end, container->array.begin(), container->array.end(),
+                                      std::back_inserter(out), [](uint32_t a, uint32_t b) {
+                                          return uint16_t(a) < uint16_t(b);
+                                      });
+            }
+        }
+        i = end;
+    }
+}
+
+size_t RowBitmap::memoryUsage() const
+{
+    size_t bytes = containers.capacity() * sizeof(Container);
+    for (const Container &container : containers)
+        bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    return bytes;
+}
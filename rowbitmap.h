@@ -0,0 +1,69 @@
+// rowbitmap.h
+#ifndef ROWBITMAP_H
+#define ROWBITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ensemble compressé de numéros de lignes, façon « roaring »: les lignes sont
+// groupées par tranches de 65536 (16 bits de poids fort), chaque tranche est
+// une liste triée de 16 bits tant qu'elle est creuse, une table de bits
+// de 8 Ko au-delà de ArrayLimit éléments.
+class RowBitmap
+{
+public:
+    static constexpr size_t ArrayLimit = 4096;
+
+    void add(uint32_t row);
+    void remove(uint32_t row);
+    bool contains(uint32_t row) const;
+    void clear() { containers.clear(); total = 0; }
+
+    size_t cardinality() const { return total; }
+    bool isEmpty() const { return total == 0; }
+
+    // Renumérotation après suppression ou insertion de lignes au milieu du
+    // tableau (mêmes conventions que rowsAfterRemoval/rowsAfterInsertion).
+    // Seules les tranches à partir de la première ligne concernée sont
+    // reconstruites. removed: lignes supprimées, triées; elles sortent de
+    // l'ensemble. inserted: positions finales des lignes insérées, triées;
+    // elles n'y entrent pas.
+    void removeRows(const std::vector<uint32_t> &removed);
+    void insertRows(const std::vector<uint32_t> &inserted);
+
+    // Ajoute les tranches de tail, qui doivent toutes suivre celles-ci
+    void appendBitmap(RowBitmap &&tail);
+
+    // Lignes présentes, dans l'ordre croissant
+    std::vector<uint32_t> toVector() const;
+    // Ajoute à out les lignes de rows (triées) présentes dans l'ensemble
+    void intersect(const uint32_t *rows, size_t count, std::vector<uint32_t> &out) const;
+
+    size_t memoryUsage() const;
+
+private:
+    struct Container
+    {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;   // forme creuse, triée
+        std::vector<uint64_t> bits;    // forme dense, 1024 mots
+
+        bool isDense() const { return !bits.empty(); }
+        bool contains(uint16_t low) const;
+    };
+
+    std::vector<Container> containers;   // triées par clé
+    size_t total = 0;
+
+    Container *findContainer(uint16_t key);
+    const Container *findContainer(uint16_t key) const;
+    static void toDense(Container &container);
+    static void toSparse(Container &container);
+    static void appendTo(const Container &container, std::vector<uint32_t> &rows);
+    // Retire les tranches de clé >= key et rend leurs lignes
+    std::vector<uint32_t> takeFrom(uint16_t key);
+};
+
+#endif // ROWBITMAP_H
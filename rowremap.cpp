@@ -0,0 +1,54 @@
+// rowremap.cpp
+#include "rowremap.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t Grain = 65536;
+
+} // namespace
+
+std::vector<uint32_t> rowsAfterRemoval(const std::vector<uint32_t> &rows, const std::vector<uint32_t> &removed)
+{
+    const size_t chunkCount = (rows.size() + Grain - 1) / Grain;
+    std::vector<std::vector<uint32_t>> parts(chunkCount);
+    parallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            std::vector<uint32_t> &part = parts[c];
+            const size_t end = std::min((c + 1) * Grain, rows.size());
+            part.reserve(end - c * Grain);
+            for (size_t i = c * Grain; i < end; ++i) {
+                const uint32_t row = rows[i];
+                auto it = std::lower_bound(removed.begin(), removed.end(), row);
+                if (it != removed.end() && *it == row)
+                    continue;
+                part.push_back(row - uint32_t(it - removed.begin()));
+            }
+        }
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(rows.size());
+    for (const auto &part : parts)
+        result.insert(result.end(), part.begin(), part.end());
+    return result;
+}
+
+std::vector<uint32_t> rowsAfterInsertion(const std::vector<uint32_t> &rows, const std::vector<uint32_t> &inserted)
+{
+    // Position d'origine devant laquelle arrive chaque ligne insérée
+    std::vector<uint32_t> before(inserted.size());
+    for (size_t k = 0; k < inserted.size(); ++k)
+        before[k] = inserted[k] - uint32_t(k);
+
+    std::vector<uint32_t> result(rows.size());
+    parallelFor(rows.size(), Grain, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const uint32_t row = rows[i];
+            result[i] = row + uint32_t(std::upper_bound(before.begin(), before.end(), row) - before.begin());
+        }
+    });
+    return result;
+}
@@ -0,0 +1,18 @@
+// rowremap.h
+#ifndef ROWREMAP_H
+#define ROWREMAP_H
+
+#include <cstdint>
+#include <vector>
+
+// Renumérotation de listes de lignes (résultats de filtre, permutations...)
+// après suppression ou insertion de lignes au milieu du tableau. L'ordre de
+// la liste est conservé; elle n'a pas besoin d'être triée.
+
+// removed: lignes supprimées (triées); elles disparaissent de la liste
+std::vector<uint32_t> rowsAfterRemoval(const std::vector<uint32_t> &rows, const std::vector<uint32_t> &removed);
+
+// inserted: positions finales des lignes insérées (triées)
+std::vector<uint32_t> rowsAfterInsertion(const std::vector<uint32_t> &rows, const std::vector<uint32_t> &inserted);
+
+#endif // ROWREMAP_H
@@ -0,0 +1,117 @@
+// searchcontroller.cpp
+#include "searchcontroller.h"
+#include "parallel.h"
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+#include <algorithm>
+#include <chrono>
+
+SearchController::SearchController(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SearchController::~SearchController()
+{
+    // Les tâches en cours rappellent ce contrôleur: on attend leur fin
+    cancel();
+    for (std::future<void> &job : jobs)
+        job.wait();
+}
+
+void SearchController::track(std::future<void> job)
+{
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const std::future<void> &pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), jobs.end());
+    jobs.push_back(std::move(job));
+}
+
+void SearchController::rebuildIndex(ColumnTablePtr table)
+{
+    const quint64 requested = ++indexGeneration;
+    track(runAsync([this, table, requested]() {
+        QElapsedTimer timer;
+        timer.start();
+        auto built = std::make_shared<TrigramIndex>();
+        built->build(table->nomValues);
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, built, requested, elapsed]() {
+            if (requested != indexGeneration)
+                return;
+            index = built;
+            emit indexReady(qint64(built->coveredCount()), elapsed);
+        }, Qt::QueuedConnection);
+    }, TaskPriority::Bulk));
+}
+
+void SearchController::invalidateIndex()
+{
+    ++indexGeneration;
+    index.reset();
+}
+
+void SearchController::search(const QString &text, ColumnTablePtr table, quint64 dataVersion)
+{
+    const bool previousComplete = lastComplete;
+    cancel();
+
+    const std::string query = text.toUtf8().toStdString();
+    std::string folded;
+    foldCase(query, folded);
+
+    // Affinage: la nouvelle requête contient l'ancienne, ses résultats sont
+    // un sous-ensemble des précédents
+    std::shared_ptr<const std::vector<uint32_t>> candidates;
+    if (previousComplete && dataVersion == lastVersion && !lastQuery.empty()
+        && folded.find(lastQuery) != std::string::npos) {
+        candidates = std::make_shared<const std::vector<uint32_t>>(std::move(results));
+    }
+    results.clear();
+    lastQuery = folded;
+    lastVersion = dataVersion;
+    lastComplete = false;
+    running = true;
+
+    const quint64 current = ++generation;
+    cancelToken = std::make_shared<std::atomic<bool>>(false);
+    auto token = cancelToken;
+    auto currentIndex = index;
+
+    track(runAsync([this, table, query, candidates, token, currentIndex, current]() {
+        QElapsedTimer timer;
+        timer.start();
+        const size_t count = SearchEngine::search(*table, currentIndex.get(), query, candidates.get(), *token,
+            [this, current](std::vector<uint32_t> &&rows) {
+                auto batch = std::make_shared<std::vector<uint32_t>>(std::move(rows));
+                QMetaObject::invokeMethod(this, [this, current, batch]() {
+                    if (current != generation)
+                        return;
+                    const int first = int(results.size());
+                    results.insert(results.end(), batch->begin(), batch->end());
+                    emit matchesAdded(first, int(batch->size()));
+                }, Qt::QueuedConnection);
+            });
+        const bool completed = !token->load();
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, current, completed, count, elapsed]() {
+            if (current != generation)
+                return;
+            running = false;
+            lastComplete = completed;
+            if (completed)
+                emit searchFinished(qint64(count), elapsed);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void SearchController::cancel()
+{
+    if (cancelToken)
+        cancelToken->store(true);
+    ++generation;
+    running = false;
+    lastComplete = false;
+}
@@ -0,0 +1,60 @@
+// searchcontroller.h
+#ifndef SEARCHCONTROLLER_H
+#define SEARCHCONTROLLER_H
+
+#include "searchengine.h"
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Pilote le moteur de recherche depuis le thread graphique: construction de
+// l'index en arrière-plan, exécution des requêtes sur la réserve de threads
+// et remise des correspondances par lots. Une requête qui prolonge la
+// précédente n'examine que les lignes déjà trouvées.
+class SearchController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchController(QObject *parent = nullptr);
+    ~SearchController() override;
+
+    void rebuildIndex(ColumnTablePtr table);
+    // Index périmé (codes Nom renumérotés): les recherches s'en passent
+    // jusqu'au prochain rebuildIndex
+    void invalidateIndex();
+    std::shared_ptr<const TrigramIndex> nomIndex() const { return index; }
+    void search(const QString &text, ColumnTablePtr table, quint64 dataVersion);
+    void cancel();
+
+    // Lignes trouvées, dans l'ordre croissant
+    const std::vector<uint32_t> &matches() const { return results; }
+    bool isRunning() const { return running; }
+
+signals:
+    void matchesAdded(int first, int count);
+    void searchFinished(qint64 matchCount, qint64 elapsedMs);
+    void indexReady(qint64 valueCount, qint64 elapsedMs);
+
+private:
+    std::shared_ptr<const TrigramIndex> index;
+    std::shared_ptr<std::atomic<bool>> cancelToken;
+    std::vector<std::future<void>> jobs;
+    quint64 generation = 0;
+    quint64 indexGeneration = 0;
+    bool running = false;
+
+    std::vector<uint32_t> results;
+    std::string lastQuery;
+    quint64 lastVersion = 0;
+    bool lastComplete = false;
+
+    void track(std::future<void> job);
+};
+
+#endif // SEARCHCONTROLLER_H
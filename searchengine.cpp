@@ -0,0 +1,292 @@
+// searchengine.cpp
+#include "searchengine.h"
+#include "parallel.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+
+namespace {
+
+inline uint32_t trigramKey(const char *p)
+{
+    return uint32_t(uint8_t(p[0])) << 16 | uint32_t(uint8_t(p[1])) << 8 | uint8_t(p[2]);
+}
+
+// Trigrammes distincts d'un texte déjà normalisé, ajoutés à keys
+void collectTrigrams(std::string_view folded, std::vector<uint32_t> &keys)
+{
+    for (size_t i = 0; i + 3 <= folded.size(); ++i)
+        keys.push_back(trigramKey(folded.data() + i));
+}
+
+bool onlyChars(std::string_view text, std::string_view allowed)
+{
+    return !text.empty() && text.find_first_not_of(allowed) == std::string_view::npos;
+}
+
+// Correspondances sur les valeurs d'un dictionnaire: flags[code] = 1
+std::vector<uint8_t> matchValues(const StringColumn &values, const TrigramIndex *index,
+                                 const std::string &folded, const std::atomic<bool> &cancelled)
+{
+    const size_t count = values.size();
+    std::vector<uint8_t> flags(count, 0);
+
+    // Plages de codes à vérifier: granules candidats de l'index, puis les
+    // valeurs ajoutées après sa construction
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t indexed = 0;
+    if (index && folded.size() >= 3) {
+        indexed = std::min(index->coveredCount(), count);
+        for (uint32_t granule : index->candidateGranules(folded)) {
+            const size_t begin = size_t(granule) << TrigramIndex::GranuleShift;
+            ranges.emplace_back(begin, std::min(begin + TrigramIndex::GranuleSize, indexed));
+        }
+    }
+    for (size_t begin = indexed; begin < count; begin += TrigramIndex::GranuleSize)
+        ranges.emplace_back(begin, std::min(begin + TrigramIndex::GranuleSize, count));
+
+    parallelFor(ranges.size(), 8, [&](size_t first, size_t last) {
+        std::string buffer;
+        for (size_t r = first; r < last && !cancelled.load(std::memory_order_relaxed); ++r) {
+            for (size_t code = ranges[r].first; code < ranges[r].second; ++code) {
+                foldCase(values[code], buffer);
+                if (buffer.find(folded) != std::string::npos)
+                    flags[code] = 1;
+            }
+        }
+    });
+    return flags;
+}
+
+struct RowMatcher
+{
+    const ColumnTable &table;
+    const std::string &folded;
+    std::vector<uint8_t> nomFlags;
+    std::vector<uint8_t> typeFlags;
+    std::vector<uint8_t> statutFlags;
+    bool idSearch = false;
+    bool dateSearch = false;
+    bool valeurSearch = false;
+
+    bool anyPossible() const
+    {
+        auto any = [](const std::vector<uint8_t> &flags) {
+            return std::find(flags.begin(), flags.end(), 1) != flags.end();
+        };
+        return idSearch || dateSearch || valeurSearch
+            || any(nomFlags) || any(typeFlags) || any(statutFlags);
+    }
+
+    bool contains(const char *begin, const char *end) const
+    {
+        return std::string_view(begin, size_t(end - begin)).find(folded) != std::string_view::npos;
+    }
+
+    bool matches(size_t row) const
+    {
+        if (nomFlags[table.noms[row]] || typeFlags[table.types[row]] || statutFlags[table.statuts[row]])
+            return true;
+        char buffer[64];
+        if (idSearch) {
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), table.ids[row]);
+            if (contains(buffer, result.ptr))
+                return true;
+        }
+        if (dateSearch) {
+            formatDate(table.dates[row], buffer);
+            if (contains(buffer, buffer + 10))
+                return true;
+        }
+        if (valeurSearch) {
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), table.valeurs[row],
+                                              std::chars_format::fixed, 2);
+            if (result.ec == std::errc() && contains(buffer, result.ptr))
+                return true;
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+void foldCase(std::string_view text, std::string &out)
+{
+    const size_t n = text.size();
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<unsigned char>(c + 32);
+        } else if (c == 0xC3 && i + 1 < n) {
+            // Lettres majuscules Latin-1 (À..Þ sauf ×) codées C3 80..C3 9E
+            unsigned char next = static_cast<unsigned char>(text[i + 1]);
+            if (next >= 0x80 && next <= 0x9E && next != 0x97)
+                next = static_cast<unsigned char>(next + 0x20);
+            out[i] = char(c);
+            out[i + 1] = char(next);
+            ++i;
+            continue;
+        }
+        out[i] = char(c);
+    }
+}
+
+void TrigramIndex::build(const StringColumn &values)
+{
+    PROFILE_SCOPE("Index trigrammes");
+    const size_t count = values.size();
+    const size_t granuleCount = (count + GranuleSize - 1) >> GranuleShift;
+
+    // Trigrammes distincts de chaque granule, en parallèle
+    std::vector<std::vector<uint32_t>> perGranule(granuleCount);
+    parallelFor(granuleCount, 4, [&](size_t first, size_t last) {
+        std::string buffer;
+        for (size_t g = first; g < last; ++g) {
+            std::vector<uint32_t> &keys = perGranule[g];
+            const size_t end = std::min((g + 1) << GranuleShift, count);
+            for (size_t code = g << GranuleShift; code < end; ++code) {
+                foldCase(values[code], buffer);
+                collectTrigrams(buffer, keys);
+            }
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        }
+    });
+
+    // Regroupement par octet de poids fort puis tri de chaque seau en parallèle
+    constexpr size_t BucketCount = 256;
+    std::vector<size_t> bucketStart(BucketCount + 1, 0);
+    for (const auto &keys : perGranule) {
+        for (uint32_t key : keys)
+            ++bucketStart[(key >> 16) + 1];
+    }
+    for (size_t b = 0; b < BucketCount; ++b)
+        bucketStart[b + 1] += bucketStart[b];
+
+    std::vector<uint64_t> pairs(bucketStart[BucketCount]);
+    std::vector<size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t g = 0; g < granuleCount; ++g) {
+        for (uint32_t key : perGranule[g])
+            pairs[fill[key >> 16]++] = uint64_t(key) << 32 | g;
+        std::vector<uint32_t>().swap(perGranule[g]);
+    }
+    parallelFor(BucketCount, 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b)
+            std::sort(pairs.begin() + std::ptrdiff_t(bucketStart[b]), pairs.begin() + std::ptrdiff_t(bucketStart[b + 1]));
+    });
+
+    keys.clear();
+    offsets.clear();
+    postings.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        const uint32_t key = uint32_t(pairs[i] >> 32);
+        if (keys.empty() || keys.back() != key) {
+            keys.push_back(key);
+            offsets.push_back(uint32_t(i));
+        }
+        postings[i] = uint32_t(pairs[i]);
+    }
+    offsets.push_back(uint32_t(postings.size()));
+    keys.shrink_to_fit();
+    offsets.shrink_to_fit();
+    covered = count;
+}
+
+std::vector<uint32_t> TrigramIndex::candidateGranules(std::string_view foldedQuery) const
+{
+    std::vector<uint32_t> queryKeys;
+    collectTrigrams(foldedQuery, queryKeys);
+    std::sort(queryKeys.begin(), queryKeys.end());
+    queryKeys.erase(std::unique(queryKeys.begin(), queryKeys.end()), queryKeys.end());
+
+    // Listes des trigrammes de la requête, de la plus courte à la plus longue
+    std::vector<std::pair<const uint32_t *, const uint32_t *>> lists;
+    for (uint32_t key : queryKeys) {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        if (it == keys.end() || *it != key)
+            return {};
+        const size_t k = size_t(it - keys.begin());
+        lists.emplace_back(postings.data() + offsets[k], postings.data() + offsets[k + 1]);
+    }
+    if (lists.empty())
+        return {};
+    std::sort(lists.begin(), lists.end(), [](const auto &a, const auto &b) {
+        return a.second - a.first < b.second - b.first;
+    });
+
+    std::vector<uint32_t> result(lists.front().first, lists.front().second);
+    std::vector<uint32_t> intersection;
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        intersection.clear();
+        std::set_intersection(result.begin(), result.end(), lists[i].first, lists[i].second,
+                              std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+    return result;
+}
+
+size_t TrigramIndex::memoryUsage() const
+{
+    return (keys.capacity() + offsets.capacity() + postings.capacity()) * sizeof(uint32_t);
+}
+
+size_t SearchEngine::search(const ColumnTable &table, const TrigramIndex *nomIndex,
+                            std::string_view query, const std::vector<uint32_t> *candidates,
+                            const std::atomic<bool> &cancelled, const BatchCallback &onBatch)
+{
+    PROFILE_SCOPE_AS(scope, "Recherche");
+    std::string folded;
+    foldCase(query, folded);
+    if (folded.empty())
+        return 0;
+
+    RowMatcher matcher{table, folded, {}, {}, {}};
+    matcher.nomFlags = matchValues(table.nomValues, nomIndex, folded, cancelled);
+    matcher.typeFlags = matchValues(table.typeValues, nullptr, folded, cancelled);
+    matcher.statutFlags = matchValues(table.statutValues, nullptr, folded, cancelled);
+    matcher.idSearch = onlyChars(folded, "-0123456789");
+    matcher.dateSearch = matcher.idSearch;
+    matcher.valeurSearch = onlyChars(folded, "-.0123456789");
+    if (cancelled.load() || !matcher.anyPossible())
+        return 0;
+
+    const size_t total = candidates ? candidates->size() : table.rowCount();
+    scope.addItems(total);
+    const size_t chunkCount = (total + RowsPerBatch - 1) / RowsPerBatch;
+
+    // Remise dans l'ordre: un bloc terminé n'est transmis qu'après ses prédécesseurs
+    std::mutex orderMutex;
+    std::vector<std::vector<uint32_t>> results(chunkCount);
+    std::vector<uint8_t> ready(chunkCount, 0);
+    size_t nextToEmit = 0;
+    std::atomic<size_t> matchCount{0};
+
+    parallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            std::vector<uint32_t> rows;
+            if (!cancelled.load(std::memory_order_relaxed)) {
+                const size_t begin = chunk * RowsPerBatch;
+                const size_t end = std::min(begin + RowsPerBatch, total);
+                for (size_t i = begin; i < end; ++i) {
+                    const size_t row = candidates ? (*candidates)[i] : i;
+                    if (matcher.matches(row))
+                        rows.push_back(uint32_t(row));
+                }
+                matchCount.fetch_add(rows.size());
+            }
+
+            std::lock_guard<std::mutex> lock(orderMutex);
+            results[chunk] = std::move(rows);
+            ready[chunk] = 1;
+            while (nextToEmit < chunkCount && ready[nextToEmit]) {
+                if (!results[nextToEmit].empty() && !cancelled.load())
+                    onBatch(std::move(results[nextToEmit]));
+                ++nextToEmit;
+            }
+        }
+    });
+    return matchCount.load();
+}
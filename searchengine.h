@@ -0,0 +1,60 @@
+// searchengine.h
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include "columnstore.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minuscules ASCII et Latin-1 (É -> é...) sur du texte UTF-8
+void foldCase(std::string_view text, std::string &out);
+
+// Index de trigrammes sur les valeurs d'un dictionnaire. Pour borner la
+// mémoire, chaque trigramme renvoie vers des granules de GranuleSize valeurs
+// consécutives plutôt que vers chaque valeur: la requête ne vérifie ensuite
+// que les granules qui contiennent tous ses trigrammes.
+class TrigramIndex
+{
+public:
+    static constexpr size_t GranuleShift = 10;
+    static constexpr size_t GranuleSize = size_t(1) << GranuleShift;
+
+    void build(const StringColumn &values);
+
+    // Nombre de valeurs couvertes (les suivantes, ajoutées depuis, ne le sont pas)
+    size_t coveredCount() const { return covered; }
+
+    // Granules candidats pour une requête normalisée d'au moins 3 octets
+    std::vector<uint32_t> candidateGranules(std::string_view foldedQuery) const;
+
+    size_t memoryUsage() const;
+
+private:
+    std::vector<uint32_t> keys;       // trigrammes triés
+    std::vector<uint32_t> offsets;    // début de la liste de chaque trigramme
+    std::vector<uint32_t> postings;   // numéros de granules triés
+    size_t covered = 0;
+};
+
+// Recherche de sous-chaîne sans casse sur toutes les colonnes. Les lignes
+// sont traitées par blocs sur tous les cœurs; les correspondances sont
+// remises dans l'ordre des lignes, bloc par bloc, dès qu'elles sont prêtes.
+class SearchEngine
+{
+public:
+    using BatchCallback = std::function<void(std::vector<uint32_t> &&rows)>;
+
+    // candidates: si non nul, seules ces lignes (triées) sont examinées,
+    // ce qui permet d'affiner le résultat d'une requête précédente.
+    static size_t search(const ColumnTable &table, const TrigramIndex *nomIndex,
+                         std::string_view query, const std::vector<uint32_t> *candidates,
+                         const std::atomic<bool> &cancelled, const BatchCallback &onBatch);
+
+    static constexpr size_t RowsPerBatch = 65536;
+};
+
+#endif // SEARCHENGINE_H
@@ -0,0 +1,65 @@
+// sessionstate.cpp
+#include "sessionstate.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+QString SessionState::defaultFileName()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath("session.bin");
+}
+
+bool SessionState::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != Magic || version != Version)
+        return false;
+
+    SessionState state;
+    qint32 tab = 0;
+    qint32 level = -1;
+    qint32 budget = 0;
+    in >> state.geometry >> state.windowState >> tab >> level >> state.lastDirectory >> budget
+       >> state.theme.background >> state.theme.font >> state.theme.customFont >> state.theme.dark;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    state.currentTab = tab;
+    state.logLevel = level;
+    state.memoryBudgetMb = budget;
+    *this = state;
+    return true;
+}
+
+bool SessionState::save(const QString &fileName, QString *errorMessage) const
+{
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage)
+            *errorMessage = file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << Magic << Version;
+    out << geometry << windowState << qint32(currentTab) << qint32(logLevel) << lastDirectory
+        << qint32(memoryBudgetMb) << theme.background << theme.font << theme.customFont << theme.dark;
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        if (errorMessage)
+            *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+// sessionstate.h
+#ifndef SESSIONSTATE_H
+#define SESSIONSTATE_H
+
+#include "memorybudget.h"
+#include "theme.h"
+
+#include <QByteArray>
+#include <QString>
+
+// État de la fenêtre, de la session et du style conservé d'un lancement à
+// l'autre. Tout tient dans un seul petit fichier binaire (QDataStream) lu
+// d'un bloc au démarrage: pas d'analyse de fichier INI ni de registre.
+// Un fichier absent, tronqué ou d'une autre version laisse les valeurs
+// par défaut.
+struct SessionState
+{
+    static constexpr quint32 Magic = 0x49515353;   // "IQSS"
+    static constexpr quint16 Version = 2;
+
+    // Fenêtre: QMainWindow::saveGeometry() et saveState() (barres et panneaux)
+    QByteArray geometry;
+    QByteArray windowState;
+
+    // Session
+    int currentTab = 0;
+    int logLevel = -1;          // filtre du journal, -1: tous les niveaux
+    QString lastDirectory;      // dernier dossier ouvert ou enregistré
+    int memoryBudgetMb = MemoryBudget::DefaultLimitMb;   // 0: sans limite
+
+    // Style
+    ThemeSettings theme;
+
+    // Fichier de l'utilisateur (dossier de configuration de l'application)
+    static QString defaultFileName();
+
+    bool load(const QString &fileName);
+    bool save(const QString &fileName, QString *errorMessage = nullptr) const;
+};
+
+#endif // SESSIONSTATE_H
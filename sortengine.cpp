@@ -0,0 +1,365 @@
+// sortengine.cpp
+#include "sortengine.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "rowremap.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+constexpr size_t Grain = 65536;
+
+// Clés entières dont l'ordre non signé est celui des valeurs
+inline uint64_t orderedKey(int64_t value)
+{
+    return uint64_t(value) ^ (uint64_t(1) << 63);
+}
+
+inline uint32_t orderedKey(int32_t value)
+{
+    return uint32_t(value) ^ (uint32_t(1) << 31);
+}
+
+inline uint64_t orderedKey(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits >> 63 ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+// Tri par base stable et parallèle de (clé, ligne), octet par octet en
+// commençant par le poids faible. Les octets identiques pour toutes les
+// clés sont sautés.
+template <typename Key>
+bool radixSort(std::vector<Key> &keys, std::vector<uint32_t> &rows, const std::atomic<bool> &cancelled)
+{
+    const size_t n = keys.size();
+    const size_t chunkCount = std::max<size_t>(1, (n + Grain - 1) / Grain);
+    std::vector<Key> keysOut(n);
+    std::vector<uint32_t> rowsOut(n);
+    std::vector<size_t> counts(chunkCount * 256);
+
+    for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+        if (cancelled.load())
+            return false;
+        std::fill(counts.begin(), counts.end(), 0);
+        parallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                size_t *count = counts.data() + c * 256;
+                const size_t end = std::min((c + 1) * Grain, n);
+                for (size_t i = c * Grain; i < end; ++i)
+                    ++count[(keys[i] >> shift) & 0xFF];
+            }
+        });
+
+        // Position de départ de chaque (chiffre, tranche), dans cet ordre
+        bool constant = false;
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            size_t digitTotal = 0;
+            for (size_t c = 0; c < chunkCount; ++c) {
+                size_t &slot = counts[c * 256 + digit];
+                const size_t count = slot;
+                slot = offset;
+                offset += count;
+                digitTotal += count;
+            }
+            if (digitTotal == n)
+                constant = true;
+        }
+        if (constant)
+            continue;
+
+        parallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                size_t *position = counts.data() + c * 256;
+                const size_t end = std::min((c + 1) * Grain, n);
+                for (size_t i = c * Grain; i < end; ++i) {
+                    const size_t target = position[(keys[i] >> shift) & 0xFF]++;
+                    keysOut[target] = keys[i];
+                    rowsOut[target] = rows[i];
+                }
+            }
+        });
+        keys.swap(keysOut);
+        rows.swap(rowsOut);
+    }
+    return true;
+}
+
+// Rang de chaque code dans l'ordre des valeurs du dictionnaire
+std::vector<uint32_t> dictionaryRanks(const StringColumn &values)
+{
+    const size_t count = values.size();
+    std::vector<uint32_t> codes(count);
+    std::iota(codes.begin(), codes.end(), 0u);
+    auto byValue = [&values](uint32_t a, uint32_t b) { return values[a] < values[b]; };
+
+    // Tri des tranches en parallèle puis fusions deux à deux
+    const size_t chunkCount = std::max<size_t>(1, (count + Grain - 1) / Grain);
+    parallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            std::sort(codes.begin() + std::ptrdiff_t(c * Grain),
+                      codes.begin() + std::ptrdiff_t(std::min((c + 1) * Grain, count)), byValue);
+        }
+    });
+    for (size_t width = Grain; width < count; width *= 2) {
+        const size_t pairCount = (count + 2 * width - 1) / (2 * width);
+        parallelFor(pairCount, 1, [&](size_t first, size_t last) {
+            for (size_t p = first; p < last; ++p) {
+                const size_t begin = p * 2 * width;
+                const size_t middle = std::min(begin + width, count);
+                const size_t end = std::min(begin + 2 * width, count);
+                std::inplace_merge(codes.begin() + std::ptrdiff_t(begin), codes.begin() + std::ptrdiff_t(middle),
+                                   codes.begin() + std::ptrdiff_t(end), byValue);
+            }
+        });
+    }
+
+    std::vector<uint32_t> ranks(count);
+    for (size_t i = 0; i < count; ++i)
+        ranks[codes[i]] = uint32_t(i);
+    return ranks;
+}
+
+// Trie rows (dans leur ordre actuel) selon un critère, de façon stable
+bool sortByKey(const ColumnTable &table, const SortKey &key, std::vector<uint32_t> &rows,
+               const std::atomic<bool> &cancelled)
+{
+    const size_t n = rows.size();
+    auto gather = [&](auto &keys, auto keyOf) {
+        keys.resize(n);
+        parallelFor(n, Grain, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+                keys[i] = key.descending ? ~keyOf(rows[i]) : keyOf(rows[i]);
+        });
+    };
+
+    switch (key.column) {
+    case ColumnTable::Id: {
+        std::vector<uint64_t> keys;
+        gather(keys, [&](uint32_t row) { return orderedKey(table.ids[row]); });
+        return radixSort(keys, rows, cancelled);
+    }
+    case ColumnTable::Valeur: {
+        std::vector<uint64_t> keys;
+        gather(keys, [&](uint32_t row) { return orderedKey(table.valeurs[row]); });
+        return radixSort(keys, rows, cancelled);
+    }
+    case ColumnTable::Date: {
+        std::vector<uint32_t> keys;
+        gather(keys, [&](uint32_t row) { return orderedKey(table.dates[row]); });
+        return radixSort(keys, rows, cancelled);
+    }
+    default: {
+        const BlockVector<uint32_t> &codes = key.column == ColumnTable::Nom ? table.noms
+                                           : key.column == ColumnTable::Type ? table.types : table.statuts;
+        const StringColumn &values = key.column == ColumnTable::Nom ? table.nomValues
+                                   : key.column == ColumnTable::Type ? table.typeValues : table.statutValues;
+        const std::vector<uint32_t> ranks = dictionaryRanks(values);
+        std::vector<uint32_t> keys;
+        gather(keys, [&](uint32_t row) { return ranks[codes[row]]; });
+        return radixSort(keys, rows, cancelled);
+    }
+    }
+}
+
+int compareRows(const ColumnTable &table, const SortKey &key, uint32_t a, uint32_t b)
+{
+    auto compare = [](const auto &x, const auto &y) { return x < y ? -1 : y < x ? 1 : 0; };
+    int result;
+    switch (key.column) {
+    case ColumnTable::Id: result = compare(table.ids[a], table.ids[b]); break;
+    case ColumnTable::Nom: result = compare(table.nom(a), table.nom(b)); break;
+    case ColumnTable::Type: result = compare(table.type(a), table.type(b)); break;
+    case ColumnTable::Date: result = compare(table.dates[a], table.dates[b]); break;
+    case ColumnTable::Statut: result = compare(table.statut(a), table.statut(b)); break;
+    default: result = compare(orderedKey(table.valeurs[a]), orderedKey(table.valeurs[b])); break;
+    }
+    return key.descending ? -result : result;
+}
+
+} // namespace
+
+std::vector<uint32_t> SortEngine::sort(const ColumnTable &table, const SortKeys &keys,
+                                       const std::atomic<bool> &cancelled)
+{
+    PROFILE_SCOPE_AS(scope, "Tri");
+    std::vector<uint32_t> rows(table.rowCount());
+    scope.addItems(rows.size());
+    parallelFor(rows.size(), Grain, [&](size_t first, size_t last) {
+        std::iota(rows.begin() + std::ptrdiff_t(first), rows.begin() + std::ptrdiff_t(last), uint32_t(first));
+    });
+    // Tri stable par critère, du moins au plus important
+    for (auto key = keys.rbegin(); key != keys.rend(); ++key) {
+        if (!sortByKey(table, *key, rows, cancelled))
+            return {};
+    }
+    return rows;
+}
+
+bool SortEngine::lessThan(const ColumnTable &table, const SortKeys &keys, uint32_t a, uint32_t b)
+{
+    for (const SortKey &key : keys) {
+        const int result = compareRows(table, key, a, b);
+        if (result != 0)
+            return result < 0;
+    }
+    return a < b;
+}
+
+std::vector<uint32_t> SortEngine::update(const ColumnTable &table, const SortKeys &keys,
+                                         const std::vector<uint32_t> &permutation, size_t previousCount,
+                                         const std::vector<uint32_t> &moved)
+{
+    PROFILE_SCOPE("Tri incrémental");
+    // Lignes à (re)placer: les modifiées puis les nouvelles
+    std::vector<uint32_t> placed(moved);
+    std::sort(placed.begin(), placed.end());
+    placed.erase(std::unique(placed.begin(), placed.end()), placed.end());
+    const size_t movedCount = placed.size();
+    for (size_t row = previousCount; row < table.rowCount(); ++row)
+        placed.push_back(uint32_t(row));
+
+    std::vector<uint32_t> kept;
+    kept.reserve(permutation.size());
+    if (movedCount == 0) {
+        kept = permutation;
+    } else {
+        std::vector<uint8_t> isMoved(previousCount, 0);
+        for (size_t i = 0; i < movedCount; ++i)
+            isMoved[placed[i]] = 1;
+        for (uint32_t row : permutation) {
+            if (!isMoved[row])
+                kept.push_back(row);
+        }
+    }
+
+    auto less = [&](uint32_t a, uint32_t b) { return lessThan(table, keys, a, b); };
+    std::sort(placed.begin(), placed.end(), less);
+    std::vector<uint32_t> result(kept.size() + placed.size());
+    std::merge(kept.begin(), kept.end(), placed.begin(), placed.end(), result.begin(), less);
+    return result;
+}
+
+std::vector<uint32_t> SortEngine::inverse(const std::vector<uint32_t> &permutation)
+{
+    std::vector<uint32_t> positions(permutation.size());
+    parallelFor(permutation.size(), Grain, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            positions[permutation[i]] = uint32_t(i);
+    });
+    return positions;
+}
+
+std::vector<uint32_t> SortEngine::orderSubset(const std::vector<uint32_t> &rows,
+                                              const std::vector<uint32_t> &positions)
+{
+    std::vector<uint32_t> ordered(rows);
+    if (rows.size() < 4096) {
+        std::sort(ordered.begin(), ordered.end(), [&](uint32_t a, uint32_t b) {
+            return positions[a] < positions[b];
+        });
+        return ordered;
+    }
+    std::vector<uint32_t> keys(rows.size());
+    parallelFor(rows.size(), Grain, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            keys[i] = positions[rows[i]];
+    });
+    const std::atomic<bool> never{false};
+    radixSort(keys, ordered, never);
+    return ordered;
+}
+
+const SortCache::Entry *SortCache::find(const SortKeys &keys) const
+{
+    for (const Entry &entry : entries) {
+        if (entry.keys == keys)
+            return &entry;
+    }
+    return nullptr;
+}
+
+void SortCache::store(Entry entry)
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry &existing) {
+        return existing.keys == entry.keys;
+    }), entries.end());
+    if (entries.size() >= MaxEntries)
+        entries.erase(entries.begin());
+    entries.push_back(std::move(entry));
+}
+
+void SortCache::rowsChanged(const std::vector<uint32_t> &rows, const std::vector<int> &columns)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        const bool affected = std::any_of(it->keys.begin(), it->keys.end(), [&](const SortKey &key) {
+            return std::find(columns.begin(), columns.end(), key.column) != columns.end();
+        });
+        if (affected) {
+            for (uint32_t row : rows) {
+                if (row < it->rowCount)
+                    it->moved.push_back(row);
+            }
+            // Au-delà, un nouveau tri complet coûte moins cher
+            if (it->moved.size() > it->rowCount / 4) {
+                it = entries.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+}
+
+void SortCache::rowsRemoved(const std::vector<uint32_t> &rows, size_t previousCount)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        // Entrée en retard sur les ajouts: plus simple de la recalculer
+        if (it->rowCount != previousCount) {
+            it = entries.erase(it);
+            continue;
+        }
+        it->permutation = std::make_shared<std::vector<uint32_t>>(rowsAfterRemoval(*it->permutation, rows));
+        it->positions.reset();
+        it->moved = rowsAfterRemoval(it->moved, rows);
+        it->rowCount -= rows.size();
+        ++it;
+    }
+}
+
+void SortCache::rowsInserted(const std::vector<uint32_t> &positions, size_t previousCount)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->rowCount != previousCount) {
+            it = entries.erase(it);
+            continue;
+        }
+        it->permutation = std::make_shared<std::vector<uint32_t>>(rowsAfterInsertion(*it->permutation, positions));
+        it->positions.reset();
+        it->moved = rowsAfterInsertion(it->moved, positions);
+        it->moved.insert(it->moved.end(), positions.begin(), positions.end());
+        it->rowCount += positions.size();
+        if (it->moved.size() > it->rowCount / 4) {
+            it = entries.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+size_t SortCache::memoryUsage() const
+{
+    size_t bytes = 0;
+    for (const Entry &entry : entries) {
+        if (entry.permutation)
+            bytes += entry.permutation->capacity() * sizeof(uint32_t);
+        if (entry.positions)
+            bytes += entry.positions->capacity() * sizeof(uint32_t);
+        bytes += entry.moved.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
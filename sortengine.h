@@ -0,0 +1,96 @@
+// sortengine.h
+#ifndef SORTENGINE_H
+#define SORTENGINE_H
+
+#include "columnstore.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Critère de tri: colonne de ColumnTable et sens
+struct SortKey
+{
+    int column = ColumnTable::Id;
+    bool descending = false;
+
+    bool operator==(const SortKey &other) const
+    {
+        return column == other.column && descending == other.descending;
+    }
+};
+
+using SortKeys = std::vector<SortKey>;
+
+// Tri des lignes sans déplacer les données: le résultat est une permutation
+// (numéros de lignes dans l'ordre voulu). Les colonnes numériques sont
+// converties en clés entières ordonnées, les colonnes texte en rang de la
+// valeur dans le dictionnaire trié; le tri par base (radix) est parallèle
+// et stable, ce qui donne le tri multi-colonnes en traitant les critères du
+// dernier au premier.
+class SortEngine
+{
+public:
+    // Permutation stable de toutes les lignes; vide si annulé
+    static std::vector<uint32_t> sort(const ColumnTable &table, const SortKeys &keys,
+                                      const std::atomic<bool> &cancelled);
+
+    // Replace dans une permutation existante les lignes de moved (modifiées)
+    // et ajoute les lignes [previousCount, rowCount) apparues depuis
+    static std::vector<uint32_t> update(const ColumnTable &table, const SortKeys &keys,
+                                        const std::vector<uint32_t> &permutation, size_t previousCount,
+                                        const std::vector<uint32_t> &moved);
+
+    // Position de chaque ligne dans une permutation
+    static std::vector<uint32_t> inverse(const std::vector<uint32_t> &permutation);
+
+    // Lignes quelconques remises dans l'ordre d'une permutation, connue par
+    // son inverse: un tri par base sur 32 bits, sans comparer les valeurs
+    static std::vector<uint32_t> orderSubset(const std::vector<uint32_t> &rows,
+                                             const std::vector<uint32_t> &positions);
+
+    // Ordre strict entre deux lignes (à égalité, la plus petite ligne d'abord)
+    static bool lessThan(const ColumnTable &table, const SortKeys &keys, uint32_t a, uint32_t b);
+};
+
+// Permutations déjà calculées, par liste de critères. Une entrée reste
+// valable quand des lignes sont ajoutées (elle en couvre moins que le
+// tableau) ou modifiées (elles sont notées): SortEngine::update la remet à
+// jour sans tout retrier.
+class SortCache
+{
+public:
+    using RowList = std::shared_ptr<const std::vector<uint32_t>>;
+
+    struct Entry
+    {
+        SortKeys keys;
+        RowList permutation;
+        RowList positions;            // inverse, calculé à la demande
+        size_t rowCount = 0;          // lignes couvertes
+        std::vector<uint32_t> moved;  // lignes modifiées depuis le calcul
+    };
+
+    static constexpr size_t MaxEntries = 4;
+
+    // Entrée pour ces critères, nulle si absente
+    const Entry *find(const SortKeys &keys) const;
+    void store(Entry entry);
+
+    // Valeurs modifiées: les permutations concernées seront corrigées
+    void rowsChanged(const std::vector<uint32_t> &rows, const std::vector<int> &columns);
+    // Lignes supprimées ou insérées au milieu du tableau: les permutations
+    // sont renumérotées, les lignes insérées replacées au prochain tri.
+    // previousCount: nombre de lignes avant l'opération
+    void rowsRemoved(const std::vector<uint32_t> &rows, size_t previousCount);
+    void rowsInserted(const std::vector<uint32_t> &positions, size_t previousCount);
+    void clear() { entries.clear(); }
+
+    size_t memoryUsage() const;
+
+private:
+    // La plus récente en dernier
+    std::vector<Entry> entries;
+};
+
+#endif // SORTENGINE_H
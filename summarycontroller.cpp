@@ -0,0 +1,258 @@
+// summarycontroller.cpp
+#include "summarycontroller.h"
+#include "datatablemodel.h"
+#include "dataview.h"
+#include "parallel.h"
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+
+SummaryController::SummaryController(DataView *view, DataTableModel *source, QObject *parent)
+    : QObject(parent)
+    , view(view)
+    , source(source)
+    , updateDelay(new QTimer(this))
+{
+    // Regroupe les changements rapprochés (chargement par lots, frappe)
+    updateDelay->setSingleShot(true);
+    updateDelay->setInterval(100);
+    connect(updateDelay, &QTimer::timeout, this, [this]() { update(); });
+
+    DataViewModel *proxy = view->model();
+    connect(view, &DataView::viewUpdated, this, &SummaryController::scheduleUpdate);
+    connect(proxy, &QAbstractItemModel::modelReset, this, &SummaryController::scheduleUpdate);
+    connect(proxy, &QAbstractItemModel::rowsInserted, this, &SummaryController::scheduleUpdate);
+    connect(proxy, &QAbstractItemModel::rowsRemoved, this, &SummaryController::scheduleUpdate);
+    connect(source, &DataTableModel::valuesChanged, this, &SummaryController::onValuesChanged);
+    scheduleUpdate();
+}
+
+SummaryController::~SummaryController()
+{
+    // Les tâches en cours rappellent cet objet: on attend leur fin
+    cancelPercentiles();
+    for (std::future<void> &job : jobs)
+        job.wait();
+}
+
+const ValueSummary *SummaryController::summary() const
+{
+    return shownValid && !entries.empty() ? &entries.back().summary : nullptr;
+}
+
+void SummaryController::scheduleUpdate()
+{
+    shownValid = false;
+    if (!updateDelay->isActive())
+        updateDelay->start();
+}
+
+SummaryController::Entry *SummaryController::find(const QString &text, const QString &category,
+                                                  const DateRange &period)
+{
+    auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) {
+        return entry.text == text && entry.category == category && entry.period == period;
+    });
+    return it != entries.end() ? &*it : nullptr;
+}
+
+void SummaryController::store(Entry entry)
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry &existing) {
+        return existing.text == entry.text && existing.category == entry.category
+            && existing.period == entry.period;
+    }), entries.end());
+    entries.push_back(std::move(entry));
+    if (entries.size() > MaxEntries)
+        entries.erase(entries.begin());
+}
+
+void SummaryController::update(qint64 elapsedMs)
+{
+    // La vue publiera ses lignes (viewUpdated) une fois le calcul terminé
+    if (view->isUpdating())
+        return;
+
+    Entry *entry = find(view->textFilter(), view->category(), view->dateRange());
+    if (!entry || entry->version != source->store().version()) {
+        cancelPercentiles();
+        // Le calcul en cours rappellera update() à sa fin
+        if (!running)
+            computeTotals();
+        return;
+    }
+
+    // Déjà calculée pour cet état du filtre: elle devient la synthèse affichée
+    const auto position = entries.begin() + (entry - entries.data());
+    std::rotate(position, position + 1, entries.end());
+    const bool wasShown = shownValid;
+    shownValid = true;
+    const ValueSummary &shown = entries.back().summary;
+    if (shown.percentiles.empty() && shown.stats.count > 0)
+        computePercentiles();
+    if (!wasShown)
+        emit summaryChanged(elapsedMs);
+}
+
+void SummaryController::computeTotals()
+{
+    const DataViewModel *proxy = view->model();
+    DataViewModel::RowList rows;
+    if (proxy->isRestricted())
+        rows = proxy->rows() ? proxy->rows() : std::make_shared<const std::vector<uint32_t>>();
+    const ColumnStore &columns = source->store();
+    ColumnTablePtr table = columns.snapshot();
+    const quint64 version = columns.version();
+    const QString text = view->textFilter();
+    const QString category = view->category();
+    const DateRange period = view->dateRange();
+    running = true;
+
+    track(runAsync([this, table, rows, version, text, category, period]() {
+        QElapsedTimer timer;
+        timer.start();
+        const std::atomic<bool> never(false);
+        auto summary = std::make_shared<ValueSummary>(SummaryEngine::summarize(*table, rows.get(), never));
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, summary, version, text, category, period, elapsed]() {
+            running = false;
+            Entry entry;
+            entry.text = text;
+            entry.category = category;
+            entry.period = period;
+            entry.version = version;
+            entry.summary = std::move(*summary);
+            store(std::move(entry));
+
+            // Résultat gardé même si la vue a changé entre-temps: update()
+            // l'affiche s'il correspond encore, sinon lance le calcul suivant
+            shownValid = false;
+            update(elapsed);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void SummaryController::computePercentiles()
+{
+    if (percentilesRunning)
+        return;
+    const DataViewModel *proxy = view->model();
+    DataViewModel::RowList rows;
+    if (proxy->isRestricted())
+        rows = proxy->rows() ? proxy->rows() : std::make_shared<const std::vector<uint32_t>>();
+    const ColumnStore &columns = source->store();
+    ColumnTablePtr table = columns.snapshot();
+    const quint64 version = columns.version();
+    const QString text = view->textFilter();
+    const QString category = view->category();
+    const DateRange period = view->dateRange();
+
+    const quint64 current = ++percentileGeneration;
+    percentileToken = std::make_shared<std::atomic<bool>>(false);
+    percentilesRunning = true;
+    auto token = percentileToken;
+
+    track(runAsync([this, table, rows, version, text, category, period, token, current]() {
+        QElapsedTimer timer;
+        timer.start();
+        auto values = std::make_shared<std::vector<double>>(SummaryEngine::percentiles(*table, rows.get(), *token));
+        if (token->load())
+            return;
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, values, version, text, category, period, current, elapsed]() {
+            if (current != percentileGeneration)
+                return;
+            percentilesRunning = false;
+            Entry *entry = find(text, category, period);
+            if (!entry || entry->version != version)
+                return;
+            entry->summary.percentiles = std::move(*values);
+            if (shownValid && entry == &entries.back())
+                emit summaryChanged(elapsed);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void SummaryController::cancelPercentiles()
+{
+    if (percentileToken)
+        percentileToken->store(true);
+    ++percentileGeneration;
+    percentilesRunning = false;
+}
+
+void SummaryController::onValuesChanged(const std::vector<uint32_t> &rows, int column, const ColumnRows &previous)
+{
+    // Synthèse à jour juste avant cette modification (une seule version
+    // d'écart), sinon elle sera recalculée
+    const ColumnStore &columns = source->store();
+    if (!shownValid)
+        return;
+    // Lot du flux (toutes les colonnes): recalcul regroupé
+    if (column < 0 || entries.empty() || entries.back().version + 1 != columns.version()) {
+        scheduleUpdate();
+        return;
+    }
+    // Le filtre texte porte sur toutes les colonnes, la catégorie sur Type,
+    // la période sur Date: les lignes affichées vont changer, la vue se recomposera
+    if (!view->textFilter().isEmpty() || (column == ColumnTable::Type && !view->category().isEmpty())
+        || (column == ColumnTable::Date && view->dateRange().isValid()))
+        return;
+    if (column != ColumnTable::Valeur && column != ColumnTable::Type && column != ColumnTable::Statut) {
+        entries.back().version = columns.version();
+        return;
+    }
+
+    const ColumnTable &table = columns.table();
+    const DataViewModel *proxy = view->model();
+    ValueSummary summary = entries.back().summary;
+    ValueStats &stats = summary.stats;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const uint32_t row = rows[i];
+        if (proxy->isRestricted() && !proxy->mapFromSource(source->index(int(row), 0)).isValid())
+            continue;
+        const double value = table.valeurs[row];
+        if (column == ColumnTable::Valeur) {
+            const double old = previous.valeurs[i];
+            // L'ancien extrême a disparu: seul un nouveau parcours le retrouve
+            if ((old == stats.min && value > old) || (old == stats.max && value < old)) {
+                scheduleUpdate();
+                return;
+            }
+            stats.sum += value - old;
+            stats.min = std::min(stats.min, value);
+            stats.max = std::max(stats.max, value);
+            summary.byType.remove(table.types[row], old);
+            summary.byType.add(table.types[row], value);
+            summary.byStatut.remove(table.statuts[row], old);
+            summary.byStatut.add(table.statuts[row], value);
+        } else if (column == ColumnTable::Type) {
+            summary.byType.remove(previous.types[i], value);
+            summary.byType.add(table.types[row], value);
+        } else {
+            summary.byStatut.remove(previous.statuts[i], value);
+            summary.byStatut.add(table.statuts[row], value);
+        }
+    }
+
+    if (column == ColumnTable::Valeur) {
+        summary.percentiles.clear();
+        cancelPercentiles();
+    }
+    entries.back().summary = std::move(summary);
+    entries.back().version = columns.version();
+    emit summaryChanged(0);
+    update();
+}
+
+void SummaryController::track(std::future<void> job)
+{
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const std::future<void> &pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), jobs.end());
+    jobs.push_back(std::move(job));
+}
@@ -0,0 +1,79 @@
+// summarycontroller.h
+#ifndef SUMMARYCONTROLLER_H
+#define SUMMARYCONTROLLER_H
+
+#include "dateindex.h"
+#include "summaryengine.h"
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+class DataTableModel;
+class DataView;
+class QTimer;
+
+// Synthèse de la colonne Valeur sur les lignes affichées par la vue. Les
+// résultats sont gardés par état du filtre (texte, catégorie et période): changer le
+// tri ou revenir à un filtre déjà calculé ne relit pas les données. Une
+// modification de valeurs est reportée directement dans la synthèse
+// affichée quand elle ne change pas l'ensemble des lignes; seuls les
+// centiles sont alors recalculés.
+class SummaryController : public QObject
+{
+    Q_OBJECT
+
+public:
+    SummaryController(DataView *view, DataTableModel *source, QObject *parent = nullptr);
+    ~SummaryController() override;
+
+    // Synthèse des lignes affichées, nulle tant qu'elle n'est pas calculée
+    const ValueSummary *summary() const;
+    bool isRunning() const { return running; }
+
+    static constexpr size_t MaxEntries = 4;
+
+signals:
+    void summaryChanged(qint64 elapsedMs);
+
+private:
+    struct Entry
+    {
+        QString text;
+        QString category;
+        DateRange period;
+        quint64 version = 0;   // version des données couvertes
+        ValueSummary summary;
+    };
+
+    DataView *view;
+    DataTableModel *source;
+    QTimer *updateDelay;
+    // La plus récente (celle affichée si shownValid) en dernier
+    std::vector<Entry> entries;
+    bool shownValid = false;
+
+    std::vector<std::future<void>> jobs;
+    // Un seul calcul des totaux à la fois; les centiles, plus longs, sont
+    // abandonnés dès que la vue change
+    bool running = false;
+    std::shared_ptr<std::atomic<bool>> percentileToken;
+    quint64 percentileGeneration = 0;
+    bool percentilesRunning = false;
+
+    void scheduleUpdate();
+    void update(qint64 elapsedMs = 0);
+    void computeTotals();
+    void computePercentiles();
+    void onValuesChanged(const std::vector<uint32_t> &rows, int column, const ColumnRows &previous);
+    Entry *find(const QString &text, const QString &category, const DateRange &period);
+    void store(Entry entry);
+    void cancelPercentiles();
+    void track(std::future<void> job);
+};
+
+#endif // SUMMARYCONTROLLER_H
@@ -0,0 +1,305 @@
+// summaryengine.cpp
+#include "summaryengine.h"
+#include "parallel.h"
+#include "profiler.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#define SUMMARYENGINE_AVX2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Le noyau AVX2 est compilé pour ce jeu d'instructions même si le reste du
+// programme ne l'est pas; il n'est appelé qu'après vérification du processeur
+#if defined(SUMMARYENGINE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#define SUMMARYENGINE_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SUMMARYENGINE_AVX2_TARGET
+#endif
+
+const double SummaryEngine::PercentileRanks[SummaryEngine::PercentileCount] = {0.25, 0.5, 0.75, 0.9, 0.99};
+
+namespace {
+
+// Tranches de la taille des blocs: sans filtre, une tranche est un bloc
+constexpr size_t Slice = BlockVector<double>::BlockSize;
+
+bool detectAvx2()
+{
+#if defined(SUMMARYENGINE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(SUMMARYENGINE_AVX2) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    // AVX activé par le système (registres sauvegardés), puis AVX2
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+ValueStats statsScalar(const double *values, size_t count)
+{
+    // Quatre accumulateurs indépendants: les additions ne s'attendent pas
+    double sums[4] = {0.0, 0.0, 0.0, 0.0};
+    double low = std::numeric_limits<double>::infinity();
+    double high = -low;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            const double value = values[i + lane];
+            sums[lane] += value;
+            low = value < low ? value : low;
+            high = value > high ? value : high;
+        }
+    }
+    for (; i < count; ++i) {
+        sums[0] += values[i];
+        low = values[i] < low ? values[i] : low;
+        high = values[i] > high ? values[i] : high;
+    }
+    ValueStats result;
+    result.count = count;
+    result.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    result.min = low;
+    result.max = high;
+    return result;
+}
+
+#ifdef SUMMARYENGINE_AVX2
+SUMMARYENGINE_AVX2_TARGET ValueStats statsAvx2(const double *values, size_t count)
+{
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    __m256d low = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d high = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256d a = _mm256_loadu_pd(values + i);
+        const __m256d b = _mm256_loadu_pd(values + i + 4);
+        sum0 = _mm256_add_pd(sum0, a);
+        sum1 = _mm256_add_pd(sum1, b);
+        low = _mm256_min_pd(low, _mm256_min_pd(a, b));
+        high = _mm256_max_pd(high, _mm256_max_pd(a, b));
+    }
+
+    alignas(32) double sums[4];
+    alignas(32) double lows[4];
+    alignas(32) double highs[4];
+    _mm256_store_pd(sums, _mm256_add_pd(sum0, sum1));
+    _mm256_store_pd(lows, low);
+    _mm256_store_pd(highs, high);
+
+    ValueStats result = statsScalar(values + i, count - i);
+    result.count = count;
+    result.sum += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    for (size_t lane = 0; lane < 4; ++lane) {
+        result.min = std::min(result.min, lows[lane]);
+        result.max = std::max(result.max, highs[lane]);
+    }
+    return result;
+}
+#endif
+
+void accumulate(GroupTotals &totals, const uint32_t *codes, const double *values, size_t count)
+{
+    uint64_t *counts = totals.counts.data();
+    double *sums = totals.sums.data();
+    for (size_t i = 0; i < count; ++i) {
+        ++counts[codes[i]];
+        sums[codes[i]] += values[i];
+    }
+}
+
+struct Partial
+{
+    ValueStats stats;
+    GroupTotals byType;
+    GroupTotals byStatut;
+};
+
+} // namespace
+
+void ValueStats::merge(const ValueStats &other)
+{
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void GroupTotals::add(uint32_t code, double value)
+{
+    if (code >= counts.size()) {
+        counts.resize(size_t(code) + 1, 0);
+        sums.resize(size_t(code) + 1, 0.0);
+    }
+    ++counts[code];
+    sums[code] += value;
+}
+
+void GroupTotals::remove(uint32_t code, double value)
+{
+    if (code >= counts.size() || counts[code] == 0)
+        return;
+    --counts[code];
+    sums[code] = counts[code] > 0 ? sums[code] - value : 0.0;
+}
+
+void GroupTotals::merge(const GroupTotals &other)
+{
+    if (other.counts.size() > counts.size()) {
+        counts.resize(other.counts.size(), 0);
+        sums.resize(other.sums.size(), 0.0);
+    }
+    for (size_t code = 0; code < other.counts.size(); ++code) {
+        counts[code] += other.counts[code];
+        sums[code] += other.sums[code];
+    }
+}
+
+bool SummaryEngine::usesAvx2()
+{
+    static const bool supported = detectAvx2();
+    return supported;
+}
+
+ValueStats SummaryEngine::stats(const double *values, size_t count)
+{
+#ifdef SUMMARYENGINE_AVX2
+    if (usesAvx2())
+        return statsAvx2(values, count);
+#endif
+    return statsScalar(values, count);
+}
+
+ValueSummary SummaryEngine::summarize(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                                      const std::atomic<bool> &cancelled)
+{
+    PROFILE_SCOPE_AS(scope, "Synthèse");
+    const size_t total = rows ? rows->size() : table.rowCount();
+    scope.addItems(total);
+    const size_t typeCount = table.typeValues.size();
+    const size_t statutCount = table.statutValues.size();
+    const size_t sliceCount = (total + Slice - 1) / Slice;
+
+    // Un résultat partiel par groupe de tranches, pas par tranche: les
+    // totaux par groupe ont la taille des dictionnaires
+    const size_t workers = std::max<size_t>(1, ThreadPool::instance().threadCount());
+    const size_t grain = std::max<size_t>(1, (sliceCount + 2 * workers - 1) / (2 * workers));
+    std::vector<Partial> parts((sliceCount + grain - 1) / grain);
+
+    parallelFor(sliceCount, grain, [&](size_t first, size_t last) {
+        Partial &part = parts[first / grain];
+        part.byType.counts.assign(typeCount, 0);
+        part.byType.sums.assign(typeCount, 0.0);
+        part.byStatut.counts.assign(statutCount, 0);
+        part.byStatut.sums.assign(statutCount, 0.0);
+
+        std::vector<double> values;
+        std::vector<uint32_t> types;
+        std::vector<uint32_t> statuts;
+        for (size_t slice = first; slice < last; ++slice) {
+            if (cancelled.load(std::memory_order_relaxed))
+                return;
+            const size_t begin = slice * Slice;
+            const size_t count = std::min(Slice, total - begin);
+            const double *sliceValues;
+            const uint32_t *sliceTypes;
+            const uint32_t *sliceStatuts;
+            if (rows) {
+                // Lignes dispersées: regroupées dans des tampons contigus
+                values.resize(count);
+                types.resize(count);
+                statuts.resize(count);
+                const uint32_t *selected = rows->data() + begin;
+                for (size_t i = 0; i < count; ++i) {
+                    values[i] = table.valeurs[selected[i]];
+                    types[i] = table.types[selected[i]];
+                    statuts[i] = table.statuts[selected[i]];
+                }
+                sliceValues = values.data();
+                sliceTypes = types.data();
+                sliceStatuts = statuts.data();
+            } else {
+                sliceValues = table.valeurs.blockData(slice);
+                sliceTypes = table.types.blockData(slice);
+                sliceStatuts = table.statuts.blockData(slice);
+            }
+            part.stats.merge(stats(sliceValues, count));
+            accumulate(part.byType, sliceTypes, sliceValues, count);
+            accumulate(part.byStatut, sliceStatuts, sliceValues, count);
+        }
+    });
+    if (cancelled.load())
+        return ValueSummary();
+
+    ValueSummary summary;
+    summary.byType.counts.assign(typeCount, 0);
+    summary.byType.sums.assign(typeCount, 0.0);
+    summary.byStatut.counts.assign(statutCount, 0);
+    summary.byStatut.sums.assign(statutCount, 0.0);
+    for (const Partial &part : parts) {
+        summary.stats.merge(part.stats);
+        summary.byType.merge(part.byType);
+        summary.byStatut.merge(part.byStatut);
+    }
+    return summary;
+}
+
+std::vector<double> SummaryEngine::percentiles(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                                               const std::atomic<bool> &cancelled)
+{
+    PROFILE_SCOPE("Centiles");
+    const size_t total = rows ? rows->size() : table.rowCount();
+    if (total == 0)
+        return {};
+
+    std::vector<double> values(total);
+    parallelFor(total, Slice, [&](size_t begin, size_t end) {
+        if (rows) {
+            for (size_t i = begin; i < end; ++i)
+                values[i] = table.valeurs[(*rows)[i]];
+            return;
+        }
+        while (begin < end) {
+            const size_t block = begin >> BlockVector<double>::BlockShift;
+            const size_t offset = begin & BlockVector<double>::BlockMask;
+            const size_t take = std::min(end - begin, table.valeurs.blockLength(block) - offset);
+            std::copy_n(table.valeurs.blockData(block) + offset, take, values.begin() + begin);
+            begin += take;
+        }
+    });
+
+    // Rangs croissants: chaque sélection ne reprend que la partie haute
+    std::vector<double> result;
+    auto lower = values.begin();
+    for (double rank : PercentileRanks) {
+        if (cancelled.load())
+            return {};
+        const double position = rank * double(total - 1);
+        const size_t k = size_t(position);
+        const double fraction = position - double(k);
+        std::nth_element(lower, values.begin() + k, values.end());
+        lower = values.begin() + k;
+        double value = values[k];
+        if (fraction > 0.0 && k + 1 < total) {
+            const double next = *std::min_element(values.begin() + k + 1, values.end());
+            value += (next - value) * fraction;
+        }
+        result.push_back(value);
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+// summaryengine.h
+#ifndef SUMMARYENGINE_H
+#define SUMMARYENGINE_H
+
+#include "columnstore.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Nombre, somme et extrêmes d'un ensemble de valeurs
+struct ValueStats
+{
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    double mean() const { return count > 0 ? sum / double(count) : 0.0; }
+    void merge(const ValueStats &other);
+};
+
+// Nombre de lignes et somme de Valeur par code de dictionnaire (Type ou Statut)
+struct GroupTotals
+{
+    std::vector<uint64_t> counts;
+    std::vector<double> sums;
+
+    size_t size() const { return counts.size(); }
+    void add(uint32_t code, double value);
+    void remove(uint32_t code, double value);
+    void merge(const GroupTotals &other);
+};
+
+// Synthèse de la colonne Valeur sur un ensemble de lignes
+struct ValueSummary
+{
+    ValueStats stats;
+    GroupTotals byType;
+    GroupTotals byStatut;
+    // Aux rangs SummaryEngine::PercentileRanks; vide tant qu'ils ne sont pas calculés
+    std::vector<double> percentiles;
+};
+
+// Réductions sur la colonne Valeur. Les blocs de valeurs contigus passent
+// par un noyau AVX2 quand le processeur le permet (sinon scalaire, quatre
+// accumulateurs); les lignes filtrées sont d'abord regroupées dans un tampon
+// par tranche. Les tranches sont réparties sur la réserve de threads.
+class SummaryEngine
+{
+public:
+    static constexpr size_t PercentileCount = 5;
+    static const double PercentileRanks[PercentileCount];
+
+    // Noyau sur un tableau contigu
+    static ValueStats stats(const double *values, size_t count);
+
+    // rows: lignes retenues (toutes si nul). Sans les centiles, plus coûteux
+    static ValueSummary summarize(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                                  const std::atomic<bool> &cancelled);
+
+    // Centiles par interpolation linéaire; vide si annulé ou sans ligne
+    static std::vector<double> percentiles(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                                           const std::atomic<bool> &cancelled);
+
+    static bool usesAvx2();
+};
+
+#endif // SUMMARYENGINE_H
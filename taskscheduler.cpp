@@ -0,0 +1,123 @@
+// taskscheduler.cpp
+#include "taskscheduler.h"
+
+#include <QTimer>
+
+#include <algorithm>
+
+TaskScheduler::TaskScheduler(QObject *parent)
+    : QObject(parent)
+    , progressTimer(new QTimer(this))
+{
+    progressTimer->setInterval(ProgressIntervalMs);
+    connect(progressTimer, &QTimer::timeout, this, &TaskScheduler::publish);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    // Les tâches menées ailleurs sont arrêtées par leur propriétaire
+    for (Task &task : running)
+        task.context->cancel();
+    for (std::future<void> &job : jobs)
+        job.wait();
+}
+
+void TaskScheduler::track(std::future<void> job)
+{
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const std::future<void> &pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), jobs.end());
+    jobs.push_back(std::move(job));
+}
+
+quint64 TaskScheduler::add(const QString &name, const QString &unit, TaskPriority priority,
+                           TaskContextPtr context, std::function<void()> onCancel)
+{
+    Task task;
+    task.id = nextId++;
+    task.name = name;
+    task.unit = unit;
+    task.priority = priority;
+    task.context = std::move(context);
+    task.timer.start();
+    task.onCancel = std::move(onCancel);
+    running.push_back(std::move(task));
+    if (!progressTimer->isActive())
+        progressTimer->start();
+    emit tasksChanged();
+    return running.back().id;
+}
+
+quint64 TaskScheduler::run(const QString &name, const QString &unit, TaskPriority priority,
+                           std::function<void(TaskContext &)> body,
+                           std::function<void(bool cancelled)> finished)
+{
+    auto context = std::make_shared<TaskContext>();
+    const quint64 id = add(name, unit, priority, context, {});
+    track(runAsync([this, id, context, body = std::move(body), finished = std::move(finished)]() {
+        body(*context);
+        QMetaObject::invokeMethod(this, [this, id, context, finished]() {
+            finish(id);
+            if (finished)
+                finished(context->isCancelled());
+        }, Qt::QueuedConnection);
+    }, priority));
+    return id;
+}
+
+TaskContextPtr TaskScheduler::begin(const QString &name, const QString &unit, TaskPriority priority,
+                                    quint64 *id, std::function<void()> onCancel)
+{
+    auto context = std::make_shared<TaskContext>();
+    const quint64 added = add(name, unit, priority, context, std::move(onCancel));
+    if (id)
+        *id = added;
+    return context;
+}
+
+void TaskScheduler::finish(quint64 id)
+{
+    const auto it = std::find_if(running.begin(), running.end(), [id](const Task &task) { return task.id == id; });
+    if (it == running.end())
+        return;
+    running.erase(it);
+    if (running.empty())
+        progressTimer->stop();
+    emit tasksChanged();
+    publish();
+}
+
+void TaskScheduler::cancel(quint64 id)
+{
+    const auto it = std::find_if(running.begin(), running.end(), [id](const Task &task) { return task.id == id; });
+    if (it == running.end())
+        return;
+    it->context->cancel();
+    // onCancel peut terminer la tâche (finish): copié avant l'appel
+    const std::function<void()> onCancel = it->onCancel;
+    if (onCancel)
+        onCancel();
+}
+
+void TaskScheduler::cancelAll()
+{
+    std::vector<quint64> ids;
+    for (const Task &task : running)
+        ids.push_back(task.id);
+    for (quint64 id : ids)
+        cancel(id);
+}
+
+void TaskScheduler::publish()
+{
+    qint64 done = 0;
+    qint64 total = 0;
+    for (const Task &task : running) {
+        const qint64 taskTotal = task.context->total();
+        if (taskTotal <= 0)
+            continue;
+        done += std::min(task.context->done(), taskTotal);
+        total += taskTotal;
+    }
+    emit progressChanged(total > 0 ? int(done * 100 / total) : -1);
+}
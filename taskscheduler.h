@@ -0,0 +1,107 @@
+// taskscheduler.h
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include "parallel.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+class QTimer;
+
+// Avancement et annulation d'une tâche, partagés entre le code qui la fait
+// (n'importe quel thread) et le planificateur. L'annulation est coopérative:
+// la tâche consulte isCancelled() entre deux étapes.
+class TaskContext
+{
+public:
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+    // total 0: avancement inconnu
+    void setTotal(qint64 total) { totalCount.store(total, std::memory_order_relaxed); }
+    void setDone(qint64 done) { doneCount.store(done, std::memory_order_relaxed); }
+    void advance(qint64 count) { doneCount.fetch_add(count, std::memory_order_relaxed); }
+
+    qint64 total() const { return totalCount.load(std::memory_order_relaxed); }
+    qint64 done() const { return doneCount.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> doneCount{0};
+    std::atomic<qint64> totalCount{0};
+    std::atomic<bool> cancelled{false};
+};
+
+using TaskContextPtr = std::shared_ptr<TaskContext>;
+
+// Registre des opérations longues (sauvegarde, export, chargement...). Les
+// tâches lancées par run() s'exécutent dans la réserve de threads avec leur
+// priorité; celles menées ailleurs (thread dédié) s'y déclarent par begin()
+// et finish(). L'avancement n'est pas poussé par les tâches: il est relevé
+// toutes les ProgressIntervalMs tant qu'une tâche est en cours, et agrégé
+// (somme des unités faites sur somme des totaux connus).
+class TaskScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Task
+    {
+        quint64 id = 0;
+        QString name;
+        QString unit;   // unité de done/total, pour le débit ("lignes", "blocs"...)
+        TaskPriority priority = TaskPriority::Bulk;
+        TaskContextPtr context;
+        QElapsedTimer timer;
+        std::function<void()> onCancel;
+    };
+
+    static constexpr int ProgressIntervalMs = 100;
+
+    explicit TaskScheduler(QObject *parent = nullptr);
+    // Signale l'annulation aux tâches en cours et attend celles de la réserve
+    ~TaskScheduler() override;
+
+    // Exécute body dans la réserve; finished(cancelled) est appelé ensuite
+    // sur le thread graphique
+    quint64 run(const QString &name, const QString &unit, TaskPriority priority,
+                std::function<void(TaskContext &)> body,
+                std::function<void(bool cancelled)> finished = {});
+
+    // Tâche menée hors de la réserve: l'appelant rend compte par le contexte
+    // et la termine par finish(); onCancel relaie une demande d'annulation
+    TaskContextPtr begin(const QString &name, const QString &unit, TaskPriority priority,
+                         quint64 *id, std::function<void()> onCancel = {});
+    void finish(quint64 id);
+
+    void cancel(quint64 id);
+    void cancelAll();
+
+    const std::vector<Task> &tasks() const { return running; }
+    bool isBusy() const { return !running.empty(); }
+
+signals:
+    void tasksChanged();
+    // Avancement agrégé en pourcentage, -1 quand aucune tâche n'a de total
+    void progressChanged(int percent);
+
+private:
+    std::vector<Task> running;
+    QTimer *progressTimer;
+    quint64 nextId = 1;
+    std::vector<std::future<void>> jobs;
+
+    quint64 add(const QString &name, const QString &unit, TaskPriority priority,
+                TaskContextPtr context, std::function<void()> onCancel);
+    void track(std::future<void> job);
+    void publish();
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,119 @@
+// theme.cpp
+#include "theme.h"
+
+#include <QApplication>
+#include <QFontMetrics>
+#include <QStyle>
+#include <QTimer>
+
+ThemeManager::ThemeManager(QObject *parent)
+    : QObject(parent)
+    , lightPalette(QApplication::style()->standardPalette())
+    , defaultFont(QApplication::font())
+    , fontTimer(new QTimer(this))
+{
+    current.font = defaultFont;
+    fontTimer->setSingleShot(true);
+    fontTimer->setInterval(FontDelayMs);
+    connect(fontTimer, &QTimer::timeout, this, &ThemeManager::applyFont);
+}
+
+const QPalette &ThemeManager::darkPalette()
+{
+    static const QPalette palette = [] {
+        QPalette dark;
+        dark.setColor(QPalette::Window, QColor(53, 53, 53));
+        dark.setColor(QPalette::WindowText, Qt::white);
+        dark.setColor(QPalette::Base, QColor(25, 25, 25));
+        dark.setColor(QPalette::AlternateBase, QColor(53, 53, 53));
+        dark.setColor(QPalette::ToolTipBase, Qt::white);
+        dark.setColor(QPalette::ToolTipText, Qt::white);
+        dark.setColor(QPalette::Text, Qt::white);
+        dark.setColor(QPalette::Button, QColor(53, 53, 53));
+        dark.setColor(QPalette::ButtonText, Qt::white);
+        dark.setColor(QPalette::BrightText, Qt::red);
+        dark.setColor(QPalette::Link, QColor(42, 130, 218));
+        dark.setColor(QPalette::Highlight, QColor(42, 130, 218));
+        dark.setColor(QPalette::HighlightedText, Qt::black);
+        return dark;
+    }();
+    return palette;
+}
+
+void ThemeManager::apply(const ThemeSettings &settings)
+{
+    const bool paletteDiffers = settings.dark != current.dark || settings.background != current.background;
+    const bool fontDiffers = settings.customFont != current.customFont
+                          || (settings.customFont && settings.font != current.font);
+    current.dark = settings.dark;
+    current.background = settings.background;
+    current.customFont = settings.customFont;
+    current.font = settings.customFont ? settings.font : defaultFont;
+    if (paletteDiffers)
+        applyPalette();
+    if (fontDiffers) {
+        fontTimer->stop();
+        applyFont();
+    }
+}
+
+void ThemeManager::setDark(bool dark)
+{
+    if (dark == current.dark)
+        return;
+    current.dark = dark;
+    applyPalette();
+}
+
+void ThemeManager::setBackground(const QColor &color)
+{
+    if (color == current.background)
+        return;
+    current.background = color;
+    applyPalette();
+}
+
+void ThemeManager::setFont(const QFont &font)
+{
+    current.font = font;
+    current.customFont = true;
+    // Premier changement de l'image: l'application suit au plus tard une image après
+    if (!fontTimer->isActive())
+        fontTimer->start();
+}
+
+void ThemeManager::resetFont()
+{
+    current.font = defaultFont;
+    current.customFont = false;
+    if (!fontTimer->isActive())
+        fontTimer->start();
+}
+
+int ThemeManager::rowHeight() const
+{
+    const QString key = current.font.key();
+    auto cached = rowHeights.constFind(key);
+    if (cached != rowHeights.constEnd())
+        return *cached;
+    const int height = QFontMetrics(current.font).height() + 6;
+    rowHeights.insert(key, height);
+    return height;
+}
+
+void ThemeManager::applyPalette()
+{
+    QPalette palette = current.dark ? darkPalette() : lightPalette;
+    if (current.background.isValid())
+        palette.setColor(QPalette::Window, current.background);
+    QApplication::setPalette(palette);
+    emit paletteChanged();
+}
+
+void ThemeManager::applyFont()
+{
+    if (QApplication::font() == current.font)
+        return;
+    QApplication::setFont(current.font);
+    emit fontChanged(current.font);
+}
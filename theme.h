@@ -0,0 +1,67 @@
+// theme.h
+#ifndef THEME_H
+#define THEME_H
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QObject>
+#include <QPalette>
+
+class QTimer;
+
+// Choix de style de l'utilisateur
+struct ThemeSettings
+{
+    bool dark = false;
+    QColor background;          // invalide: couleur de fond de la palette
+    QFont font;
+    bool customFont = false;    // faux: police par défaut de l'application
+};
+
+// Application du style sans feuille de style. Les couleurs passent par la
+// palette de l'application: un changement ne fait que repeindre les widgets
+// visibles, sans recalcul du style de chaque enfant comme setStyleSheet().
+// Les changements de police rapprochés (aperçu dans le dialogue) sont
+// regroupés et appliqués au plus une fois par image, et les mesures qui en
+// dépendent (hauteur de ligne des tables) sont gardées par police.
+class ThemeManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FontDelayMs = 16;
+
+    explicit ThemeManager(QObject *parent = nullptr);
+
+    const ThemeSettings &settings() const { return current; }
+
+    // Applique tout immédiatement (restauration de la session)
+    void apply(const ThemeSettings &settings);
+    void setDark(bool dark);
+    void setBackground(const QColor &color);
+    // Police appliquée à l'image suivante; les demandes d'ici là sont fusionnées
+    void setFont(const QFont &font);
+    void resetFont();
+
+    // Hauteur de ligne fixe des tables pour la police courante
+    int rowHeight() const;
+
+    static const QPalette &darkPalette();
+
+signals:
+    void paletteChanged();
+    void fontChanged(const QFont &font);
+
+private:
+    ThemeSettings current;
+    QPalette lightPalette;
+    QFont defaultFont;
+    QTimer *fontTimer;
+    mutable QHash<QString, int> rowHeights;   // par QFont::key()
+
+    void applyPalette();
+    void applyFont();
+};
+
+#endif // THEME_H
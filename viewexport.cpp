@@ -0,0 +1,298 @@
+// viewexport.cpp
+#include "viewexport.h"
+#include "parallel.h"
+#include "profiler.h"
+
+#include <QSaveFile>
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+void setError(QString *errorMessage, const QString &message)
+{
+    if (errorMessage)
+        *errorMessage = message;
+}
+
+// Écriture dans l'ordre, par un thread dédié, des morceaux déjà mis en
+// forme. push() attend quand trop de données sont en attente: la mise en
+// forme ne prend jamais plus de MaxPendingBytes d'avance sur le disque.
+class ChunkWriter
+{
+public:
+    explicit ChunkWriter(QIODevice &device)
+        : device(device)
+        , worker([this]() { run(); })
+    {
+    }
+
+    ~ChunkWriter() { finish(); }
+
+    // false: une écriture a échoué, la suite est inutile
+    bool push(std::string &&chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        roomAvailable.wait(lock, [this]() { return failed || pendingBytes < ViewExport::MaxPendingBytes; });
+        if (failed)
+            return false;
+        pendingBytes += chunk.size();
+        queue.push_back(std::move(chunk));
+        dataAvailable.notify_one();
+        return true;
+    }
+
+    // Attend l'écriture de tout ce qui a été déposé
+    bool finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        dataAvailable.notify_one();
+        if (worker.joinable())
+            worker.join();
+        return !failed;
+    }
+
+private:
+    QIODevice &device;
+    std::mutex mutex;
+    std::condition_variable dataAvailable;
+    std::condition_variable roomAvailable;
+    std::deque<std::string> queue;
+    size_t pendingBytes = 0;
+    bool closing = false;
+    bool failed = false;
+    std::thread worker;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            dataAvailable.wait(lock, [this]() { return closing || !queue.empty(); });
+            if (queue.empty())
+                return;
+            std::string chunk = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            const bool written = device.write(chunk.data(), qint64(chunk.size())) == qint64(chunk.size());
+            lock.lock();
+            pendingBytes -= chunk.size();
+            if (!written) {
+                failed = true;
+                queue.clear();
+                roomAvailable.notify_all();
+                return;
+            }
+            roomAvailable.notify_all();
+        }
+    }
+};
+
+// Champ texte, entre guillemets seulement s'il contient un caractère spécial
+void appendField(std::string &out, std::string_view value, std::string_view special)
+{
+    if (value.find_first_of(special) == std::string_view::npos) {
+        out.append(value);
+        return;
+    }
+    out += '"';
+    for (char c : value) {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+// Lignes [begin, end) de la vue, une par ligne de texte
+void formatChunk(const ColumnTable &table, const std::vector<uint32_t> *rows, size_t begin, size_t end,
+                 char delimiter, std::string &out)
+{
+    const char specialChars[] = {delimiter, '"', '\n', '\r'};
+    const std::string_view special(specialChars, sizeof(specialChars));
+    out.clear();
+    out.reserve((end - begin) * 64);
+    char number[32];
+    char date[10];
+    for (size_t i = begin; i < end; ++i) {
+        const size_t row = rows ? (*rows)[i] : i;
+        auto result = std::to_chars(number, number + sizeof(number), table.ids[row]);
+        out.append(number, result.ptr);
+        out += delimiter;
+        appendField(out, table.nom(row), special);
+        out += delimiter;
+        appendField(out, table.type(row), special);
+        out += delimiter;
+        formatDate(table.dates[row], date);
+        out.append(date, sizeof(date));
+        out += delimiter;
+        appendField(out, table.statut(row), special);
+        out += delimiter;
+        // Écriture la plus courte qui relit la même valeur
+        result = std::to_chars(number, number + sizeof(number), table.valeurs[row]);
+        out.append(number, result.ptr);
+        out += '\n';
+    }
+}
+
+template <typename T>
+using GatheredBlocks = std::vector<std::shared_ptr<std::vector<T>>>;
+
+template <typename T>
+GatheredBlocks<T> gatherBlocks(const BlockVector<T> &source, const std::vector<uint32_t> &rows)
+{
+    constexpr size_t BlockSize = BlockVector<T>::BlockSize;
+    const size_t blockCount = (rows.size() + BlockSize - 1) / BlockSize;
+    GatheredBlocks<T> blocks(blockCount);
+    parallelFor(blockCount, 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            const size_t begin = b * BlockSize;
+            const size_t length = std::min(BlockSize, rows.size() - begin);
+            auto values = std::make_shared<std::vector<T>>(length);
+            for (size_t i = 0; i < length; ++i)
+                (*values)[i] = source[rows[begin + i]];
+            blocks[b] = std::move(values);
+        }
+    });
+    return blocks;
+}
+
+template <typename T>
+void adoptBlocks(const GatheredBlocks<T> &blocks, BlockVector<T> &target)
+{
+    // Les blocs regroupés sont repris sans nouvelle copie
+    for (const auto &block : blocks)
+        target.adoptBlock(block->data(), block->size(), block);
+}
+
+template <typename T>
+void gatherColumn(const BlockVector<T> &source, const std::vector<uint32_t> &rows, BlockVector<T> &target)
+{
+    adoptBlocks(gatherBlocks(source, rows), target);
+}
+
+// Codes des lignes renumérotés dans un dictionnaire compact, valeurs dans
+// l'ordre de première apparition. Table de correspondance pleine quand la
+// vue est grande devant le dictionnaire, table de hachage sinon.
+template <typename Remap>
+void compactCodes(GatheredBlocks<uint32_t> &blocks, const StringColumn &values, StringColumn &targetValues,
+                  Remap &remap)
+{
+    for (auto &block : blocks) {
+        for (uint32_t &code : *block) {
+            uint32_t &mapped = remap(code);
+            if (mapped == UINT32_MAX) {
+                mapped = uint32_t(targetValues.size());
+                targetValues.append(values[code]);
+            }
+            code = mapped;
+        }
+    }
+}
+
+void gatherCodes(const BlockVector<uint32_t> &source, const StringColumn &values, const std::vector<uint32_t> &rows,
+                 BlockVector<uint32_t> &target, StringColumn &targetValues)
+{
+    GatheredBlocks<uint32_t> blocks = gatherBlocks(source, rows);
+    if (rows.size() * 4 >= values.size()) {
+        std::vector<uint32_t> table(values.size(), UINT32_MAX);
+        auto remap = [&table](uint32_t code) -> uint32_t & { return table[code]; };
+        compactCodes(blocks, values, targetValues, remap);
+    } else {
+        std::unordered_map<uint32_t, uint32_t> table;
+        table.reserve(rows.size());
+        auto remap = [&table](uint32_t code) -> uint32_t & { return table.try_emplace(code, UINT32_MAX).first->second; };
+        compactCodes(blocks, values, targetValues, remap);
+    }
+    adoptBlocks(blocks, target);
+}
+
+} // namespace
+
+bool ViewExport::writeCsv(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                          const QString &fileName, char delimiter, QString *errorMessage,
+                          const Progress &progress)
+{
+    const size_t total = rows ? rows->size() : table.rowCount();
+    PROFILE_SCOPE_AS(scope, "Export CSV");
+    scope.addItems(total);
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+
+    const size_t chunkCount = (total + ChunkRows - 1) / ChunkRows;
+    // Assez de morceaux par fenêtre pour occuper tous les cœurs
+    const size_t window = std::max<size_t>(2, ThreadPool::instance().threadCount() * 2);
+    std::vector<std::string> texts(window);
+    bool ok = true;
+    bool cancelled = false;
+
+    ChunkWriter writer(file);
+    const char header[] = {'I', 'd', delimiter, 'N', 'o', 'm', delimiter, 'T', 'y', 'p', 'e', delimiter,
+                           'D', 'a', 't', 'e', delimiter, 'S', 't', 'a', 't', 'u', 't', delimiter,
+                           'V', 'a', 'l', 'e', 'u', 'r', '\n'};
+    ok = writer.push(std::string(header, sizeof(header)));
+
+    for (size_t first = 0; ok && first < chunkCount; first += window) {
+        const size_t last = std::min(first + window, chunkCount);
+        parallelFor(last - first, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const size_t chunk = first + i;
+                formatChunk(table, rows, chunk * ChunkRows, std::min(total, (chunk + 1) * ChunkRows),
+                            delimiter, texts[i]);
+            }
+        });
+        // Le thread d'écriture vide cette fenêtre pendant la mise en forme de la suivante
+        for (size_t i = 0; ok && i < last - first; ++i)
+            ok = writer.push(std::move(texts[i]));
+        if (ok && progress && !progress(qint64(std::min(total, last * ChunkRows)), qint64(total))) {
+            cancelled = true;
+            ok = false;
+        }
+    }
+
+    ok = writer.finish() && ok;
+    if (!ok || !file.commit()) {
+        setError(errorMessage, cancelled ? QString("Export annulé") : file.errorString());
+        file.cancelWriting();
+        return false;
+    }
+    return true;
+}
+
+bool ViewExport::writeDat(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                          const QString &fileName, DatFile::Compression compression,
+                          QString *errorMessage, const Progress &progress)
+{
+    // Tout le tableau dans son ordre: les colonnes sont écrites telles quelles
+    if (!rows)
+        return DatFile::save(table, fileName, compression, errorMessage, progress);
+    const ColumnTable view = gather(table, *rows);
+    return DatFile::save(view, fileName, compression, errorMessage, progress);
+}
+
+ColumnTable ViewExport::gather(const ColumnTable &table, const std::vector<uint32_t> &rows)
+{
+    PROFILE_SCOPE_AS(scope, "Export: regroupement");
+    scope.addItems(rows.size());
+    ColumnTable result;
+    gatherColumn(table.ids, rows, result.ids);
+    gatherCodes(table.noms, table.nomValues, rows, result.noms, result.nomValues);
+    gatherCodes(table.types, table.typeValues, rows, result.types, result.typeValues);
+    gatherColumn(table.dates, rows, result.dates);
+    gatherCodes(table.statuts, table.statutValues, rows, result.statuts, result.statutValues);
+    gatherColumn(table.valeurs, rows, result.valeurs);
+    return result;
+}
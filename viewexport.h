@@ -0,0 +1,49 @@
+// viewexport.h
+#ifndef VIEWEXPORT_H
+#define VIEWEXPORT_H
+
+#include "columnstore.h"
+#include "datfile.h"
+
+#include <QString>
+
+#include <functional>
+#include <vector>
+
+// Export des lignes affichées par la vue (filtre et ordre de tri compris).
+// rows donne les lignes du tableau dans l'ordre d'affichage; nul, tout le
+// tableau dans son ordre.
+//
+// CSV: les lignes sont mises en forme par morceaux de ChunkRows sur tous les
+// cœurs, directement depuis les colonnes et les dictionnaires, puis écrites
+// dans l'ordre par un seul thread d'écriture. La mise en forme de la fenêtre
+// suivante se fait pendant l'écriture de la précédente; la mémoire en
+// attente d'écriture est bornée.
+//
+// Colonnaire: format .dat (DatFile). Sans restriction, les blocs des colonnes
+// sont écrits tels quels; sinon les colonnes des lignes de la vue sont
+// regroupées en parallèle, les dictionnaires étant partagés sans copie.
+class ViewExport
+{
+public:
+    // Appelé après chaque morceau ou bloc écrit; false annule l'export
+    using Progress = std::function<bool(qint64 done, qint64 total)>;
+
+    static constexpr size_t ChunkRows = 65536;
+    // Texte mis en forme en attente d'écriture, au plus
+    static constexpr size_t MaxPendingBytes = size_t(64) << 20;
+
+    static bool writeCsv(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                         const QString &fileName, char delimiter = ';',
+                         QString *errorMessage = nullptr, const Progress &progress = Progress());
+    static bool writeDat(const ColumnTable &table, const std::vector<uint32_t> *rows,
+                         const QString &fileName, DatFile::Compression compression,
+                         QString *errorMessage = nullptr, const Progress &progress = Progress());
+
+    // Lignes rows de table dans cet ordre. Les dictionnaires ne gardent que
+    // les valeurs utilisées par ces lignes, dans l'ordre de première
+    // apparition: la taille suit la vue, pas le tableau source.
+    static ColumnTable gather(const ColumnTable &table, const std::vector<uint32_t> &rows);
+};
+
+#endif // VIEWEXPORT_H